@@ -7,9 +7,8 @@
 /*
  * Set-associative cache on the io_v2 protocol.
  *
- * Direct port of cache_v3 to the io_v2 IO interface. Functional scope and
- * replacement policy (pseudo-random LFSR) are unchanged; only the IO-side
- * plumbing differs:
+ * Direct port of cache_v3 to the io_v2 IO interface. Functional scope is
+ * unchanged; only the IO-side plumbing differs:
  *
  *   - Single-master slave port; replies via `input_itf.resp(req)` on our own
  *     slave port (no v1 `resp_port` indirection).
@@ -21,14 +20,42 @@
  *     For the async path the wall-clock of `resp()` is the timing signal —
  *     no extra annotation needed.
  *
- * Model-level behaviour otherwise matches cache_v3:
- *   - one refill in flight at a time (set_associative, line-granular)
- *   - CPU requests that miss during a pending refill are queued and replied to
- *     once their miss resolves; they are acknowledged upstream as GRANTED
+ * Model-level behaviour otherwise matches cache_v3, except for misses which
+ * are non-blocking:
+ *   - up to nb_mshrs refills in flight (line-granular), each tracked by an MSHR
+ *     owning its own refill request
+ *   - a miss on a line already being refilled is merged into its MSHR
+ *     (secondary miss) and replied to when the refill lands
+ *   - hits are served while refills are in flight (hit-under-miss)
+ *   - a miss which finds no free MSHR, or no way of its set which is not
+ *     already being refilled, is queued and resumed once a refill completes;
+ *     it is acknowledged upstream as GRANTED, as are the requests arriving
+ *     behind it, to keep the request order
  *   - disable (via the `enable` wire) bypasses the cache: the CPU request is
  *     forwarded verbatim through the refill port (address transformed by
  *     refill_shift / refill_offset first)
  *   - flush, flush-line, flush-ack wires are unchanged
+ *
+ * Lines are identified by their index `set * ways + way`. The tag store is kept
+ * as structure of arrays indexed by line, so that the ways of a set are
+ * contiguous and the hit search is a compare over one short array, and the
+ * data of all lines is a single aligned slab. The per-line tag trace events
+ * (`set_<way>/line_<set>`) are only registered, the first time their line is
+ * refilled, while the cache-level `tags` event is active.
+ *
+ * Replacement: a miss fills an invalid way of its set if there is one, and
+ * otherwise asks the replacement policy for a victim. The policy (random LFSR
+ * as in cache_v3, LRU, tree-PLRU or FIFO) is selected at compile time with
+ * CONFIG_CACHE_REPLACEMENT, added by the generator from the `replacement`
+ * config field, so that the hit path only pays for the selected one.
+ *
+ * Prefetch: an optional engine trained on the miss stream issues line
+ * refills ahead of the demand ones, either for the next N lines
+ * (`next_line`) or along a stride detected between consecutive misses
+ * (`stride`, no PC needed). Prefetches only use MSHRs left free by demand
+ * misses and are dropped when none is available. A first hit on a prefetched
+ * line also trains the engine, so that a stream which only hits prefetched
+ * lines keeps being prefetched.
  */
 
 #include <bit>
@@ -36,8 +63,14 @@
 #include <vp/queue.hpp>
 #include <vp/itf/io_v2.hpp>
 #include <vp/signal.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
 #include <vector>
 #include <cache/cache_v4/cache_config.hpp>
+#include <utils/host_profiler.hpp>
 
 static int ceil_log2(unsigned int n)
 {
@@ -45,14 +78,279 @@ static int ceil_log2(unsigned int n)
     return 32 - __builtin_clz(n - 1);
 }
 
+// Prefetchers, see CacheConfig.prefetcher
+enum CachePrefetcher
+{
+    CACHE_PREFETCH_NONE,
+    CACHE_PREFETCH_NEXT_LINE,
+    CACHE_PREFETCH_STRIDE,
+};
+
+// Replacement policies, see CacheConfig.replacement
+#define CACHE_REPLACEMENT_RANDOM 0
+#define CACHE_REPLACEMENT_LRU    1
+#define CACHE_REPLACEMENT_PLRU   2
+#define CACHE_REPLACEMENT_FIFO   3
+
+#ifndef CONFIG_CACHE_REPLACEMENT
+#define CONFIG_CACHE_REPLACEMENT CACHE_REPLACEMENT_RANDOM
+#endif
+
+// Maximum associativity, so that the ways of a set fit a 64-bit mask
+static constexpr unsigned int CACHE_MAX_WAYS = 64;
+
+// First way from `way` onwards, wrapping around, which is not in `excluded`.
+// At least one way must be allowed.
+static inline unsigned int first_allowed_way(unsigned int way, unsigned int ways,
+    uint64_t excluded)
+{
+    while ((excluded >> way) & 1)
+    {
+        way = way + 1 == ways ? 0 : way + 1;
+    }
+    return way;
+}
+
+// The policies below share the same interface:
+//   - access(set, way): a request hit the way;
+//   - insert(set, way): the way is being refilled;
+//   - victim(set, excluded): way to be replaced, among the ones not in the
+//     `excluded` mask (ways which are already being refilled).
+// Their per-set metadata is kept in flat arrays, a few bytes per set.
+
+// Pseudo-random, 8-bit LFSR stepped on each replacement (matches cache_v3).
+// No per-set state.
+class RandomReplacement
+{
+public:
+    void init(unsigned int nb_sets, unsigned int ways) { this->ways = ways; }
+    inline void access(unsigned int set, unsigned int way) {}
+    inline void insert(unsigned int set, unsigned int way) {}
+
+    unsigned int victim(unsigned int set, uint64_t excluded)
+    {
+        int feedback = !(((this->lfsr >> 7) & 1)
+                      ^ ((this->lfsr >> 3) & 1)
+                      ^ ((this->lfsr >> 2) & 1)
+                      ^ ((this->lfsr >> 1) & 1));
+        this->lfsr = (this->lfsr << 1) | (feedback & 1);
+        unsigned int way = ((this->lfsr >> 1) & (this->ways - 1)) % this->ways;
+        return first_allowed_way(way, this->ways, excluded);
+    }
+
+private:
+    unsigned int ways = 1;
+    uint8_t lfsr = 0;
+};
+
+// True LRU. Each way has a recency rank, 0 being the most recently used one,
+// stored on one byte per way.
+class LruReplacement
+{
+public:
+    void init(unsigned int nb_sets, unsigned int ways)
+    {
+        this->ways = ways;
+        this->ranks.resize(nb_sets * ways);
+        for (unsigned int i = 0; i < nb_sets * ways; i++)
+        {
+            this->ranks[i] = i % ways;
+        }
+    }
+
+    inline void access(unsigned int set, unsigned int way)
+    {
+        uint8_t *ranks = &this->ranks[set * this->ways];
+        uint8_t rank = ranks[way];
+        for (unsigned int i = 0; i < this->ways; i++)
+        {
+            ranks[i] += ranks[i] < rank;
+        }
+        ranks[way] = 0;
+    }
+
+    inline void insert(unsigned int set, unsigned int way) { this->access(set, way); }
+
+    unsigned int victim(unsigned int set, uint64_t excluded)
+    {
+        uint8_t *ranks = &this->ranks[set * this->ways];
+        unsigned int victim = 0;
+        int victim_rank = -1;
+        for (unsigned int i = 0; i < this->ways; i++)
+        {
+            if (!((excluded >> i) & 1) && ranks[i] > victim_rank)
+            {
+                victim = i;
+                victim_rank = ranks[i];
+            }
+        }
+        return victim;
+    }
+
+private:
+    unsigned int ways = 1;
+    std::vector<uint8_t> ranks;
+};
+
+// Tree pseudo-LRU, for a power-of-two number of ways. The ways - 1 nodes of a
+// set are bits of one 64-bit word, in heap order (root is bit 1, the children
+// of node n are 2n and 2n + 1). A node bit gives the subtree to replace next,
+// 0 for the left one.
+class PlruReplacement
+{
+public:
+    void init(unsigned int nb_sets, unsigned int ways)
+    {
+        this->ways = ways;
+        this->levels = ceil_log2(ways);
+        this->trees.assign(nb_sets, 0);
+    }
+
+    inline void access(unsigned int set, unsigned int way)
+    {
+        uint64_t tree = this->trees[set];
+        unsigned int node = 1;
+        for (int level = this->levels - 1; level >= 0; level--)
+        {
+            unsigned int dir = (way >> level) & 1;
+            // Point the node away from the accessed way
+            tree = (tree & ~((uint64_t)1 << node)) | ((uint64_t)!dir << node);
+            node = 2 * node + dir;
+        }
+        this->trees[set] = tree;
+    }
+
+    inline void insert(unsigned int set, unsigned int way) { this->access(set, way); }
+
+    unsigned int victim(unsigned int set, uint64_t excluded)
+    {
+        uint64_t tree = this->trees[set];
+        unsigned int node = 1;
+        for (int level = 0; level < this->levels; level++)
+        {
+            node = 2 * node + ((tree >> node) & 1);
+        }
+        return first_allowed_way(node - this->ways, this->ways, excluded);
+    }
+
+private:
+    unsigned int ways = 1;
+    int levels = 0;
+    std::vector<uint64_t> trees;
+};
+
+// FIFO, i.e. round-robin replacement: one byte per set with the next way
+// to replace.
+class FifoReplacement
+{
+public:
+    void init(unsigned int nb_sets, unsigned int ways)
+    {
+        this->ways = ways;
+        this->next.assign(nb_sets, 0);
+    }
+
+    inline void access(unsigned int set, unsigned int way) {}
+
+    inline void insert(unsigned int set, unsigned int way)
+    {
+        this->next[set] = way + 1 == this->ways ? 0 : way + 1;
+    }
+
+    unsigned int victim(unsigned int set, uint64_t excluded)
+    {
+        return first_allowed_way(this->next[set], this->ways, excluded);
+    }
+
+private:
+    unsigned int ways = 1;
+    std::vector<uint8_t> next;
+};
+
+#if CONFIG_CACHE_REPLACEMENT == CACHE_REPLACEMENT_LRU
+using CacheReplacement = LruReplacement;
+#elif CONFIG_CACHE_REPLACEMENT == CACHE_REPLACEMENT_PLRU
+using CacheReplacement = PlruReplacement;
+#elif CONFIG_CACHE_REPLACEMENT == CACHE_REPLACEMENT_FIFO
+using CacheReplacement = FifoReplacement;
+#else
+using CacheReplacement = RandomReplacement;
+#endif
+
+// Share of the prefetches which were used by a demand access, on time or late
+class StatPrefetchAccuracy : public vp::StatCommon
+{
+public:
+    StatPrefetchAccuracy(vp::StatScalar *issued, vp::StatScalar *useful, vp::StatScalar *late)
+        : issued(issued), useful(useful), late(late) {}
+
+    std::string format_value(bool raw) const override
+    {
+        uint64_t issued = this->issued->get();
+        uint64_t used = this->useful->get() + this->late->get();
+        double pct = issued ? 100.0 * (double)used / (double)issued : 0.0;
+        char buf[32];
+        snprintf(buf, sizeof(buf), raw ? "%.4f" : "%.2f %%", pct);
+        return buf;
+    }
+
+    void reset() override {}
+
+private:
+    vp::StatScalar *issued;
+    vp::StatScalar *useful;
+    vp::StatScalar *late;
+};
+
+// Evictions per set, dumped as "set:count" pairs for the sets which had any,
+// to spot the sets suffering from conflict misses.
+class StatSetEvictions : public vp::StatCommon
+{
+public:
+    void init(unsigned int nb_sets) { this->counts.assign(nb_sets, 0); }
+
+    inline void account(unsigned int set) { this->counts[set]++; }
+
+    std::string format_value(bool raw) const override
+    {
+        std::string result;
+        for (size_t i = 0; i < this->counts.size(); i++)
+        {
+            if (this->counts[i] == 0) continue;
+            if (!result.empty()) result += " ";
+            result += std::to_string(i) + ":" + std::to_string(this->counts[i]);
+        }
+        return result;
+    }
+
+    void reset() override
+    {
+        std::fill(this->counts.begin(), this->counts.end(), 0);
+    }
+
+private:
+    std::vector<uint64_t> counts;
+};
+
+// CPU request waiting for the refill of an MSHR
 typedef struct
 {
+    vp::IoReq *req;
+    unsigned int line_offset;
+} mshr_target_t;
+
+// Miss status holding register: one refill in flight and the CPU requests
+// waiting for it, primary miss first. A prefetch has no request until a demand
+// miss is merged into it.
+typedef struct
+{
+    vp::IoReq req;
+    bool busy;
+    bool prefetch;
+    int line;
     uint32_t tag;
-    bool dirty;
-    uint8_t *data;
-    vp::Trace tag_event;
-    int64_t timestamp;
-} cache_line_t;
+    std::vector<mshr_target_t> targets;
+} mshr_t;
 
 class Cache : public vp::Component
 {
@@ -79,15 +377,27 @@ private:
     static vp::IoRespAck refill_resp(vp::Block *__this, vp::IoReq *req);
     static void refill_retry(vp::Block *__this, vp::IoRetryChannel);
 
-    vp::IoReqStatus handle_req(vp::IoReq *req);
+    vp::IoReqStatus handle_req(vp::IoReq *req, bool resumed);
     void check_state();
 
-    cache_line_t *refill(int line_index, unsigned int addr, unsigned int tag,
-                          vp::IoReq *req, bool *pending);
-    cache_line_t *get_line(vp::IoReq *req, unsigned int *line_index,
-                            unsigned int *tag, unsigned int *line_offset);
+    int refill(mshr_t *mshr, int line, unsigned int addr, unsigned int tag,
+               vp::IoReq *req, unsigned int line_offset, bool *pending);
+    mshr_t *mshr_get(vp::IoReq *req);
+    mshr_t *mshr_lookup(uint32_t tag);
+    mshr_t *mshr_alloc();
+    int get_victim(unsigned int line_index);
+    int get_line(vp::IoReq *req, unsigned int *line_index,
+                 unsigned int *tag, unsigned int *line_offset);
+    int find_line(unsigned int line_index, uint32_t tag);
+    void prefetch(uint32_t tag);
+    void trace_line_refill(int line, uint32_t addr);
+    void fill_line(int line);
+
+    inline uint8_t *line_data(int line)
+    {
+        return &this->data_slab[(size_t)line << this->line_size_bits];
+    }
 
-    unsigned int step_lru();
     void enable(bool e);
     void flush();
     void flush_line_op(unsigned int addr);
@@ -100,7 +410,9 @@ private:
     bool enabled = false;
 
     vp::Trace trace;
+    host_profiler::Counter *host_prof;
     vp::Trace io_event;
+    vp::Trace tags_event;
 
     // io_v2 ports — method pointers are passed at construction.
     vp::IoSlave  input_itf{&Cache::input_req};
@@ -113,15 +425,14 @@ private:
     vp::WireSlave<bool>     flush_line_itf;
     vp::WireSlave<uint32_t> flush_line_addr_itf;
 
-    // Internal refill vehicle (cache owns exactly one — only one refill in flight).
-    vp::IoReq refill_req;
+    // MSHRs, each one owning the refill request of its line.
+    mshr_t *mshrs = nullptr;
+    int nb_busy_mshrs = 0;
 
     // FIFO of CPU requests that were acknowledged upstream (GRANTED) but not yet
-    // served. Two sources feed it:
-    //  - reqs arriving while a refill is already in flight (they re-enter via
-    //    fsm_handler once the refill resolves);
-    //  - the CPU req whose miss triggered the current refill (placed at the head
-    //    so the refill_resp path can pop it and reply to the master).
+    // handled, because they missed while no MSHR or no way of their set was
+    // available, or because they arrived behind such a request. They re-enter
+    // via fsm_handler once a refill completes.
     vp::Queue refill_pending_reqs;
 
     // GUI / VCD signals (match cache_v3)
@@ -137,19 +448,45 @@ private:
     // hits/misses so the CPU sees the serialised latency.
     int64_t refill_timestamp = -1;
 
-    // Pseudo-random LFSR state for replacement policy
-    uint8_t lru_out = 0;
+    CacheReplacement replacement;
 
     // Flush-line wire staging (address arrives via a separate wire)
     uint32_t flush_line_addr = 0;
 
-    // Lines storage (nb_sets * nb_ways * cache_line_t).
-    cache_line_t *lines = nullptr;
-
-    // Refill state (only meaningful when pending_refill is set).
-    cache_line_t *refill_line = nullptr;
-    uint32_t      refill_tag = 0;
-    unsigned int  pending_line_offset = 0;
+    // Tag store, one entry per line. `valid` and `dirty` are bytes rather than
+    // bits so that a set is compared with plain loads.
+    std::vector<uint32_t> tags;
+    std::vector<uint8_t>  valid;
+    std::vector<uint8_t>  dirty;
+    // Cycle at which the data of a synchronously refilled line is available.
+    std::vector<int64_t>  timestamps;
+    // Line data, line after line (nb_sets * ways * line_size bytes).
+    uint8_t *data_slab = nullptr;
+    // Per-line tag trace events, registered on first use (see trace_line_refill).
+    std::vector<vp::Trace *> line_events;
+
+    vp::StatScalar stat_evictions;
+    StatSetEvictions stat_set_evictions;
+
+    // Prefetch engine
+    CachePrefetcher prefetcher = CACHE_PREFETCH_NONE;
+    // Set on lines filled by a prefetch until their first demand hit
+    std::vector<uint8_t> prefetched;
+    // Stride detector state: last line of the miss stream, last stride seen
+    // and whether it was seen twice in a row.
+    int64_t stride_last_tag = -1;
+    int64_t stride = 0;
+    bool stride_confirmed = false;
+
+    vp::StatScalar stat_prefetches;
+    vp::StatScalar stat_prefetch_useful;
+    vp::StatScalar stat_prefetch_late;
+    StatPrefetchAccuracy stat_prefetch_accuracy{&stat_prefetches, &stat_prefetch_useful,
+        &stat_prefetch_late};
+
+    // Set when the request at the head of refill_pending_reqs could not get an
+    // MSHR or a victim way. Draining stops until a refill completes.
+    bool mshr_stalled = false;
 
     // Set if a refill was denied by the downstream and must be retried on the
     // next retry() signal. Used only while a queued request is being drained —
@@ -175,7 +512,9 @@ Cache::Cache(vp::ComponentConf &config)
     this->nb_sets_bits = ceil_log2(this->nb_sets);
 
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->host_prof = host_profiler::counter(this->get_path(), "cache_v4");
     this->traces.new_trace_event("port", &this->io_event, 32);
+    this->traces.new_trace_event("tags", &this->tags_event, 32);
 
     // io_v2 slave/master ports (methods bound in-class above).
     this->new_slave_port("input", &this->input_itf);
@@ -196,26 +535,71 @@ Cache::Cache(vp::ComponentConf &config)
 
     this->new_master_port("flush_ack", &this->flush_ack_itf);
 
-    this->lines = new cache_line_t[this->nb_sets * this->cfg.ways];
-    for (unsigned int i = 0; i < this->nb_sets; i++)
+    unsigned int nb_lines = this->nb_sets * this->cfg.ways;
+    this->tags.assign(nb_lines, 0);
+    this->valid.assign(nb_lines, 0);
+    this->dirty.assign(nb_lines, 0);
+    this->timestamps.assign(nb_lines, -1);
+    this->line_events.assign(nb_lines, nullptr);
+
+    if (this->cfg.ways > CACHE_MAX_WAYS)
     {
-        for (unsigned int j = 0; j < this->cfg.ways; j++)
-        {
-            cache_line_t *line = &this->lines[i * this->cfg.ways + j];
-            line->timestamp = -1;
-            line->tag = -1;
-            line->data = new uint8_t[this->cfg.line_size];
-            this->traces.new_trace_event(
-                "set_" + std::to_string(j) + "/line_" + std::to_string(i),
-                &line->tag_event, 32);
-        }
+        this->trace.fatal("Cache supports at most %d ways (got %d)\n",
+            CACHE_MAX_WAYS, this->cfg.ways);
+    }
+    this->replacement.init(this->nb_sets, this->cfg.ways);
+
+    this->stats.register_stat(&this->stat_evictions, "evictions",
+        "Valid lines replaced by a refill");
+    this->stat_set_evictions.init(this->nb_sets);
+    this->stats.register_stat(&this->stat_set_evictions, "set_evictions",
+        "Evictions per set, as set:count pairs");
+
+    const char *prefetcher = this->cfg.prefetcher != nullptr ? this->cfg.prefetcher : "";
+    if (strcmp(prefetcher, "next_line") == 0)
+    {
+        this->prefetcher = CACHE_PREFETCH_NEXT_LINE;
+    }
+    else if (strcmp(prefetcher, "stride") == 0)
+    {
+        this->prefetcher = CACHE_PREFETCH_STRIDE;
+    }
+
+    if (this->prefetcher != CACHE_PREFETCH_NONE)
+    {
+        this->prefetched.assign(nb_lines, 0);
+        this->stats.register_stat(&this->stat_prefetches, "prefetches",
+            "Prefetch refills issued");
+        this->stats.register_stat(&this->stat_prefetch_useful, "prefetch_useful",
+            "Prefetched lines hit by a demand access");
+        this->stats.register_stat(&this->stat_prefetch_late, "prefetch_late",
+            "Demand misses merged into an in-flight prefetch");
+        this->stats.register_stat(&this->stat_prefetch_accuracy, "prefetch_accuracy",
+            "Share of the prefetches used by a demand access, on time or late");
+    }
+
+    // aligned_alloc wants a size multiple of the alignment.
+    size_t data_size = ((size_t)nb_lines << this->line_size_bits);
+    this->data_slab = (uint8_t *)std::aligned_alloc(64, (data_size + 63) & ~(size_t)63);
+    if (this->data_slab == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    this->mshrs = new mshr_t[this->cfg.nb_mshrs];
+    for (int i = 0; i < this->cfg.nb_mshrs; i++)
+    {
+        this->mshrs[i].busy = false;
+        this->mshrs[i].prefetch = false;
+        this->mshrs[i].line = -1;
+        this->mshrs[i].tag = 0;
     }
 
     this->fsm_event = this->event_new(&Cache::fsm_handler);
 
     this->trace.msg(vp::Trace::LEVEL_INFO,
-        "Instantiating cache (sets: %d, ways: %d, line_size: %d)\n",
-        this->nb_sets, this->cfg.ways, this->cfg.line_size);
+        "Instantiating cache (sets: %d, ways: %d, line_size: %d, mshrs: %d)\n",
+        this->nb_sets, this->cfg.ways, this->cfg.line_size, this->cfg.nb_mshrs);
 }
 
 
@@ -228,7 +612,11 @@ void Cache::reset(bool active)
         this->refill_event.release();
         this->refill_retry_pending = false;
         this->input_needs_retry = false;
+        this->mshr_stalled = false;
         this->refill_timestamp = -1;
+        this->stride_last_tag = -1;
+        this->stride = 0;
+        this->stride_confirmed = false;
     }
 }
 
@@ -240,11 +628,14 @@ void Cache::reset(bool active)
 vp::IoRespAck Cache::refill_resp(vp::Block *__this, vp::IoReq *req)
 {
     Cache *_this = (Cache *)__this;
+    host_profiler::Scope prof(_this->host_prof);
 
     // Bypass path: the cache is disabled and we simply pass upstream requests
-    // through. The request we receive here is the CPU's own request (not our
-    // refill_req), so we forward the response to the CPU on our own slave port.
-    if (req != &_this->refill_req)
+    // through. The request we receive here is the CPU's own request (not one of
+    // the MSHR refill requests), so we forward the response to the CPU on our
+    // own slave port.
+    mshr_t *mshr = _this->mshr_get(req);
+    if (mshr == nullptr)
     {
         _this->input_itf.resp(req);
         return vp::IO_RESP_ACCEPTED;
@@ -261,39 +652,59 @@ vp::IoRespAck Cache::refill_resp(vp::Block *__this, vp::IoReq *req)
         return vp::IO_RESP_ACCEPTED;
     }
 
-    // Cached-refill path. The CPU request whose miss triggered this refill is at
-    // the head of refill_pending_reqs (placed there by Cache::refill()).
-    vp_assert(!_this->refill_pending_reqs.empty(), &_this->trace,
+    vp_assert(mshr->prefetch || !mshr->targets.empty(), &_this->trace,
         "Received refill response with no pending CPU request\n");
 
-    vp::IoReq *cpu_req = (vp::IoReq *)_this->refill_pending_reqs.pop();
-    uint8_t *data = cpu_req->get_data();
-    uint64_t size = cpu_req->get_size();
-    bool is_write = cpu_req->get_is_write();
-
     _this->trace.msg(vp::Trace::LEVEL_TRACE,
-        "Received refill response (cpu_req: %p, is_write: %d, data: %p, size: 0x%lx)\n",
-        cpu_req, is_write, data, size);
+        "Received refill response (addr: 0x%lx, nb_reqs: %d)\n",
+        req->get_addr(), (int)mshr->targets.size());
+
+    // Validate the line first: a master replied to below may send its next
+    // request from within resp(), and must then see the line as a hit.
+    int line = mshr->line;
+    uint8_t *line_data = _this->line_data(line);
+    _this->tags[line] = mshr->tag;
+    _this->valid[line] = 1;
+    if (_this->prefetcher != CACHE_PREFETCH_NONE)
+    {
+        _this->prefetched[line] = mshr->prefetch;
+    }
 
-    _this->pending_refill.set(0);
-    _this->refill_event.release();
+    if (--_this->nb_busy_mshrs == 0)
+    {
+        _this->pending_refill.set(0);
+        _this->refill_event.release();
+    }
 
-    if (data)
+    // Serve the merged requests in arrival order, so that a read behind a
+    // write to the same line sees the written data.
+    for (mshr_target_t &target : mshr->targets)
     {
-        cache_line_t *line = _this->refill_line;
-        line->tag = _this->refill_tag;
+        vp::IoReq *cpu_req = target.req;
+        uint8_t *data = cpu_req->get_data();
+        uint64_t size = cpu_req->get_size();
 
-        if (!is_write)
-        {
-            memcpy(data, &line->data[_this->pending_line_offset], size);
-        }
-        else
+        if (data)
         {
-            memcpy(&line->data[_this->pending_line_offset], data, size);
+            if (!cpu_req->get_is_write())
+            {
+                memcpy(data, &line_data[target.line_offset], size);
+            }
+            else
+            {
+                memcpy(&line_data[target.line_offset], data, size);
+                _this->dirty[line] = 1;
+            }
         }
+
+        _this->input_itf.resp(cpu_req);
     }
 
-    _this->input_itf.resp(cpu_req);
+    mshr->targets.clear();
+    mshr->busy = false;
+
+    // A freed MSHR and a refilled set may unblock the queued requests.
+    _this->mshr_stalled = false;
     _this->check_state();
 
     return vp::IO_RESP_ACCEPTED;
@@ -303,6 +714,7 @@ vp::IoRespAck Cache::refill_resp(vp::Block *__this, vp::IoReq *req)
 void Cache::refill_retry(vp::Block *__this, vp::IoRetryChannel)
 {
     Cache *_this = (Cache *)__this;
+    host_profiler::Scope prof(_this->host_prof);
 
     // The downstream is now ready. Two independent things may be waiting on this:
     //
@@ -332,13 +744,14 @@ void Cache::refill_retry(vp::Block *__this, vp::IoRetryChannel)
 // ---------------------------------------------------------------------------
 
 // Kicked by check_state() whenever there is at least one queued CPU request and
-// no refill currently in flight. Pulls one request from the queue, runs it
-// through handle_req, and replies to the CPU if it resolves synchronously.
+// nothing blocks it. Pulls one request from the queue, runs it through
+// handle_req, and replies to the CPU if it resolves synchronously.
 void Cache::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
 {
     Cache *_this = (Cache *)__this;
+    host_profiler::Scope prof(_this->host_prof);
 
-    if (!_this->pending_refill.get() && !_this->refill_retry_pending
+    if (!_this->mshr_stalled && !_this->refill_retry_pending
         && !_this->refill_pending_reqs.empty())
     {
         vp::IoReq *req = (vp::IoReq *)_this->refill_pending_reqs.pop();
@@ -347,7 +760,7 @@ void Cache::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
             "Resuming req (req: %p, is_write: %d, offset: 0x%lx, size: 0x%lx)\n",
             req, req->get_is_write(), req->get_addr(), req->get_size());
 
-        vp::IoReqStatus st = _this->handle_req(req);
+        vp::IoReqStatus st = _this->handle_req(req, true);
         if (st == vp::IO_REQ_DONE)
         {
             _this->input_itf.resp(req);
@@ -358,8 +771,8 @@ void Cache::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
             // once refill_retry() clears refill_retry_pending.
             _this->refill_pending_reqs.push_front(req);
         }
-        // If GRANTED, Cache::refill() has already pushed cpu_req back at the
-        // head of refill_pending_reqs — refill_resp will pop and reply.
+        // If GRANTED, the request is now held by an MSHR, which replies from
+        // refill_resp, or is back at the head of the queue if it is stalled.
     }
 
     _this->check_state();
@@ -375,7 +788,7 @@ void Cache::check_state()
     // re-checks next cycle -> the queued request is lost and the master hangs. The
     // fsm runs at +1, by which point the element is ready, so scheduling on
     // presence is correct.
-    if (!this->pending_refill.get() && !this->refill_retry_pending
+    if (!this->mshr_stalled && !this->refill_retry_pending
         && this->refill_pending_reqs.has_reqs())
     {
         if (!this->fsm_event->is_enqueued())
@@ -390,35 +803,154 @@ void Cache::check_state()
 // Core cache logic (mirrors cache_v3, minus debug/atomics)
 // ---------------------------------------------------------------------------
 
-cache_line_t *Cache::refill(int line_index, unsigned int addr, unsigned int tag,
-                              vp::IoReq *cpu_req, bool *pending)
+mshr_t *Cache::mshr_get(vp::IoReq *req)
 {
-    // Cache supports only one refill at a time. Queue the CPU req and back off.
-    if (this->pending_refill.get())
+    for (int i = 0; i < this->cfg.nb_mshrs; i++)
+    {
+        if (req == &this->mshrs[i].req)
+        {
+            return &this->mshrs[i];
+        }
+    }
+    return nullptr;
+}
+
+
+mshr_t *Cache::mshr_lookup(uint32_t tag)
+{
+    for (int i = 0; i < this->cfg.nb_mshrs; i++)
+    {
+        mshr_t *mshr = &this->mshrs[i];
+        if (mshr->busy && mshr->tag == tag)
+        {
+            return mshr;
+        }
+    }
+    return nullptr;
+}
+
+
+mshr_t *Cache::mshr_alloc()
+{
+    if (this->nb_busy_mshrs == this->cfg.nb_mshrs)
     {
-        this->refill_pending_reqs.push_back(cpu_req);
-        *pending = true;
         return nullptr;
     }
 
-    unsigned int refill_way = this->step_lru() % this->cfg.ways;
-    cache_line_t *line = &this->lines[line_index * this->cfg.ways + refill_way];
+    for (int i = 0; i < this->cfg.nb_mshrs; i++)
+    {
+        if (!this->mshrs[i].busy)
+        {
+            return &this->mshrs[i];
+        }
+    }
+    return nullptr;
+}
+
 
+// Pick the way of the set to be replaced: an invalid way if any, otherwise the
+// one chosen by the replacement policy. Ways already being refilled by an MSHR
+// are never picked, so that two refills never land in the same line. Returns -1
+// if every way is being refilled.
+int Cache::get_victim(unsigned int line_index)
+{
+    unsigned int ways = this->cfg.ways;
+    unsigned int first = line_index * ways;
+
+    uint64_t excluded = 0;
+    if (this->nb_busy_mshrs)
+    {
+        for (int i = 0; i < this->cfg.nb_mshrs; i++)
+        {
+            mshr_t *mshr = &this->mshrs[i];
+            if (mshr->busy && (unsigned int)mshr->line - first < ways)
+            {
+                excluded |= (uint64_t)1 << (mshr->line - first);
+            }
+        }
+
+        uint64_t all = ways == 64 ? ~(uint64_t)0 : ((uint64_t)1 << ways) - 1;
+        if (excluded == all)
+        {
+            return -1;
+        }
+    }
+
+    for (unsigned int way = 0; way < ways; way++)
+    {
+        if (!this->valid[first + way] && !((excluded >> way) & 1))
+        {
+            return first + way;
+        }
+    }
+
+    return first + this->replacement.victim(line_index, excluded);
+}
+
+
+// Book-keeping of a refill accepted by the downstream
+void Cache::fill_line(int line)
+{
+    unsigned int set = line / this->cfg.ways;
+
+    if (this->valid[line])
+    {
+        this->stat_evictions++;
+        this->stat_set_evictions.account(set);
+    }
+
+    this->replacement.insert(set, line - set * this->cfg.ways);
+}
+
+
+// Emit the refill address on the tag event of the line. The per-line events are
+// only wanted for waveforms, and registering one trace per line is what made the
+// construction of large caches slow, so a line registers its event the first
+// time it is refilled while the cache-level `tags` event is enabled.
+void Cache::trace_line_refill(int line, uint32_t addr)
+{
+    if (!this->tags_event.get_event_active())
+    {
+        return;
+    }
+
+    this->tags_event.event((uint8_t *)&addr);
+
+    vp::Trace *event = this->line_events[line];
+    if (event == nullptr)
+    {
+        unsigned int set = line / this->cfg.ways;
+        unsigned int way = line % this->cfg.ways;
+        event = new vp::Trace;
+        this->traces.new_trace_event(
+            "set_" + std::to_string(way) + "/line_" + std::to_string(set), event, 32);
+        // Let the engine enable the new event if it matches the trace paths
+        this->traces.get_trace_engine()->check_traces();
+        this->line_events[line] = event;
+    }
+
+    event->event((uint8_t *)&addr);
+}
+
+
+int Cache::refill(mshr_t *mshr, int line, unsigned int addr, unsigned int tag,
+                  vp::IoReq *cpu_req, unsigned int line_offset, bool *pending)
+{
     uint32_t full_addr = ((addr & ~((1U << this->line_size_bits) - 1))
                           << this->cfg.refill_shift) + this->cfg.refill_offset;
 
     this->trace.msg(vp::Trace::LEVEL_DEBUG,
-        "Refilling line (addr: 0x%x, index: %d, way: %d)\n",
-        full_addr, line_index, refill_way);
+        "Refilling line (addr: 0x%x, mshr: %d, way: %d)\n",
+        full_addr, (int)(mshr - this->mshrs), line % this->cfg.ways);
 
-    line->tag_event.event((uint8_t *)&full_addr);
+    this->trace_line_refill(line, full_addr);
 
-    vp::IoReq *r = &this->refill_req;
+    vp::IoReq *r = &mshr->req;
     r->prepare();
     // A refill is a single whole-line burst. Reset the burst flags explicitly:
     // prepare() does not touch them, and a beat-streaming downstream (KIND_BEAT
-    // router / IoV2BeatAdapter) leaves is_first=0/is_last=1 on the shared
-    // refill_req after the previous response's last beat. Reusing it without a
+    // router / IoV2BeatAdapter) leaves is_first=0/is_last=1 on the MSHR
+    // request after the previous response's last beat. Reusing it without a
     // reset would send the next refill as a stray continuation beat.
     r->is_first = true;
     r->is_last = true;
@@ -426,37 +958,64 @@ cache_line_t *Cache::refill(int line_index, unsigned int addr, unsigned int tag,
     r->set_addr(full_addr);
     r->set_is_write(false);
     r->set_size(1U << this->line_size_bits);
-    r->set_data(line->data);
+    r->set_data(this->line_data(line));
 
     this->refill_event_clear_event.cancel();
 
+    // Reserve the MSHR before sending, so that refill_resp recognises its
+    // request whenever the response comes.
+    mshr->busy = true;
+    mshr->prefetch = cpu_req == nullptr;
+    mshr->line = line;
+    mshr->tag = tag;
+    this->nb_busy_mshrs++;
+
     vp::IoReqStatus st = this->refill_itf.req(r);
 
+    if (st != vp::IO_REQ_DENIED)
+    {
+        this->fill_line(line);
+    }
+
     if (st == vp::IO_REQ_GRANTED)
     {
-        // The refill will be completed asynchronously. Park the CPU request at the
-        // head of the queue so refill_resp can pop it and reply to the master.
-        this->refill_pending_reqs.push_front(cpu_req);
-        this->refill_line = line;
-        this->refill_tag = tag;
+        // The refill will be completed asynchronously. The MSHR keeps the CPU
+        // request so refill_resp can reply to the master. The line is being
+        // overwritten, so it must not hit on its previous tag anymore.
+        this->valid[line] = 0;
+        this->dirty[line] = 0;
+        if (cpu_req)
+        {
+            mshr->targets.push_back({cpu_req, line_offset});
+        }
         this->pending_refill.set(1);
         *pending = true;
-        return nullptr;
+        return -1;
     }
 
+    mshr->busy = false;
+    this->nb_busy_mshrs--;
+
     if (st == vp::IO_REQ_DENIED)
     {
         // The refill was refused. Caller decides whether to propagate DENIED
         // upstream (new inline req) or to keep the CPU req queued (drain path).
-        this->refill_retry_pending = true;
+        // A refused prefetch is just dropped.
+        this->refill_retry_pending = cpu_req != nullptr;
         *pending = false;
-        return nullptr;
+        return -1;
     }
 
     // Synchronous success. Tag the line, account for serialisation with any
     // previously-started synchronous refill, and annotate the CPU request's
     // latency so the master paces itself correctly.
-    line->tag = tag;
+    this->tags[line] = tag;
+    this->valid[line] = 1;
+    this->dirty[line] = 0;
+    if (this->prefetcher != CACHE_PREFETCH_NONE)
+    {
+        this->prefetched[line] = cpu_req == nullptr;
+    }
 
     int64_t now = this->clock.get_cycles();
     int64_t latency = 0;
@@ -471,9 +1030,12 @@ cache_line_t *Cache::refill(int line_index, unsigned int addr, unsigned int tag,
     this->refill_timestamp = now + latency;
     this->refill_event_clear_event.enqueue(latency);
 
-    cpu_req->inc_latency(latency);
+    if (cpu_req)
+    {
+        cpu_req->inc_latency(latency);
+    }
 
-    line->timestamp = now + latency;
+    this->timestamps[line] = now + latency;
 
     return line;
 }
@@ -484,11 +1046,13 @@ void Cache::flush_line_op(unsigned int addr)
     this->trace.msg(vp::Trace::LEVEL_INFO, "Flushing cache line (addr: 0x%x)\n", addr);
     unsigned int tag = addr >> this->line_size_bits;
     unsigned int line_index = tag & (this->nb_sets - 1);
-    for (unsigned int i = 0; i < this->cfg.ways; i++)
+    for (unsigned int i = line_index * this->cfg.ways; i < (line_index + 1) * this->cfg.ways; i++)
     {
-        cache_line_t *line = &this->lines[line_index * this->cfg.ways + i];
-        if (line->tag == tag)
-            line->tag = -1;
+        if (this->valid[i] && this->tags[i] == tag)
+        {
+            this->valid[i] = 0;
+            this->dirty[i] = 0;
+        }
     }
 }
 
@@ -496,13 +1060,8 @@ void Cache::flush_line_op(unsigned int addr)
 void Cache::flush()
 {
     this->trace.msg(vp::Trace::LEVEL_INFO, "Flushing whole cache\n");
-    for (unsigned int i = 0; i < this->nb_sets; i++)
-    {
-        for (unsigned int j = 0; j < this->cfg.ways; j++)
-        {
-            this->lines[i * this->cfg.ways + j].tag = -1;
-        }
-    }
+    std::fill(this->valid.begin(), this->valid.end(), 0);
+    std::fill(this->dirty.begin(), this->dirty.end(), 0);
 
     if (this->flush_ack_itf.is_bound())
     {
@@ -519,8 +1078,8 @@ void Cache::enable(bool e)
 }
 
 
-cache_line_t *Cache::get_line(vp::IoReq *req, unsigned int *line_index,
-                                unsigned int *tag, unsigned int *line_offset)
+int Cache::get_line(vp::IoReq *req, unsigned int *line_index,
+                    unsigned int *tag, unsigned int *line_offset)
 {
     uint64_t offset = req->get_addr();
     uint64_t size = req->get_size();
@@ -537,21 +1096,101 @@ cache_line_t *Cache::get_line(vp::IoReq *req, unsigned int *line_index,
         "index: %d, line_offset: 0x%x)\n",
         is_write, offset, size, *tag, *line_index, *line_offset);
 
-    cache_line_t *line = &this->lines[*line_index * this->cfg.ways];
+    return this->find_line(*line_index, *tag);
+}
+
+
+int Cache::find_line(unsigned int line_index, uint32_t tag)
+{
+    unsigned int first = line_index * this->cfg.ways;
+    const uint32_t *set_tags = &this->tags[first];
+    const uint8_t *set_valid = &this->valid[first];
     for (unsigned int i = 0; i < this->cfg.ways; i++)
     {
-        if (line->tag == *tag)
+        if (set_tags[i] == tag && set_valid[i])
         {
             this->trace.msg(vp::Trace::LEVEL_TRACE, "Cache hit (way: %d)\n", i);
-            return line;
+            return first + i;
         }
-        line++;
     }
-    return nullptr;
+    return -1;
 }
 
 
-vp::IoReqStatus Cache::handle_req(vp::IoReq *req)
+// Train the prefetch engine with an access of the miss stream to line `tag`
+// and issue the resulting prefetches.
+void Cache::prefetch(uint32_t tag)
+{
+    int64_t stride = 1;
+
+    if (this->prefetcher == CACHE_PREFETCH_STRIDE)
+    {
+        int64_t new_stride = this->stride_last_tag == -1 ? 0 : (int64_t)tag - this->stride_last_tag;
+        this->stride_confirmed = new_stride != 0 && new_stride == this->stride;
+        this->stride = new_stride;
+        this->stride_last_tag = tag;
+        if (!this->stride_confirmed)
+        {
+            return;
+        }
+        stride = this->stride;
+    }
+
+    // Demand misses waiting for an MSHR go first
+    if (this->refill_retry_pending || this->refill_pending_reqs.has_reqs())
+    {
+        return;
+    }
+
+    int64_t nb_tags = (int64_t)1 << (32 - this->line_size_bits);
+    for (int i = 1; i <= this->cfg.prefetch_degree; i++)
+    {
+        int64_t target = (int64_t)tag + stride * i;
+        if (target < 0 || target >= nb_tags)
+        {
+            break;
+        }
+
+        uint32_t prefetch_tag = target;
+        unsigned int line_index = prefetch_tag & (this->nb_sets - 1);
+        if (this->find_line(line_index, prefetch_tag) != -1
+            || this->mshr_lookup(prefetch_tag) != nullptr)
+        {
+            continue;
+        }
+
+        mshr_t *mshr = this->mshr_alloc();
+        if (mshr == nullptr)
+        {
+            break;
+        }
+
+        int victim = this->get_victim(line_index);
+        if (victim == -1)
+        {
+            continue;
+        }
+
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Prefetching line (addr: 0x%x)\n",
+            prefetch_tag << this->line_size_bits);
+
+        bool pending = false;
+        int line = this->refill(mshr, victim, prefetch_tag << this->line_size_bits,
+            prefetch_tag, nullptr, 0, &pending);
+        if (line == -1 && !pending)
+        {
+            // Denied by the downstream, try again on a later miss
+            break;
+        }
+
+        this->stat_prefetches++;
+    }
+}
+
+
+// `resumed` is true when the request comes from refill_pending_reqs, in which
+// case it goes back to the head of the queue if it has to wait again.
+vp::IoReqStatus Cache::handle_req(vp::IoReq *req, bool resumed)
 {
     unsigned int line_index;
     unsigned int tag;
@@ -560,20 +1199,64 @@ vp::IoReqStatus Cache::handle_req(vp::IoReq *req)
     uint8_t *data = req->get_data();
     bool is_write = req->get_is_write();
 
-    cache_line_t *hit_line = this->get_line(req, &line_index, &tag, &line_offset);
+    int line = this->get_line(req, &line_index, &tag, &line_offset);
+    // Whether this access belongs to the stream the prefetch engine learns from
+    bool train_prefetch = line == -1;
 
-    if (hit_line == nullptr)
+    if (line == -1)
     {
         this->trace.msg(vp::Trace::LEVEL_DEBUG, "Cache miss\n");
         uint64_t offset = req->get_addr();
         this->refill_event.set(offset);
+
+        // Secondary miss: the line is already being refilled, wait for it.
+        mshr_t *mshr = this->mshr_lookup(tag);
+        if (mshr != nullptr)
+        {
+            this->trace.msg(vp::Trace::LEVEL_DEBUG, "Merging miss into MSHR %d\n",
+                (int)(mshr - this->mshrs));
+            mshr->targets.push_back({req, line_offset});
+            if (mshr->prefetch)
+            {
+                // The prefetch was right but not early enough
+                mshr->prefetch = false;
+                this->stat_prefetch_late++;
+            }
+            if (this->prefetcher != CACHE_PREFETCH_NONE)
+            {
+                this->prefetch(tag);
+            }
+            return vp::IO_REQ_GRANTED;
+        }
+
+        mshr = this->mshr_alloc();
+        int victim = mshr ? this->get_victim(line_index) : -1;
+        if (victim == -1)
+        {
+            // Structural stall, the request is resumed once a refill completes.
+            this->trace.msg(vp::Trace::LEVEL_DEBUG, "No MSHR or way available, stalling\n");
+            this->mshr_stalled = true;
+            if (resumed)
+            {
+                this->refill_pending_reqs.push_front(req);
+            }
+            else
+            {
+                this->refill_pending_reqs.push_back(req);
+            }
+            return vp::IO_REQ_GRANTED;
+        }
+
         bool pending = false;
-        hit_line = this->refill(line_index, offset, tag, req, &pending);
-        if (hit_line == nullptr)
+        line = this->refill(mshr, victim, offset, tag, req, line_offset, &pending);
+        if (line == -1)
         {
             if (pending)
             {
-                this->pending_line_offset = line_offset;
+                if (this->prefetcher != CACHE_PREFETCH_NONE)
+                {
+                    this->prefetch(tag);
+                }
                 return vp::IO_REQ_GRANTED;
             }
             // Refill denied OR true error. The caller (input_req / fsm_handler)
@@ -587,9 +1270,18 @@ vp::IoReqStatus Cache::handle_req(vp::IoReq *req)
         // earlier miss in this cycle), defer the timing of this access until the
         // refill would have landed.
         int64_t now = this->clock.get_cycles();
-        if (now < hit_line->timestamp)
+        if (now < this->timestamps[line])
         {
-            req->inc_latency(hit_line->timestamp - now);
+            req->inc_latency(this->timestamps[line] - now);
+        }
+
+        this->replacement.access(line_index, line - line_index * this->cfg.ways);
+
+        if (this->prefetcher != CACHE_PREFETCH_NONE && this->prefetched[line])
+        {
+            this->prefetched[line] = 0;
+            this->stat_prefetch_useful++;
+            train_prefetch = true;
         }
     }
 
@@ -597,14 +1289,21 @@ vp::IoReqStatus Cache::handle_req(vp::IoReq *req)
     {
         if (!is_write)
         {
-            memcpy(data, &hit_line->data[line_offset], size);
+            memcpy(data, &this->line_data(line)[line_offset], size);
         }
         else
         {
-            memcpy(&hit_line->data[line_offset], data, size);
+            memcpy(&this->line_data(line)[line_offset], data, size);
+            this->dirty[line] = 1;
         }
     }
 
+    // Prefetch once the data is copied, a synchronous prefetch may evict the line
+    if (train_prefetch && this->prefetcher != CACHE_PREFETCH_NONE)
+    {
+        this->prefetch(tag);
+    }
+
     return vp::IO_REQ_DONE;
 }
 
@@ -612,6 +1311,7 @@ vp::IoReqStatus Cache::handle_req(vp::IoReq *req)
 vp::IoReqStatus Cache::input_req(vp::Block *__this, vp::IoReq *req)
 {
     Cache *_this = (Cache *)__this;
+    host_profiler::Scope prof(_this->host_prof);
 
     uint64_t offset = req->get_addr();
     uint64_t size = req->get_size();
@@ -625,8 +1325,8 @@ vp::IoReqStatus Cache::input_req(vp::Block *__this, vp::IoReq *req)
 
     // Bypass: forward the CPU request verbatim through the refill port after
     // address transformation. The response comes back on our refill_resp
-    // callback, which recognises a non-&refill_req req as a bypass forward
-    // and replies to the master on our own slave port.
+    // callback, which recognises a request not owned by an MSHR as a bypass
+    // forward and replies to the master on our own slave port.
     if (!_this->enabled)
     {
         req->set_addr((offset << _this->cfg.refill_shift) + _this->cfg.refill_offset);
@@ -642,17 +1342,18 @@ vp::IoReqStatus Cache::input_req(vp::Block *__this, vp::IoReq *req)
 
     _this->io_event.event((uint8_t *)&offset);
 
-    // Cached path. If a refill is pending we must not start another one: queue
-    // this request and ack upstream with GRANTED. When the current refill
-    // resolves, fsm_handler will re-enter handle_req for this request.
-    if (_this->pending_refill.get() || _this->refill_retry_pending)
+    // Cached path. Requests are handled right away, even while refills are in
+    // flight, unless older requests are waiting in the queue or a refill must
+    // be retried: queue this request behind them and ack upstream with GRANTED,
+    // fsm_handler will re-enter handle_req for it.
+    if (_this->refill_retry_pending || _this->refill_pending_reqs.has_reqs())
     {
         _this->refill_pending_reqs.push_back(req);
         _this->check_state();
         return vp::IO_REQ_GRANTED;
     }
 
-    vp::IoReqStatus st = _this->handle_req(req);
+    vp::IoReqStatus st = _this->handle_req(req, false);
     if (st == vp::IO_REQ_DENIED)
     {
         // Refill was refused by the downstream and this request was new (not yet
@@ -664,21 +1365,6 @@ vp::IoReqStatus Cache::input_req(vp::Block *__this, vp::IoReq *req)
 }
 
 
-// ---------------------------------------------------------------------------
-// Pseudo-random LRU (8-bit LFSR, matches cache_v3)
-// ---------------------------------------------------------------------------
-
-unsigned int Cache::step_lru()
-{
-    int feedback = !(((this->lru_out >> 7) & 1)
-                  ^ ((this->lru_out >> 3) & 1)
-                  ^ ((this->lru_out >> 2) & 1)
-                  ^ ((this->lru_out >> 1) & 1));
-    this->lru_out = (this->lru_out << 1) | (feedback & 1);
-    return (this->lru_out >> 1) & (this->cfg.ways - 1);
-}
-
-
 // ---------------------------------------------------------------------------
 // Wire-side plumbing (unchanged)
 // ---------------------------------------------------------------------------
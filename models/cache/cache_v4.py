@@ -20,6 +20,28 @@ from gvsoc.systree import Component, SlaveItf
 from gvsoc.gui import Signal
 
 
+# Replacement policies. Each maps to the value of CONFIG_CACHE_REPLACEMENT
+# the model is compiled with.
+REPLACEMENT_RANDOM = 'random'
+REPLACEMENT_LRU    = 'lru'
+REPLACEMENT_PLRU   = 'plru'
+REPLACEMENT_FIFO   = 'fifo'
+
+_REPLACEMENT_IDS = {
+    REPLACEMENT_RANDOM: 0,
+    REPLACEMENT_LRU:    1,
+    REPLACEMENT_PLRU:   2,
+    REPLACEMENT_FIFO:   3,
+}
+
+# Prefetchers
+PREFETCHER_NONE      = 'none'
+PREFETCHER_NEXT_LINE = 'next_line'
+PREFETCHER_STRIDE    = 'stride'
+
+_PREFETCHERS = [PREFETCHER_NONE, PREFETCHER_NEXT_LINE, PREFETCHER_STRIDE]
+
+
 class CacheConfig(Config):
     """Configuration for the io_v2 cache component.
 
@@ -41,6 +63,16 @@ class CacheConfig(Config):
         memory level.
     refill_latency : int
         Latency in cycles added to synchronous refill completions.
+    nb_mshrs : int
+        Number of refills which can be in flight at the same time.
+    replacement : str
+        Replacement policy: ``'random'``, ``'lru'``, ``'plru'`` or
+        ``'fifo'``.
+    prefetcher : str
+        Prefetch engine: ``'none'``, ``'next_line'`` or ``'stride'``.
+    prefetch_degree : int
+        Number of lines prefetched ahead of each access of the miss
+        stream.
     """
 
     size: int = cfg_field(default=0, dump=True, desc=(
@@ -71,6 +103,25 @@ class CacheConfig(Config):
         "Latency in cycles for a refill request to the next memory level"
     ))
 
+    nb_mshrs: int = cfg_field(default=1, dump=True, desc=(
+        "Number of MSHRs, i.e. of refills which can be in flight at the same time"
+    ))
+
+    replacement: str = cfg_field(default=REPLACEMENT_RANDOM, dump=True, desc=(
+        "Replacement policy: 'random' (8-bit LFSR, as cache_v3), 'lru', 'plru' (tree "
+        "pseudo-LRU, power-of-two ways) or 'fifo'. Selected at compile time"
+    ))
+
+    prefetcher: str = cfg_field(default=PREFETCHER_NONE, dump=True, desc=(
+        "Prefetch engine trained on the miss stream: 'none', 'next_line' (the next "
+        "prefetch_degree lines) or 'stride' (prefetch_degree lines along a stride seen "
+        "twice in a row)"
+    ))
+
+    prefetch_degree: int = cfg_field(default=1, dump=True, desc=(
+        "Number of lines prefetched ahead of each access of the miss stream"
+    ))
+
 
 class Cache(Component):
     """Set-associative cache on the io_v2 protocol.
@@ -85,13 +136,13 @@ class Cache(Component):
     locally, and forwards misses as line-sized refill requests to the
     next memory level. Data for every line is stored verbatim inside the
     model (byte-accurate) so reads return the value that would flow
-    through the real hardware. Replacement on full sets uses a
-    pseudo-random 8-bit LFSR (deterministic across runs with a fixed seed
-    pattern) — there is no LRU tracking.
+    through the real hardware. A miss fills an invalid way of its set
+    if there is one, otherwise the way given by the replacement policy
+    (:attr:`CacheConfig.replacement`, see below).
 
     This is the io_v2 port of :class:`cache.cache_v3.Cache`. The
-    functional scope (replacement policy, flush semantics, bypass mode)
-    is identical; only the IO-side plumbing is new:
+    functional scope (flush semantics, bypass mode) is identical; only
+    the IO-side plumbing is new:
 
     - input and refill ports carry the ``io_v2`` signature
     - status is ``IO_REQ_DONE`` / ``IO_REQ_GRANTED`` / ``IO_REQ_DENIED``
@@ -125,21 +176,31 @@ class Cache(Component):
       ``timestamp`` is still in the future (because an earlier miss in
       the same cycle started a multi-cycle refill), the hit is stalled
       via ``req->inc_latency(timestamp - now)`` so the master paces
-      itself. Hits never stall an in-flight refill.
-    - **Miss, no refill pending**: a refill request is sent to the
-      ``REFILL`` port. A synchronous ``IO_REQ_DONE`` from the downstream
+      itself. Hits are served while refills are in flight
+      (hit-under-miss) and never stall them.
+    - **Miss, MSHR available**: an MSHR (miss status holding register)
+      is allocated, a way of the set which is not already being
+      refilled is picked, and a refill request owned by the MSHR is
+      sent to the ``REFILL`` port. A synchronous ``IO_REQ_DONE`` from the downstream
       yields an inline ``IO_REQ_DONE`` on the input (with
       :attr:`CacheConfig.refill_latency` + any latency the downstream
       annotated on ``req->latency`` both added to the master's
       accumulated latency). A ``IO_REQ_GRANTED`` parks the CPU request
-      in an internal FIFO; the master sees ``IO_REQ_GRANTED`` and later
+      in the MSHR; the master sees ``IO_REQ_GRANTED`` and later
       receives ``resp()`` once the refill lands.
-    - **Miss, refill pending**: only one refill is ever in flight. A new
-      miss arriving mid-refill is acked as ``IO_REQ_GRANTED`` and
-      pushed to the FIFO. The internal ``fsm_handler`` drains the FIFO
-      one request per cycle once the current refill resolves — the next
-      miss in the FIFO may itself start a new refill, or be a hit if the
-      landing refill happened to bring in its line.
+    - **Secondary miss**: a miss on a line which is already being
+      refilled is merged into its MSHR, without a new refill. It is
+      acked as ``IO_REQ_GRANTED`` and replied to when the refill lands,
+      after the requests merged before it.
+    - **Miss, no MSHR available**: when all
+      :attr:`CacheConfig.nb_mshrs` MSHRs are busy, or all ways of the
+      set are being refilled, the miss is acked as ``IO_REQ_GRANTED``
+      and pushed to an internal FIFO, and so are the requests arriving
+      after it, hits included, to keep the request order. The internal
+      ``fsm_handler`` drains the FIFO one request per cycle once a
+      refill resolves — the next miss in the FIFO may itself start a
+      new refill, or be a hit if the landing refill happened to bring
+      in its line.
     - **Bypass** (cache disabled): the CPU request is forwarded verbatim
       through ``REFILL`` after the address is rewritten by
       :attr:`CacheConfig.refill_shift` / :attr:`CacheConfig.refill_offset`.
@@ -153,6 +214,53 @@ class Cache(Component):
       refill target): a single ``IO_REQ_DONE`` with
       ``IO_RESP_INVALID`` is returned on the input.
 
+    Replacement
+    ~~~~~~~~~~~
+
+    The policy is compiled in (the generator passes
+    ``CONFIG_CACHE_REPLACEMENT``), so a hit only pays for the selected
+    one. Ways being refilled are never picked as victims.
+
+    - ``random`` (default): 8-bit LFSR stepped on each replacement, as
+      in cache_v3. No per-set state.
+    - ``lru``: true LRU, one recency byte per way.
+    - ``plru``: tree pseudo-LRU, ``ways - 1`` bits per set. Requires a
+      power-of-two number of ways.
+    - ``fifo``: round-robin, one byte per set.
+
+    The ``evictions`` statistic counts the valid lines replaced by a
+    refill, and ``set_evictions`` gives the same count per set, as
+    ``set:count`` pairs for the sets which had any.
+
+    Prefetch
+    ~~~~~~~~
+
+    :attr:`CacheConfig.prefetcher` enables a prefetch engine on the
+    ``REFILL`` port, trained on the miss stream: demand misses, plus
+    the first hit on a prefetched line so that a stream which is
+    prefetched in time keeps being prefetched.
+
+    - ``next_line``: each access of the stream to line ``L`` prefetches
+      lines ``L+1`` to ``L+prefetch_degree``.
+    - ``stride``: the line distance between two consecutive accesses of
+      the stream is the stride. Once the same stride is seen twice in a
+      row, each access to line ``L`` prefetches ``L+stride`` to
+      ``L+prefetch_degree*stride``. There is no PC, so interleaved
+      streams do not train it.
+
+    A prefetch is a line refill with no CPU request waiting for it. It
+    only uses an MSHR left free by the demand misses (it is dropped
+    when none is free or when demand misses are waiting) and skips
+    lines already present or being refilled. A demand miss on a line
+    being prefetched is merged into its MSHR.
+
+    Statistics: ``prefetches`` (issued), ``prefetch_useful``
+    (prefetched lines later hit), ``prefetch_late`` (demand misses
+    merged into an in-flight prefetch) and ``prefetch_accuracy``
+    (useful or late share of the issued prefetches). Prefetching
+    needs ``nb_mshrs > 1`` to overlap with demand misses on an
+    asynchronous downstream.
+
     Address transformation
     ~~~~~~~~~~~~~~~~~~~~~~
 
@@ -190,14 +298,25 @@ class Cache(Component):
     - **FLUSH** (``i_FLUSH``) — pulse to invalidate every line. The
       cache then pulses ``FLUSH_ACK`` to tell the driver the operation
       has completed. A flush is a single-cycle logical event in this
-      model — no dirty writeback occurs because lines are not marked
-      dirty (writes go straight through to the refilled line; there is
-      no write-back buffer).
+      model — no dirty writeback occurs: lines written to are marked
+      dirty, but the flag is only informative (writes go straight
+      through to the refilled line; there is no write-back buffer).
     - **FLUSH_LINE** / **FLUSH_LINE_ADDR** — latch a byte address via
       ``FLUSH_LINE_ADDR`` then pulse ``FLUSH_LINE`` to invalidate the
       single line containing that address. No ``FLUSH_ACK`` is pulsed
       for per-line flushes.
 
+    Traces
+    ~~~~~~
+
+    - ``port`` — address of every cached access.
+    - ``tags`` — address of every line refill.
+    - ``set_<way>/line_<set>`` — address of the refills of one line.
+      These events are registered the first time their line is refilled
+      while ``tags`` is enabled, so that a large cache does not create
+      one trace per line when nothing is traced. Enable them together
+      with ``tags``, e.g. with a pattern covering the whole cache.
+
     Ports
     ~~~~~
 
@@ -215,22 +334,18 @@ class Cache(Component):
     Constraints and limitations
     ~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-    - **Single refill in flight.** A new miss arriving while a refill
-      is already outstanding is queued but never overlapped. For
-      workloads that expect multiple outstanding refills (MSHR-style
-      caches), use a different model.
-    - **No write-back.** Writes hit lines in place; there is no dirty
-      bit and no eviction writeback traffic. A write that crosses a
+    - **Bounded refills in flight.** At most ``nb_mshrs`` refills are
+      outstanding. The default of ``1`` gives a blocking cache for
+      misses, hits still being served under the outstanding miss.
+    - **No write-back.** Writes hit lines in place and mark them
+      dirty, but there is no eviction writeback traffic. A write that crosses a
       miss refills the line first, then mutates the refilled data.
     - **Requests must fit within a single line.** An access that
       straddles two lines (``offset + size > line_size`` across a set
       boundary) is rejected with ``IO_RESP_INVALID`` — the cache does
       not split an input request into multiple internal refills.
-    - **Replacement is pseudo-random.** Set-level replacement uses an
-      8-bit LFSR tick per replacement. There is no LRU, no way-locking,
-      no explicit bias. With ``ways=1`` the LFSR is effectively
-      constant so the cache becomes fully deterministic — useful for
-      tests.
+    - **At most 64 ways.** There is no way-locking. With ``ways=1``
+      every policy degenerates to the same direct-mapped behaviour.
     - **Access size up to the bus width.** No internal serialisation of
       wide accesses: a 64-byte read served by a 32-byte line requires
       the caller to split.
@@ -257,7 +372,7 @@ class Cache(Component):
 
     ``ways``
         Associativity. ``1`` is direct-mapped, higher values are set
-        associative with pseudo-random replacement. Default: ``1``.
+        associative. At most ``64``. Default: ``1``.
 
     ``enabled``
         Initial state of the ``ENABLE`` wire. ``True`` makes the cache
@@ -279,6 +394,24 @@ class Cache(Component):
         the downstream's ``resp()`` fires is already the signal).
         Default: ``0``.
 
+    ``nb_mshrs``
+        Number of MSHRs, i.e. of distinct lines which can be refilled at
+        the same time. Misses to a line already being refilled never
+        take an additional MSHR. Only matters with a downstream which
+        answers asynchronously. Default: ``1``.
+
+    ``replacement``
+        Replacement policy, ``'random'``, ``'lru'``, ``'plru'`` or
+        ``'fifo'`` (see above). Default: ``'random'``.
+
+    ``prefetcher``
+        Prefetch engine, ``'none'``, ``'next_line'`` or ``'stride'``
+        (see above). Default: ``'none'``.
+
+    ``prefetch_degree``
+        Lines prefetched ahead of each access of the miss stream.
+        Default: ``1``.
+
     Parameters
     ----------
     parent : Component
@@ -303,9 +436,25 @@ class Cache(Component):
 
     def __init__(self, parent: Component, name: str, config: CacheConfig):
 
+        if config.replacement not in _REPLACEMENT_IDS:
+            raise ValueError(
+                f"Cache replacement must be one of {list(_REPLACEMENT_IDS)}, "
+                f"got {config.replacement!r}")
+        if config.prefetcher not in _PREFETCHERS:
+            raise ValueError(
+                f"Cache prefetcher must be one of {_PREFETCHERS}, got {config.prefetcher!r}")
+        if config.ways > 64:
+            raise ValueError(f"Cache supports at most 64 ways, got {config.ways}")
+        if config.replacement == REPLACEMENT_PLRU and config.ways & (config.ways - 1):
+            raise ValueError(f"PLRU replacement needs a power-of-two number of ways, "
+                f"got {config.ways}")
+
         super(Cache, self).__init__(parent, name, config=config)
         self.add_sources(['cache/cache_v4.cpp'])
 
+        self.add_c_flags([
+            f'-DCONFIG_CACHE_REPLACEMENT={_REPLACEMENT_IDS[config.replacement]}'])
+
         self.add_properties({
             'size': config.size,
             'ways': config.ways,
@@ -314,6 +463,10 @@ class Cache(Component):
             'refill_offset': config.refill_offset,
             'refill_shift': config.refill_shift,
             'enabled': config.enabled,
+            'nb_mshrs': config.nb_mshrs,
+            'replacement': config.replacement,
+            'prefetcher': config.prefetcher,
+            'prefetch_degree': config.prefetch_degree,
         })
 
     def i_INPUT(self) -> SlaveItf:
@@ -378,7 +531,8 @@ class Cache(Component):
         cache = Signal(self, parent_signal, name=self.name, path='req_addr',
             groups=['cache', 'active'])
         _ = Signal(self, cache, name='refill', path='refill_addr', groups=['cache'])
-        tags = Signal(self, cache, name='tags')
+        # The per-line events are only created while the `tags` event is active
+        tags = Signal(self, cache, name='tags', path='tags', groups=['cache'])
 
         ways = self.get_property('ways')
         size = self.get_property('size')
@@ -68,6 +68,18 @@ public:
         if (fread(this->buf.data(), 1, sz, f) != (size_t)sz) { fclose(f); return false; }
         fclose(f);
 
+        return this->parse(this->buf.data(), this->buf.size(), syms, lines);
+    }
+
+    // Same, from a binary already in memory (e.g. mapped). `data` must stay
+    // valid during the call only.
+    bool parse(const uint8_t *data, uint64_t size, std::vector<SymEntry> &syms,
+        std::vector<LineRow> &lines)
+    {
+        if (size < 64)
+            return false;
+        this->data = data;
+        this->data_size = size;
         if (!this->parse_sections())
             return false;
         this->parse_symbols(syms);
@@ -77,6 +89,8 @@ public:
 
 private:
     std::vector<uint8_t> buf;
+    const uint8_t *data = nullptr;
+    uint64_t data_size = 0;
     bool le = true;
     bool is64 = true;
     // .debug_line and the string sections its DWARF5 file tables may reference.
@@ -98,12 +112,12 @@ private:
     // Locate the symbol table and the debug sections by name.
     bool parse_sections()
     {
-        const uint8_t *b = this->buf.data();
+        const uint8_t *b = this->data;
         if (memcmp(b, "\177ELF", 4) != 0)
             return false;
         this->is64 = b[4] == 2;
         this->le = b[5] != 2;
-        uint64_t sz = this->buf.size();
+        uint64_t sz = this->data_size;
 
         uint64_t shoff   = is64 ? r64(b + 0x28) : r32(b + 0x20);
         uint16_t shentsz = is64 ? r16(b + 0x3a) : r16(b + 0x2e);
@@ -147,7 +161,7 @@ private:
     {
         if (sym_off == 0 || sym_entsz == 0)
             return;
-        const uint8_t *b = this->buf.data();
+        const uint8_t *b = this->data;
         const uint32_t STT_NOTYPE = 0, STT_FUNC = 2, STT_GNU_IFUNC = 10;
         uint32_t idx = 0;
         for (uint64_t o = 0; o + sym_entsz <= sym_sz; o += sym_entsz, idx++)
@@ -394,6 +408,17 @@ inline bool load(const char *path, std::vector<SymEntry> &syms, std::vector<Line
     return true;
 }
 
+// Same, from a binary already in memory.
+inline bool load(const uint8_t *data, uint64_t size, std::vector<SymEntry> &syms,
+    std::vector<LineRow> &lines)
+{
+    Parser p;
+    if (!p.parse(data, size, syms, lines))
+        return false;
+    finalize(syms, lines);
+    return true;
+}
+
 // Function name for addr: the nearest *sized* symbol that contains addr,
 // otherwise the nearest preceding symbol (covers zero-sized assembly labels).
 // Matches libdwfl's dwfl_module_addrname selection.
@@ -31,17 +31,12 @@
 // no <elf.h>), so this builds identically on Linux, macOS, etc. The block is
 // excluded for the 32-bit model variant, which has no trace symbols.
 #if !defined(__M32_MODE__)
-#include <cpu/dwarf_trace.hpp>
+#include <utils/elf_cache.hpp>
 
-// One registered binary: its symbol table and line-number rows, both parsed
-// once and address-sorted by dwarf_trace::load().
-struct iss_binary_info
-{
-    std::vector<dwarf_trace::SymEntry> syms;
-    std::vector<dwarf_trace::LineRow> lines;
-};
-
-static std::vector<iss_binary_info> iss_dw_binaries;
+// Loaded binaries, in registration order (nullptr if the binary could not be
+// read). Their symbol table and line-number rows are held by the ELF cache
+// (see utils/elf_cache.hpp for what it is shared with).
+static std::vector<std::shared_ptr<elf_cache::Image>> iss_dw_binaries;
 #endif
 
 Trace::Trace(Iss &iss)
@@ -144,12 +139,14 @@ static void iss_dw_ensure_loaded()
 {
     for (size_t i = iss_dw_binaries.size(); i < binaries.size(); i++)
     {
-        iss_dw_binaries.push_back({});
-        iss_binary_info &b = iss_dw_binaries.back();
-        if (!dwarf_trace::load(binaries[i].c_str(), b.syms, b.lines))
+        std::string error;
+        std::shared_ptr<elf_cache::Image> image = elf_cache::get(binaries[i], &error);
+        if (image == nullptr || !image->get_debug_info().valid)
         {
             fprintf(stderr, "Unable to load debug info from binary: %s\n", binaries[i].c_str());
+            image = nullptr;
         }
+        iss_dw_binaries.push_back(image);
     }
 }
 
@@ -164,8 +161,13 @@ static iss_pc_info *iss_libdw_resolve(iss_addr_t addr)
     const char *file = NULL;
     int line = 0;
 
-    for (auto &b : iss_dw_binaries)
+    for (auto &image : iss_dw_binaries)
     {
+        if (image == nullptr)
+        {
+            continue;
+        }
+        const elf_cache::DebugInfo &b = image->get_debug_info();
         const char *bf = dwarf_trace::func_for(b.syms, addr);
         bool got_line = dwarf_trace::line_for(b.lines, addr, &file, &line);
         if (bf != NULL || got_line)
@@ -26,6 +26,7 @@
 #include <cpu/iss_v2/include/insn.hpp>
 #include <cpu/iss_v2/include/offload.hpp>
 #include <cpu/iss_v2/include/task.hpp>
+#include <utils/host_profiler.hpp>
 
 // In-order single-issue dispatcher + held-insn tracker.
 //
@@ -140,6 +141,8 @@ public:
     vp::reg_64 retained;
 
     vp::Trace trace;
+    // Host time of the instruction handlers, null unless GV_HOST_PROFILE is set
+    host_profiler::Counter *host_prof;
 
     static void exec_instr(vp::Block *__this, vp::ClockEvent *event);
     static void exec_instr_check_all(vp::Block *__this, vp::ClockEvent *event);
@@ -183,6 +186,7 @@ private:
     void retain_check();
     static void flush_cache_ack_sync(vp::Block *_this, bool active);
     static void clock_sync(vp::Block *_this, bool active);
+    void gating_trace(const char *cause);
     static void bootaddr_sync(vp::Block *_this, uint32_t value);
     static void fetchen_sync(vp::Block *_this, bool active);
     void bootaddr_apply(uint32_t value);
@@ -198,6 +202,17 @@ private:
     vp::WireSlave<bool> fetchen_itf;
 
     bool clock_active;
+    // True while the clock notified through clock_en is gated. The core is
+    // then retained, so that its instruction event stays disarmed.
+    bool clock_gated = false;
+    int64_t clock_gated_start;
+
+#ifdef CONFIG_GVSOC_STATS_ACTIVE
+    bool stats_enabled = false;
+    // Cycles spent with a gated clock, i.e. instruction event occurrences
+    // avoided (the core may also have been halted or sleeping meanwhile)
+    vp::StatScalar stat_events_avoided;
+#endif
 
     vp::Trace asm_trace_event;
 
@@ -697,6 +697,21 @@ class RiscvCommon(st.Component):
         """
         return gvsoc.systree.SlaveItf(self, itf_name='fetchen', signature='wire<bool>')
 
+    def i_CLOCK_EN(self) -> gvsoc.systree.SlaveItf:
+        """Returns the clock enable port.
+
+        This can be bound to the clock gating notification of a clock model, so that the core
+        disarms its instruction event while its clock is gated (False) and re-arms it when it is
+        ungated (True).\n
+        It instantiates a port of type vp::WireSlave<bool>.\n
+
+        Returns
+        ----------
+        gvsoc.systree.SlaveItf
+            The slave interface
+        """
+        return gvsoc.systree.SlaveItf(self, itf_name='clock_en', signature='wire<bool>')
+
     def i_ENTRY(self) -> gvsoc.systree.SlaveItf:
         """Returns the boot address port.
 
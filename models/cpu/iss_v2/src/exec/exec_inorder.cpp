@@ -27,6 +27,7 @@ ExecInOrder::ExecInOrder(Iss &iss)
     : iss(iss), instr_event(&iss, &ExecInOrder::exec_instr_check_all)
 {
     this->iss.traces.new_trace("exec", &this->trace, vp::DEBUG);
+    this->host_prof = host_profiler::counter(this->iss.get_path(), "iss_v2");
 
     this->iss.new_master_port("busy", &busy_itf);
 
@@ -60,6 +61,27 @@ ExecInOrder::ExecInOrder(Iss &iss)
     this->retained.set(false);
     this->halted.set(false);
 
+#ifdef CONFIG_GVSOC_STATS_ACTIVE
+    vp::StatsEngine *stats_engine = this->iss.stats.get_engine();
+    this->stats_enabled = stats_engine != nullptr && stats_engine->is_enabled();
+    if (this->stats_enabled)
+    {
+        this->iss.stats.register_stat(&this->stat_events_avoided, "events_avoided",
+            "Cycles with a gated clock, during which the instruction event was disarmed");
+
+        // Account the on-going gated window at dump time
+        stats_engine->register_pre_dump([this]()
+        {
+            if (this->clock_gated)
+            {
+                int64_t now = this->iss.clock.get_cycles();
+                this->stat_events_avoided += now - this->clock_gated_start;
+                this->clock_gated_start = now;
+            }
+        });
+    }
+#endif
+
     this->current_insn = 0;
 
     this->iss.traces.new_trace_event_string("label", &this->asm_trace_event);
@@ -100,6 +122,14 @@ void ExecInOrder::reset(bool active)
         // Always increase the stall when reset is asserted since stall count is set to 0
         // and we need to prevent the core from fetching instructions
         this->retain_inc();
+
+        // The clock models only notify gating changes, so a clock gated before the reset is
+        // still gated after it. Apply its retain again since the count was cleared, otherwise
+        // the ungating would release the one of the reset.
+        if (this->clock_gated)
+        {
+            this->retain_inc();
+        }
     }
     else
     {
@@ -107,6 +137,8 @@ void ExecInOrder::reset(bool active)
         // executing instructions.
         this->fetchen_sync((vp::Block *)this, this->iss.get_js_config()->get("fetch_enable")->get_bool());
     }
+
+    this->gating_trace(active ? "reset" : "reset_release");
 }
 
 void ExecInOrder::sleep_enter(iss_insn_t *insn)
@@ -159,6 +191,7 @@ void ExecInOrder::dbg_unit_step_check()
 void ExecInOrder::exec_instr(vp::Block *__this, vp::ClockEvent *event)
 {
     Iss *const iss = (Iss *)__this;
+    host_profiler::Scope prof(iss->exec.host_prof);
 
     if (unlikely(iss->exec.stall_cycles > 0))
     {
@@ -253,6 +286,7 @@ void ExecInOrder::exec_instr_check_all(vp::Block *__this, vp::ClockEvent *event)
 {
     Iss *iss = (Iss *)__this;
     ExecInOrder *_this = &iss->exec;
+    host_profiler::Scope prof(_this->host_prof);
 
     if (unlikely(iss->exec.stall_cycles > 0))
     {
@@ -550,6 +584,49 @@ void ExecInOrder::clock_sync(vp::Block *__this, bool active)
     _this->trace.msg("Setting clock (active: %d)\n", active);
 
     _this->clock_active = active;
+
+    // A gated clock retains the core like a halt, which disarms the
+    // instruction event instead of letting it fire on every cycle. Pending
+    // tasks still run, and the event is re-armed on ungating.
+    if (!active && !_this->clock_gated)
+    {
+        _this->clock_gated = true;
+        _this->clock_gated_start = _this->iss.clock.get_cycles();
+        _this->retain_inc();
+    }
+    else if (active && _this->clock_gated)
+    {
+        _this->clock_gated = false;
+#ifdef CONFIG_GVSOC_STATS_ACTIVE
+        if (_this->stats_enabled)
+        {
+            _this->stat_events_avoided += _this->iss.clock.get_cycles() - _this->clock_gated_start;
+        }
+#endif
+        _this->retain_dec();
+    }
+
+    _this->gating_trace("clock_en");
+}
+
+
+// Report the retain count and the gated cycles accounted so far, so that the
+// clock gating can be checked from the debug trace.
+void ExecInOrder::gating_trace(const char *cause)
+{
+#ifdef CONFIG_GVSOC_STATS_ACTIVE
+    if (this->stats_enabled)
+    {
+        this->trace.msg(vp::Trace::LEVEL_DEBUG,
+            "Clock gating state (cause: %s, gated: %d, retained: %ld, events_avoided: %ld)\n",
+            cause, this->clock_gated, (long)this->retained.get(),
+            (long)this->stat_events_avoided.get());
+        return;
+    }
+#endif
+    this->trace.msg(vp::Trace::LEVEL_DEBUG,
+        "Clock gating state (cause: %s, gated: %d, retained: %ld)\n",
+        cause, this->clock_gated, (long)this->retained.get());
 }
 
 
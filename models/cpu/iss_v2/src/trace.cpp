@@ -31,17 +31,12 @@
 // no <elf.h>), so this builds identically on Linux, macOS, etc. The block is
 // excluded for the 32-bit model variant, which has no trace symbols.
 #if !defined(__M32_MODE__)
-#include <cpu/dwarf_trace.hpp>
+#include <utils/elf_cache.hpp>
 
-// One registered binary: its symbol table and line-number rows, both parsed
-// once and address-sorted by dwarf_trace::load().
-struct iss_binary_info
-{
-    std::vector<dwarf_trace::SymEntry> syms;
-    std::vector<dwarf_trace::LineRow> lines;
-};
-
-static std::vector<iss_binary_info> iss_dw_binaries;
+// Registered binaries. Their symbol table and line-number rows are held by the
+// ELF cache (see utils/elf_cache.hpp), which parses them once, on the first
+// PC resolution.
+static std::vector<std::shared_ptr<elf_cache::Image>> iss_dw_binaries;
 #endif
 
 Trace::Trace(Iss &iss)
@@ -189,8 +184,13 @@ static iss_pc_info *iss_libdw_resolve(iss_addr_t addr)
     const char *file = NULL;
     int line = 0;
 
-    for (auto &b : iss_dw_binaries)
+    for (auto &image : iss_dw_binaries)
     {
+        const elf_cache::DebugInfo &b = image->get_debug_info();
+        if (!b.valid)
+        {
+            continue;
+        }
         const char *bf = dwarf_trace::func_for(b.syms, addr);
         bool got_line = dwarf_trace::line_for(b.lines, addr, &file, &line);
         if (bf != NULL || got_line)
@@ -249,14 +249,18 @@ void iss_register_debug_elf(Iss *iss, const char *binary)
 
     binaries.push_back(std::string(binary));
 
-    // Parse the symbol table (function names) and the DWARF .debug_line program
-    // (file:line) once into address-sorted tables; resolution is then lookups.
-    iss_dw_binaries.push_back({});
-    iss_binary_info &b = iss_dw_binaries.back();
-    if (!dwarf_trace::load(binary, b.syms, b.lines))
+    // Only map the binary here. The symbol table (function names) and the DWARF
+    // .debug_line program (file:line) are parsed into address-sorted tables on
+    // the first PC resolution, so a run with no tracing never parses them.
+    std::string error;
+    std::shared_ptr<elf_cache::Image> image = elf_cache::get(binary, &error);
+    if (image == nullptr)
     {
-        fprintf(stderr, "Unable to load debug info from binary: %s\n", binary);
+        fprintf(stderr, "Unable to load debug info from binary: %s (%s)\n", binary,
+            error.c_str());
+        return;
     }
+    iss_dw_binaries.push_back(image);
 #endif
 }
 
@@ -24,10 +24,10 @@
  * data written by the downstream into the request buffer reaches the master.
  */
 
-#include <deque>
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
 #include <interco/fifo_v2/fifo_config.hpp>
+#include <utils/ring_buffer.hpp>
 
 class Fifo : public vp::Component
 {
@@ -57,8 +57,9 @@ private:
     // Drives one buffered request downstream per cycle.
     vp::ClockEvent pump_event;
 
-    // Buffered requests, oldest first. Size capped at cfg.depth.
-    std::deque<vp::IoReq *> queue;
+    // Buffered requests, oldest first. Size capped at cfg.depth, storage
+    // allocated once at construction.
+    RingBuffer<vp::IoReq *> queue;
 
     // A head request has been issued downstream and is still outstanding
     // (either awaiting an async resp(), or parked on a DENIED waiting for
@@ -78,6 +79,8 @@ Fifo::Fifo(vp::ComponentConf &config)
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
     this->new_slave_port("input",   &this->input_itf);
     this->new_master_port("output", &this->output_itf);
+
+    this->queue.reserve(this->cfg.depth > 0 ? this->cfg.depth : 1);
 }
 
 void Fifo::reset(bool active)
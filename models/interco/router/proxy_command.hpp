@@ -18,6 +18,10 @@
  * unlocking, no waiting for simulation cycles. Accesses falling into a hole
  * of the map (no mapping, or a target that does not implement vp::DebugMemIf)
  * return "err=1" instead of hanging.
+ *
+ * Bulk transfers can go through a shared buffer instead of the pipes
+ * (mem_shm_* commands, see proxy_shm.hpp): the backdoor access then reads or
+ * writes the shared buffer directly, without intermediate copy.
  */
 
 #pragma once
@@ -26,6 +30,8 @@
 #include <vp/debug_mem.hpp>
 #include <vp/proxy.hpp>
 
+#include "proxy_shm.hpp"
+
 #include <cstdio>
 #include <cstdlib>
 #include <string>
@@ -44,6 +50,23 @@ inline std::string handle_proxy_command(
     const std::string &cmd_req,
     vp::DebugMemIf *dbg)
 {
+    if (!args.empty() && vp_router_proxy_shm::is_shm_command(args[0]))
+    {
+        vp_router_proxy_shm::ShmWindow window;
+        uint64_t addr, size;
+        bool is_write;
+        if (!vp_router_proxy_shm::decode_command(args, window, addr, size, is_write))
+        {
+            return "err=1";
+        }
+        if (window.data != nullptr &&
+            dbg->debug_mem_access(addr, window.data, size, is_write))
+        {
+            return "err=1";
+        }
+        return "err=0";
+    }
+
     if (args.size() < 3 ||
         (args[0] != "mem_read" && args[0] != "mem_write"))
     {
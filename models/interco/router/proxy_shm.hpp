@@ -0,0 +1,220 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * Shared-memory buffers for bulk proxy memory transfers.
+ *
+ * Streaming tens of MB through the proxy pipes costs one copy into a
+ * temporary buffer, one through the pipe and one into the target. For bulk
+ * transfers the client instead creates a shared buffer, asks the router to
+ * map it once, and then only sends small commands naming a window of that
+ * buffer; the router copies directly between the buffer and the memory.
+ *
+ * Protocol, on the existing proxy command channel (all replies are
+ * "err=0" / "err=1", no payload):
+ *
+ *   mem_shm_map <name> <size>
+ *       Map <size> bytes of the buffer <name>. <name> is either a POSIX
+ *       shared memory object ("/gv_shm_1234", shm_open) created by the
+ *       client, or a file path such as "/proc/<pid>/fd/<fd>" for a memfd.
+ *       <size> must not be 0 nor exceed the size of the object.
+ *       An "err=1" reply (e.g. from an older router) tells the client to
+ *       fall back to mem_read/mem_write.
+ *   mem_shm_write <addr> <size> <name> <offset>
+ *       Copy <size> bytes from the buffer at <offset> to memory at <addr>.
+ *   mem_shm_read <addr> <size> <name> <offset>
+ *       Copy <size> bytes from memory at <addr> to the buffer at <offset>.
+ *   mem_shm_unmap <name>
+ *       Release the mapping. The client still owns (and unlinks) the object.
+ *
+ * Mappings are process-wide and keyed by name, so a client talking to
+ * several routers maps the buffer once per router component it uses. They are
+ * reference-counted: each mem_shm_map must be balanced by a mem_shm_unmap,
+ * and the buffer is only unmapped once the last one is released.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vp_router_proxy_shm
+{
+
+// One mapping of a buffer, unmapped when the last reference goes away. Copies
+// hold a reference, so that a remap or an unmap from another session never
+// pulls the memory from under them.
+struct ShmMapping
+{
+    ShmMapping(uint8_t *data, uint64_t size) : data(data), size(size) {}
+    ~ShmMapping() { munmap(this->data, this->size); }
+
+    uint8_t *data;
+    uint64_t size;
+};
+
+struct ShmBuffer
+{
+    std::shared_ptr<ShmMapping> mapping;
+    // Number of mem_shm_map not yet balanced by a mem_shm_unmap
+    int refs;
+};
+
+// Window of a mapped buffer resolved for a read/write command. `data` stays
+// valid as long as the window is alive.
+struct ShmWindow
+{
+    std::shared_ptr<ShmMapping> mapping;
+    uint8_t *data = nullptr;
+};
+
+// Mapped buffers, by name. Accessed from proxy session threads, which already
+// serialize on the engine lock, the mutex only protects against sessions on
+// different engines.
+inline std::map<std::string, ShmBuffer> buffers;
+inline std::mutex buffers_lock;
+
+inline bool is_shm_command(const std::string &cmd)
+{
+    return cmd == "mem_shm_map" || cmd == "mem_shm_unmap" ||
+        cmd == "mem_shm_read" || cmd == "mem_shm_write";
+}
+
+inline bool map_buffer(const std::string &name, uint64_t size)
+{
+    if (size == 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(buffers_lock);
+
+    auto it = buffers.find(name);
+    if (it != buffers.end() && it->second.mapping->size >= size)
+    {
+        // Same buffer mapped again, e.g. by another router of the same model
+        it->second.refs++;
+        return true;
+    }
+
+    // A name with a single leading '/' is a POSIX shm object, anything else
+    // with a path separator is opened as a file (memfd through /proc).
+    bool is_shm = name.size() > 1 && name[0] == '/' && name.find('/', 1) == std::string::npos;
+    int fd = is_shm ? shm_open(name.c_str(), O_RDWR, 0) : open(name.c_str(), O_RDWR);
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    // Pages mapped past the end of the object raise SIGBUS when accessed
+    struct stat st;
+    if (fstat(fd, &st) == -1 || size > (uint64_t)st.st_size)
+    {
+        close(fd);
+        return false;
+    }
+
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    auto mapping = std::make_shared<ShmMapping>((uint8_t *)data, size);
+    if (it != buffers.end())
+    {
+        // The client grew the buffer. The old mapping is released once the
+        // copies still going through it are done.
+        it->second.mapping = mapping;
+        it->second.refs++;
+    }
+    else
+    {
+        buffers[name] = ShmBuffer{mapping, 1};
+    }
+    return true;
+}
+
+inline bool unmap_buffer(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(buffers_lock);
+
+    auto it = buffers.find(name);
+    if (it == buffers.end())
+    {
+        return false;
+    }
+    if (--it->second.refs == 0)
+    {
+        buffers.erase(it);
+    }
+    return true;
+}
+
+// Window [offset, offset + size) of a mapped buffer. Its data is nullptr if
+// the buffer is not mapped or the window does not fit.
+inline ShmWindow get_window(const std::string &name, uint64_t offset, uint64_t size)
+{
+    std::lock_guard<std::mutex> lock(buffers_lock);
+
+    auto it = buffers.find(name);
+    if (it == buffers.end())
+    {
+        return ShmWindow{};
+    }
+    const std::shared_ptr<ShmMapping> &mapping = it->second.mapping;
+    if (offset > mapping->size || size > mapping->size - offset)
+    {
+        return ShmWindow{};
+    }
+    return ShmWindow{mapping, mapping->data + offset};
+}
+
+// Handle the map/unmap commands and resolve the buffer window of the
+// read/write ones. Returns false on a malformed command or an unknown
+// buffer. On success, for read/write, `window` holds the window to copy
+// from or to, and `addr`, `size` and `is_write` describe the memory access.
+inline bool decode_command(const std::vector<std::string> &args, ShmWindow &window,
+    uint64_t &addr, uint64_t &size, bool &is_write)
+{
+    window = ShmWindow{};
+
+    if (args[0] == "mem_shm_map")
+    {
+        return args.size() >= 3 &&
+            map_buffer(args[1], (uint64_t)std::strtoull(args[2].c_str(), nullptr, 0));
+    }
+
+    if (args[0] == "mem_shm_unmap")
+    {
+        return args.size() >= 2 && unmap_buffer(args[1]);
+    }
+
+    if (args.size() < 5)
+    {
+        return false;
+    }
+
+    is_write = args[0] == "mem_shm_write";
+    addr = (uint64_t)std::strtoull(args[1].c_str(), nullptr, 0);
+    size = (uint64_t)std::strtoull(args[2].c_str(), nullptr, 0);
+    uint64_t offset = (uint64_t)std::strtoull(args[4].c_str(), nullptr, 0);
+    window = get_window(args[3], offset, size);
+    return window.data != nullptr;
+}
+
+}  // namespace vp_router_proxy_shm
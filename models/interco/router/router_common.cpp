@@ -22,6 +22,7 @@
 #include "router_common.hpp"
 #include <vp/itf/io.hpp>
 #include <vp/proxy.hpp>
+#include "proxy_shm.hpp"
 
 RouterCommon::RouterCommon(vp::ComponentConf &config)
 : vp::Component(config)
@@ -33,6 +34,38 @@ RouterCommon::RouterCommon(vp::ComponentConf &config)
 std::string RouterCommon::handle_command(gv::GvProxy *proxy, FILE *req_file,
     FILE *reply_file, std::vector<std::string> args, std::string cmd_req)
 {
+    if (vp_router_proxy_shm::is_shm_command(args[0]))
+    {
+        // Bulk transfer through a shared buffer, the debug request reads or
+        // writes the buffer window directly.
+        vp_router_proxy_shm::ShmWindow window;
+        uint64_t addr, size;
+        bool is_write;
+        if (!vp_router_proxy_shm::decode_command(args, window, addr, size, is_write))
+        {
+            return "err=1";
+        }
+        if (window.data == nullptr)
+        {
+            return "err=0";
+        }
+
+        vp::IoReq *req = &this->proxy_req;
+        uint8_t *proxy_data = req->get_data();
+        req->init();
+        req->set_data(window.data);
+        req->set_is_write(is_write);
+        req->set_size(size);
+        req->set_addr(addr);
+        req->set_debug(true);
+
+        int error = this->handle_req(req, 0) != vp::IO_REQ_OK;
+
+        req->set_data(proxy_data);
+
+        return "err=" + std::to_string(error);
+    }
+
     if (args[0] == "mem_write" || args[0] == "mem_read")
     {
         int error = 0;
@@ -29,6 +29,7 @@
 #include <vp/clocked_signal.hpp>
 #include <vp/proxy.hpp>
 #include <interco/router_v2/router_config.hpp>
+#include <utils/host_profiler.hpp>
 
 #include "proxy_command.hpp"
 #include "router_v2_debug.hpp"
@@ -154,6 +155,7 @@ private:
 
     RouterConfig cfg;
     vp::Trace trace;
+    host_profiler::Counter *host_prof;
     std::vector<InputPort *> inputs;
     std::vector<OutputPort *> entries;
     vp::MappingTree mapping_tree;
@@ -268,6 +270,7 @@ RouterBackpressure::RouterBackpressure(vp::ComponentConf &config)
     : vp::Component(config, this->cfg), mapping_tree(&this->trace)
 {
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->host_prof = host_profiler::counter(this->get_path(), "router_v2_backpressure");
 
     this->stats.register_stat(&this->stat_reads, "reads", "Number of read requests");
     this->stats.register_stat(&this->stat_writes, "writes", "Number of write requests");
@@ -342,6 +345,7 @@ void RouterBackpressure::free_inflight(InFlight *ifl)
 vp::IoReqStatus RouterBackpressure::req_muxed(vp::Block *__this, vp::IoReq *req, int port)
 {
     RouterBackpressure *_this = (RouterBackpressure *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     InputPort *in = _this->inputs[port];
     int64_t now = _this->clock.get_cycles();
 
@@ -498,6 +502,7 @@ void RouterBackpressure::send_handler(vp::Block *__this, vp::ClockEvent *event)
 {
     InputPort *in = (InputPort *)event->get_args()[0];
     RouterBackpressure *_this = in->top;
+    host_profiler::Scope prof(_this->host_prof);
 
     vp::IoReq *req = in->pending_req;
     int mapping_id = in->pending_mapping_id;
@@ -523,6 +528,7 @@ void RouterBackpressure::send_handler(vp::Block *__this, vp::ClockEvent *event)
 vp::IoRespAck RouterBackpressure::resp_muxed(vp::Block *__this, vp::IoReq *req, int /*id*/)
 {
     RouterBackpressure *_this = (RouterBackpressure *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     InFlight *ifl = (InFlight *)req->initiator;
     InputPort *in = ifl->input;
     req->initiator = ifl->saved_initiator;
@@ -534,6 +540,7 @@ vp::IoRespAck RouterBackpressure::resp_muxed(vp::Block *__this, vp::IoReq *req,
 void RouterBackpressure::retry_muxed(vp::Block *__this, int id, vp::IoRetryChannel)
 {
     RouterBackpressure *_this = (RouterBackpressure *)__this;
+    host_profiler::Scope prof(_this->host_prof);
 
     // Walk inputs. Two cases keyed by whether the input has a pending delayed-send:
     // - pending_req != NULL: the deny happened inside the router itself during a
@@ -38,7 +38,6 @@
  * simulation is paused.
  */
 
-#include <deque>
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
 #include <vp/stats/stats.hpp>
@@ -46,6 +45,8 @@
 #include <vp/signal.hpp>
 #include <vp/proxy.hpp>
 #include <interco/router_v2/router_config.hpp>
+#include <utils/ring_buffer.hpp>
+#include <utils/host_profiler.hpp>
 
 #include "proxy_command.hpp"
 #include "router_v2_debug.hpp"
@@ -82,6 +83,10 @@ struct QueuedReq
     int output_id;
 };
 
+// Initial storage of an input queue. Requests only pile up there while an
+// output is stalled, so a handful of entries covers usual masters.
+static constexpr int INITIAL_QUEUE_SIZE = 8;
+
 class InputPort
 {
 public:
@@ -94,7 +99,9 @@ public:
     int64_t next_available_cycle = 0;
     // Requests that were accepted by the router (GRANTED to master) but couldn't be
     // forwarded because some output was stalled. Drained when the output retries.
-    std::deque<QueuedReq> queue;
+    // Unbounded (the master is granted), the storage grows to the peak
+    // occupancy and is then reused.
+    RingBuffer<QueuedReq> queue;
 };
 
 struct InFlight
@@ -151,6 +158,7 @@ private:
     std::vector<OutputPort *> entries;
 
     vp::Trace trace;
+    host_profiler::Counter *host_prof;
     vp::StatScalar stat_reads;
     vp::StatScalar stat_writes;
     vp::StatScalar stat_bytes_read;
@@ -193,6 +201,7 @@ InputPort::InputPort(RouterBandwidth *top, int id, std::string name)
     : top(top), id(id),
       itf(id, &RouterBandwidth::req_muxed)
 {
+    this->queue.reserve(INITIAL_QUEUE_SIZE);
 }
 
 
@@ -205,6 +214,7 @@ RouterBandwidth::RouterBandwidth(vp::ComponentConf &config)
       mapping_tree(&this->trace)
 {
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->host_prof = host_profiler::counter(this->get_path(), "router_v2_bandwidth");
 
     this->stats.register_stat(&this->stat_reads, "reads", "Number of read requests");
     this->stats.register_stat(&this->stat_writes, "writes", "Number of write requests");
@@ -335,6 +345,7 @@ vp::IoReqStatus RouterBandwidth::forward_inline(InputPort *in, vp::IoReq *req,
 vp::IoReqStatus RouterBandwidth::req_muxed(vp::Block *__this, vp::IoReq *req, int port)
 {
     RouterBandwidth *_this = (RouterBandwidth *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     InputPort *in = _this->inputs[port];
     uint64_t size = req->get_size();
     int64_t now = _this->clock.get_cycles();
@@ -384,7 +395,8 @@ void RouterBandwidth::drain_queue(InputPort *in)
 {
     while (!in->queue.empty())
     {
-        QueuedReq &q = in->queue.front();
+        // Copied out, the slot is reused as soon as it is popped.
+        QueuedReq q = in->queue.front();
         OutputPort *out = this->entries[q.output_id];
         if (out->stalled) return;   // another DENY on this or later forward
 
@@ -414,6 +426,7 @@ void RouterBandwidth::drain_queue(InputPort *in)
 vp::IoRespAck RouterBandwidth::resp_muxed(vp::Block *__this, vp::IoReq *req, int /*id*/)
 {
     RouterBandwidth *_this = (RouterBandwidth *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     InFlight *ifl = (InFlight *)req->initiator;
     InputPort *in = ifl->input;
     bool burst_done = req->is_last;
@@ -443,6 +456,7 @@ vp::IoRespAck RouterBandwidth::resp_muxed(vp::Block *__this, vp::IoReq *req, int
 void RouterBandwidth::retry_muxed(vp::Block *__this, int id, vp::IoRetryChannel)
 {
     RouterBandwidth *_this = (RouterBandwidth *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     _this->entries[id]->stalled = false;
     for (InputPort *in : _this->inputs)
     {
@@ -52,6 +52,8 @@
 #include <vp/signal.hpp>
 #include <vp/proxy.hpp>
 #include <interco/router_v2/router_config.hpp>
+#include <utils/ring_buffer.hpp>
+#include <utils/host_profiler.hpp>
 
 #include "proxy_command.hpp"
 #include "router_v2_debug.hpp"
@@ -159,7 +161,7 @@ public:
         vp::IoReq *req;
         int        slot_idx;
     };
-    std::deque<PendingBeat> pending;
+    RingBuffer<PendingBeat> pending;
     uint64_t pending_bytes = 0;
     // Cycle-latched "head arrival" gate — beats pushed in cycle T are only
     // visible to an fsm running at cycle T+1.
@@ -280,6 +282,7 @@ private:
     int resp_round_robin_next = 0;
 
     vp::Trace trace;
+    host_profiler::Counter *host_prof;
 
     // Top-level busy bit: pulsed for one cycle whenever any output port
     // logs an access or a response. Used as the path for the router row's
@@ -406,6 +409,7 @@ RouterBeat::RouterBeat(vp::ComponentConf &config)
       active(*this, "active", 1, vp::SignalCommon::ResetKind::HighZ)
 {
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->host_prof = host_profiler::counter(this->get_path(), "router_v2_beat");
 
     this->stats.register_stat(&this->stat_reads, "reads", "Number of read requests");
     this->stats.register_stat(&this->stat_writes, "writes", "Number of write beats");
@@ -448,6 +452,9 @@ RouterBeat::RouterBeat(vp::ComponentConf &config)
     {
         std::string name = i == 0 ? "input" : "input_" + std::to_string(i);
         InputPort *in = new InputPort(this, i, name);
+        // Write beats are bounded by the FIFO byte budget; read descriptors
+        // cost no byte and only make the buffer grow on the first bursts.
+        in->pending.reserve(this->cfg.max_input_pending_size / this->cfg.width + 1);
         this->inputs[i] = in;
         this->new_slave_port(name, &in->itf, this);
     }
@@ -596,6 +603,7 @@ vp::IoReqStatus RouterBeat::forward_beat(InputPort *in, OutputPort *out,
 vp::IoReqStatus RouterBeat::req_muxed(vp::Block *__this, vp::IoReq *req, int port)
 {
     RouterBeat *_this = (RouterBeat *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     InputPort *in = _this->inputs[port];
     uint64_t size = req->get_size();
     bool is_write = req->get_is_write();
@@ -713,6 +721,7 @@ vp::IoReqStatus RouterBeat::req_muxed(vp::Block *__this, vp::IoReq *req, int por
 void RouterBeat::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
 {
     RouterBeat *_this = (RouterBeat *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     int64_t now = _this->clock.get_cycles();
     int n = (int)_this->inputs.size();
 
@@ -828,6 +837,7 @@ void RouterBeat::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
 vp::IoRespAck RouterBeat::resp_muxed(vp::Block *__this, vp::IoReq *req, int port)
 {
     RouterBeat *_this = (RouterBeat *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     OutputPort *self = _this->entries[port];
 
     // The forward path stashed slot_idx in req->burst_id. The downstream
@@ -938,6 +948,7 @@ void RouterBeat::resp_retry_in_muxed(vp::Block *__this, int port,
                                      vp::IoRetryChannel /*channel*/)
 {
     RouterBeat *_this = (RouterBeat *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     // An upstream master signalled its response channel is ready again. The
     // beats we hold live in the downstream producers, so re-drive every stalled
     // output now (synchronously, as the retry contract requires): the one
@@ -982,12 +993,14 @@ void RouterBeat::drive_stalled_resps()
 void RouterBeat::resp_fsm_handler(vp::Block *__this, vp::ClockEvent * /*event*/)
 {
     RouterBeat *_this = (RouterBeat *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     _this->drive_stalled_resps();
 }
 
 void RouterBeat::retry_muxed(vp::Block *__this, int port, vp::IoRetryChannel channel)
 {
     RouterBeat *_this = (RouterBeat *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     OutputPort *self = _this->entries[port];
 
     _this->trace.msg(vp::Trace::LEVEL_TRACE,
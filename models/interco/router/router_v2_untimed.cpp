@@ -31,6 +31,7 @@
 #include <interco/router_v2/router_config.hpp>
 #include <unordered_map>
 #include <vector>
+#include <utils/host_profiler.hpp>
 
 #include "proxy_command.hpp"
 #include "router_v2_debug.hpp"
@@ -122,6 +123,7 @@ private:
     std::vector<OutputPort *> entries;
 
     vp::Trace trace;
+    host_profiler::Counter *host_prof;
 };
 
 
@@ -163,6 +165,7 @@ RouterUntimed::RouterUntimed(vp::ComponentConf &config)
       mapping_tree(&this->trace)
 {
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->host_prof = host_profiler::counter(this->get_path(), "router_v2_untimed");
 
     this->inputs.resize(this->cfg.nb_input_port);
     for (int i = 0; i < this->cfg.nb_input_port; i++)
@@ -208,6 +211,7 @@ void RouterUntimed::free_inflight(InFlight *ifl)
 vp::IoReqStatus RouterUntimed::req_muxed(vp::Block *__this, vp::IoReq *req, int port)
 {
     RouterUntimed *_this = (RouterUntimed *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     InputPort *in = _this->inputs[port];
     uint64_t size = req->get_size();
 
@@ -252,6 +256,7 @@ vp::IoReqStatus RouterUntimed::req_muxed(vp::Block *__this, vp::IoReq *req, int
 vp::IoRespAck RouterUntimed::resp_muxed(vp::Block *__this, vp::IoReq *req, int /*id*/)
 {
     RouterUntimed *_this = (RouterUntimed *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     auto it = _this->in_flight_map.find(req);
     vp_assert(it != _this->in_flight_map.end(), &_this->trace,
         "resp_muxed: no in-flight entry for req=%p\n", req);
@@ -271,6 +276,7 @@ vp::IoRespAck RouterUntimed::resp_muxed(vp::Block *__this, vp::IoReq *req, int /
 void RouterUntimed::retry_muxed(vp::Block *__this, int /*id*/, vp::IoRetryChannel)
 {
     RouterUntimed *_this = (RouterUntimed *)__this;
+    host_profiler::Scope prof(_this->host_prof);
     // Broadcast to every input. Masters with nothing held just ignore it.
     for (InputPort *in : _this->inputs)
     {
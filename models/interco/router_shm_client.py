@@ -0,0 +1,49 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+"""Proxy client of the router shared-buffer transfers.
+
+Extends the gvsoc_control router client with the mem_shm_* commands of
+the io_v2 routers (see router/proxy_shm.hpp), so that control scripts can
+move bulk data through a POSIX shm or memfd buffer instead of the proxy
+pipes. The buffer must be mapped with at least the size of the windows
+accessed, and at most the size of the shm object.
+"""
+
+import gvsoc.gvsoc_control
+
+
+class ShmRouter(gvsoc.gvsoc_control.Router):
+    """Router client with shared-buffer transfers.
+
+    Every method raises RuntimeError if the router replies with an error.
+    """
+
+    def _shm_cmd(self, *args):
+        cmd = 'component %s %s' % (self.component, ' '.join(str(arg) for arg in args))
+        reply = self.proxy._send_cmd(cmd)
+        if 'err=0' not in str(reply):
+            raise RuntimeError('%s failed: %s' % (args[0], reply))
+
+    def mem_shm_map(self, name: str, size: int):
+        """Map `size` bytes of the shared buffer `name` in the simulator.
+
+        A name with a single leading '/' is a POSIX shm object, any other
+        path (e.g. /proc/<pid>/fd/<fd> of a memfd) is opened as a file.
+        """
+        self._shm_cmd('mem_shm_map', name, hex(size))
+
+    def mem_shm_unmap(self, name: str):
+        """Release one mapping of the shared buffer `name`."""
+        self._shm_cmd('mem_shm_unmap', name)
+
+    def mem_shm_write(self, addr: int, size: int, name: str, offset: int):
+        """Write `size` bytes at `offset` of buffer `name` to memory at `addr`."""
+        self._shm_cmd('mem_shm_write', hex(addr), hex(size), name, hex(offset))
+
+    def mem_shm_read(self, addr: int, size: int, name: str, offset: int):
+        """Read `size` bytes of memory at `addr` to `offset` of buffer `name`."""
+        self._shm_cmd('mem_shm_read', hex(addr), hex(size), name, hex(offset))
@@ -29,6 +29,41 @@ class TrafficGeneratorConfigMaster;
 class TrafficGeneratorSync;
 class Generator;
 
+// Address patterns supported by the v2 generator. The v1 generator only knows
+// the linear sweep and ignores the pattern.
+typedef enum
+{
+    // Sweep <size> bytes from <address> in <packet_size> chunks.
+    TRAFFIC_PATTERN_LINEAR,
+    // Uniformly random packet-aligned addresses in [address, address + window).
+    TRAFFIC_PATTERN_RANDOM,
+    // address + (n * stride) % window for the n-th packet.
+    TRAFFIC_PATTERN_STRIDED,
+    // <hotspot_ratio> percent of the packets go to a random address inside the
+    // hot-spot region, the others are random within the window.
+    TRAFFIC_PATTERN_HOTSPOT,
+    // Addresses replayed in order from a binary file of native 64-bit words,
+    // wrapping around at the end of the file.
+    TRAFFIC_PATTERN_TRACE,
+} TrafficGeneratorPatternKind;
+
+// Traffic shape of one transfer. Fields left to 0 take the generator defaults
+// (window = transfer size, stride = packet size, nb_outstanding = the
+// component nb_pending_reqs).
+class TrafficGeneratorPattern
+{
+public:
+    TrafficGeneratorPatternKind kind;
+    uint64_t window;
+    uint64_t stride;
+    uint64_t hotspot_base;
+    uint64_t hotspot_size;
+    int hotspot_ratio;
+    const char *trace_file;
+    uint64_t seed;
+    int nb_outstanding;
+};
+
 class TrafficGeneratorConfig
 {
 public:
@@ -42,6 +77,8 @@ public:
     bool check;
     bool check_status;
     int64_t duration;
+    // Optional traffic pattern, NULL to use the component configuration.
+    const TrafficGeneratorPattern *pattern;
 };
 
 class TrafficGenerator
@@ -77,6 +114,11 @@ public:
     // Send one burst of size <packet_size> at each cycle for a total of <size> bytes.
     inline void start(uint64_t address, size_t size, size_t packet_size,
         TrafficGeneratorSync *sync, bool do_write=false, bool check=false);
+    // Same as start but with an explicit traffic pattern. Checking is only
+    // supported for the linear pattern.
+    inline void start_pattern(uint64_t address, size_t size, size_t packet_size,
+        TrafficGeneratorSync *sync, const TrafficGeneratorPattern *pattern,
+        bool do_write=false);
     inline void get_result(bool *check_status=NULL, int64_t *duration=NULL);
     inline bool is_finished();
 };
@@ -92,6 +134,17 @@ inline void TrafficGeneratorConfigMaster::start(uint64_t address, size_t size, s
     this->sync(&config);
 }
 
+inline void TrafficGeneratorConfigMaster::start_pattern(uint64_t address, size_t size,
+    size_t packet_size, TrafficGeneratorSync *sync, const TrafficGeneratorPattern *pattern,
+    bool do_write)
+{
+    TrafficGeneratorConfig config = { .is_start=true, .address=address, .size=size,
+        .packet_size=packet_size, .sync=sync, .do_write=do_write,
+        .check=false, .pattern=pattern
+    };
+    this->sync(&config);
+}
+
 inline void TrafficGeneratorConfigMaster::get_result(bool *check_status, int64_t *duration)
 {
     TrafficGeneratorConfig config = { .is_start=false };
@@ -20,14 +20,25 @@
  * io_v2 on the output port: IO_REQ_DONE/GRANTED/DENIED, retry() handshake,
  * no arg-stack. The control wire interface is identical to v1 and reuses the
  * v1 TrafficGenerator* types from generator.hpp (which does not include io.hpp).
+ *
+ * On top of v1, the address of each packet is produced by a pattern (linear,
+ * random, strided, hot-spot or trace replay, see TrafficGeneratorPatternKind),
+ * the number of outstanding requests can be set per transfer, and the latency
+ * of every request of the transfer phase is accounted in a histogram exported
+ * as stats (latency, latency_p50/p90/p99, latency_hist).
  */
 
+#include <algorithm>
 #include <cstring>
+#include <cstdio>
 #include <stdexcept>
+#include <string>
+#include <vector>
 #include <vp/vp.hpp>
 #include <vp/signal.hpp>
 #include <vp/itf/io_v2.hpp>
 #include <vp/queue.hpp>
+#include <vp/stats/stats.hpp>
 #include "interco/traffic/generator.hpp"
 
 class TransferV2
@@ -38,6 +49,158 @@ public:
     bool do_write;
     size_t packet_size;
     uint8_t *data;
+    // Only the requests of the transfer phase are accounted in the latency stats,
+    // not the ones of the pre/post check phases.
+    bool measure;
+};
+
+// Requests are allocated by the generator, which lets it stamp the issue cycle
+// on each of them to compute the request latency on completion.
+class GeneratorReq : public vp::IoReq
+{
+public:
+    // Cycle at which the request was first sent, -1 if not accounted.
+    int64_t issue_cycle = -1;
+};
+
+// Log-linear latency histogram: values below 16 cycles get one bucket each, then
+// each power of two is split into 8 sub-buckets, which bounds the percentile
+// error to 12.5% whatever the latency range while keeping a fixed size.
+class StatLatencyHistogram : public vp::StatCommon
+{
+public:
+    static constexpr int SUB_BUCKETS_LOG2 = 3;
+    static constexpr int LINEAR_LIMIT = 16;
+    static constexpr int NB_BUCKETS = LINEAR_LIMIT + (64 - 4) * (1 << SUB_BUCKETS_LOG2);
+
+    inline void account(int64_t cycles)
+    {
+        if (cycles < 0) cycles = 0;
+        if (this->count == 0 || cycles < this->min) this->min = cycles;
+        if (this->count == 0 || cycles > this->max) this->max = cycles;
+        this->total += cycles;
+        this->count++;
+        this->buckets[bucket_index(cycles)]++;
+    }
+
+    // Upper bound of the bucket containing the requested percentile (0 to 100),
+    // clamped to the maximum value seen.
+    int64_t percentile(double pct) const
+    {
+        if (this->count == 0) return 0;
+        uint64_t target = (uint64_t)((pct / 100.0) * (double)this->count + 0.5);
+        if (target == 0) target = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < NB_BUCKETS; i++)
+        {
+            seen += this->buckets[i];
+            if (seen >= target)
+            {
+                return std::min(bucket_upper(i), this->max);
+            }
+        }
+        return this->max;
+    }
+
+    std::string format_value(bool raw) const override
+    {
+        double avg = this->count ? (double)this->total / (double)this->count : 0.0;
+        char buf[128];
+        if (raw)
+        {
+            snprintf(buf, sizeof(buf), "%f", avg);
+        }
+        else
+        {
+            snprintf(buf, sizeof(buf), "%.2f cyc  (n=%llu, min=%lld, max=%lld)",
+                avg, (unsigned long long)this->count,
+                (long long)(this->count ? this->min : 0),
+                (long long)(this->count ? this->max : 0));
+        }
+        return buf;
+    }
+
+    // Non-empty buckets as "upper_bound:count" pairs, lowest first.
+    std::string format_buckets() const
+    {
+        std::string result;
+        for (int i = 0; i < NB_BUCKETS; i++)
+        {
+            if (this->buckets[i] == 0) continue;
+            if (!result.empty()) result += " ";
+            result += std::to_string(bucket_upper(i)) + ":" + std::to_string(this->buckets[i]);
+        }
+        return result;
+    }
+
+    void reset() override
+    {
+        this->count = 0; this->total = 0; this->min = 0; this->max = 0;
+        std::fill(std::begin(this->buckets), std::end(this->buckets), 0);
+    }
+
+private:
+    static inline int bucket_index(int64_t value)
+    {
+        if (value < LINEAR_LIMIT) return (int)value;
+        int msb = 63 - __builtin_clzll((uint64_t)value);
+        int sub = (int)(value >> (msb - SUB_BUCKETS_LOG2)) & ((1 << SUB_BUCKETS_LOG2) - 1);
+        return LINEAR_LIMIT + ((msb - 4) << SUB_BUCKETS_LOG2) + sub;
+    }
+
+    static inline int64_t bucket_upper(int index)
+    {
+        if (index < LINEAR_LIMIT) return index;
+        int msb = ((index - LINEAR_LIMIT) >> SUB_BUCKETS_LOG2) + 4;
+        int sub = (index - LINEAR_LIMIT) & ((1 << SUB_BUCKETS_LOG2) - 1);
+        int shift = msb - SUB_BUCKETS_LOG2;
+        return ((((int64_t)(1 << SUB_BUCKETS_LOG2) + sub + 1)) << shift) - 1;
+    }
+
+    uint64_t count = 0;
+    uint64_t total = 0;
+    int64_t min = 0;
+    int64_t max = 0;
+    uint64_t buckets[NB_BUCKETS] = {};
+};
+
+// Derived statistic: one percentile of a latency histogram, computed at dump time.
+class StatLatencyPercentile : public vp::StatCommon
+{
+public:
+    StatLatencyPercentile(StatLatencyHistogram *histogram, double pct)
+        : histogram(histogram), pct(pct) {}
+
+    std::string format_value(bool raw) const override
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), raw ? "%lld" : "%lld cyc",
+            (long long)this->histogram->percentile(this->pct));
+        return buf;
+    }
+
+    void reset() override {}
+
+private:
+    StatLatencyHistogram *histogram;
+    double pct;
+};
+
+// Derived statistic: bucket dump of a latency histogram.
+class StatLatencyBuckets : public vp::StatCommon
+{
+public:
+    StatLatencyBuckets(StatLatencyHistogram *histogram) : histogram(histogram) {}
+
+    std::string format_value(bool raw) const override
+    {
+        return this->histogram->format_buckets();
+    }
+
+    void reset() override {}
+
+private:
+    StatLatencyHistogram *histogram;
 };
 
 class GeneratorV2 : public vp::Component, TrafficGenerator
@@ -59,6 +222,11 @@ private:
     void handle_end();
     void close_transfer();
     void try_send(vp::IoReq *req);
+    void set_pattern(const TrafficGeneratorPattern *pattern, uint64_t size);
+    uint64_t next_address(TransferV2 *transfer);
+    uint64_t rand_next();
+    void alloc_reqs(int nb_reqs);
+    void free_all_reqs();
 
     vp::Trace trace;
 
@@ -106,8 +274,42 @@ private:
     bool sync_step1_done = false;
     bool sync_step2_done = false;
     bool sync_step3_done = false;
+
+    // Pattern configured on the component, used when the start command does not
+    // provide one.
+    TrafficGeneratorPattern default_pattern;
+    std::string default_trace_file;
+    // Pattern of the current start command, with defaults resolved.
+    TrafficGeneratorPattern pattern;
+    uint64_t rand_state;
+    // Index of the next packet in the current transfer, used by linear, strided
+    // and trace patterns.
+    uint64_t packet_index;
+    // Addresses of the trace pattern, loaded once per trace file.
+    std::vector<uint64_t> trace_addresses;
+    std::string trace_addresses_file;
+    // Number of requests currently allocated in free_reqs, which is the number of
+    // outstanding requests allowed for the current start command.
+    int nb_allocated_reqs = 0;
+
+    StatLatencyHistogram stat_latency;
+    StatLatencyPercentile stat_latency_p50{&stat_latency, 50.0};
+    StatLatencyPercentile stat_latency_p90{&stat_latency, 90.0};
+    StatLatencyPercentile stat_latency_p99{&stat_latency, 99.0};
+    StatLatencyBuckets stat_latency_hist{&stat_latency};
+    vp::StatScalar stat_reqs;
+    vp::StatScalar stat_denied;
 };
 
+static TrafficGeneratorPatternKind pattern_from_name(const std::string &name)
+{
+    if (name == "random") return TRAFFIC_PATTERN_RANDOM;
+    if (name == "strided") return TRAFFIC_PATTERN_STRIDED;
+    if (name == "hotspot") return TRAFFIC_PATTERN_HOTSPOT;
+    if (name == "trace") return TRAFFIC_PATTERN_TRACE;
+    return TRAFFIC_PATTERN_LINEAR;
+}
+
 GeneratorV2::GeneratorV2(vp::ComponentConf &config)
     : vp::Component(config),
       output_itf(&GeneratorV2::retry_meth, &GeneratorV2::response),
@@ -127,13 +329,144 @@ GeneratorV2::GeneratorV2(vp::ComponentConf &config)
     this->control_itf.set_sync_meth(&GeneratorV2::control_sync);
     this->new_slave_port("control", &this->control_itf);
 
-    this->nb_pending_reqs = this->get_js_config()->get_int("nb_pending_reqs");
+    js::Config *config = this->get_js_config();
+    this->nb_pending_reqs = config->get_int("nb_pending_reqs");
+
+    this->default_pattern = {};
+    this->default_pattern.kind = pattern_from_name(config->get_child_str("pattern"));
+    this->default_pattern.window = config->get_child_int("window");
+    this->default_pattern.stride = config->get_child_int("stride");
+    this->default_pattern.hotspot_base = config->get_child_int("hotspot_base");
+    this->default_pattern.hotspot_size = config->get_child_int("hotspot_size");
+    this->default_pattern.hotspot_ratio = config->get_child_int("hotspot_ratio");
+    this->default_pattern.seed = config->get_child_int("seed");
+    this->default_pattern.nb_outstanding = this->nb_pending_reqs;
+    this->default_trace_file = config->get_child_str("trace_file");
+    this->default_pattern.trace_file = this->default_trace_file.c_str();
+
+    this->stats.register_stat(&this->stat_reqs, "reqs", "Number of requests sent");
+    this->stats.register_stat(&this->stat_denied, "denied", "Number of denied requests");
+    this->stats.register_stat(&this->stat_latency, "latency",
+        "Average request latency in cycles during the transfer phase");
+    this->stats.register_stat(&this->stat_latency_p50, "latency_p50", "Median request latency");
+    this->stats.register_stat(&this->stat_latency_p90, "latency_p90",
+        "90th percentile of the request latency");
+    this->stats.register_stat(&this->stat_latency_p99, "latency_p99",
+        "99th percentile of the request latency");
+    this->stats.register_stat(&this->stat_latency_hist, "latency_hist",
+        "Request latency histogram, as bucket_upper_bound:count pairs");
 }
 
 GeneratorV2::~GeneratorV2()
 {
 }
 
+void GeneratorV2::set_pattern(const TrafficGeneratorPattern *pattern, uint64_t size)
+{
+    this->pattern = pattern ? *pattern : this->default_pattern;
+
+    if (this->pattern.window == 0) this->pattern.window = size;
+    if (this->pattern.stride == 0) this->pattern.stride = this->packet_size;
+    if (this->pattern.nb_outstanding <= 0) this->pattern.nb_outstanding = this->nb_pending_reqs;
+    if (this->pattern.hotspot_size < this->packet_size)
+    {
+        this->pattern.hotspot_size = this->packet_size;
+    }
+    if (this->pattern.window < this->packet_size)
+    {
+        this->pattern.window = this->packet_size;
+    }
+    this->rand_state = this->pattern.seed ? this->pattern.seed : 1;
+    this->packet_index = 0;
+
+    if (this->pattern.kind == TRAFFIC_PATTERN_TRACE)
+    {
+        std::string path = this->pattern.trace_file ? this->pattern.trace_file : "";
+        if (path != this->trace_addresses_file)
+        {
+            FILE *file = fopen(path.c_str(), "rb");
+            if (file == NULL)
+            {
+                this->trace.fatal("Unable to open trace file (path: %s)\n", path.c_str());
+                return;
+            }
+            this->trace_addresses.clear();
+            uint64_t addr;
+            while (fread(&addr, sizeof(addr), 1, file) == 1)
+            {
+                this->trace_addresses.push_back(addr);
+            }
+            fclose(file);
+            this->trace_addresses_file = path;
+        }
+
+        if (this->trace_addresses.size() == 0)
+        {
+            this->trace.fatal("Trace file does not contain any address (path: %s)\n",
+                path.c_str());
+        }
+    }
+}
+
+uint64_t GeneratorV2::rand_next()
+{
+    // xorshift64*, seeded per start command so that runs are reproducible.
+    this->rand_state ^= this->rand_state >> 12;
+    this->rand_state ^= this->rand_state << 25;
+    this->rand_state ^= this->rand_state >> 27;
+    return this->rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+uint64_t GeneratorV2::next_address(TransferV2 *transfer)
+{
+    uint64_t index = this->packet_index++;
+    uint64_t packet_size = transfer->packet_size;
+
+    switch (this->pattern.kind)
+    {
+        case TRAFFIC_PATTERN_RANDOM:
+            return transfer->address +
+                (this->rand_next() % (this->pattern.window / packet_size)) * packet_size;
+
+        case TRAFFIC_PATTERN_STRIDED:
+            return transfer->address + (index * this->pattern.stride) % this->pattern.window;
+
+        case TRAFFIC_PATTERN_HOTSPOT:
+            if ((int)(this->rand_next() % 100) < this->pattern.hotspot_ratio)
+            {
+                return this->pattern.hotspot_base +
+                    (this->rand_next() % (this->pattern.hotspot_size / packet_size)) * packet_size;
+            }
+            return transfer->address +
+                (this->rand_next() % (this->pattern.window / packet_size)) * packet_size;
+
+        case TRAFFIC_PATTERN_TRACE:
+            return this->trace_addresses[index % this->trace_addresses.size()];
+
+        default:
+            return transfer->address + index * packet_size;
+    }
+}
+
+void GeneratorV2::alloc_reqs(int nb_reqs)
+{
+    for (int i = 0; i < nb_reqs; i++)
+    {
+        this->free_reqs.push_back(new GeneratorReq());
+    }
+    this->nb_allocated_reqs = nb_reqs;
+}
+
+void GeneratorV2::free_all_reqs()
+{
+    for (int i = 0; i < this->nb_allocated_reqs; i++)
+    {
+        GeneratorReq *req = (GeneratorReq *)this->free_reqs.pop();
+        delete req;
+    }
+    this->nb_allocated_reqs = 0;
+}
+
 void GeneratorV2::start_transfer()
 {
     this->handle_step();
@@ -188,12 +521,14 @@ void GeneratorV2::control_sync(vp::Block *__this, TrafficGeneratorConfig *config
         _this->config_address = config->address;
         _this->packet_size = config->packet_size;
 
-        for (int i = 0; i < _this->nb_pending_reqs; i++)
+        _this->set_pattern(config->pattern, config->size);
+        if (_this->check && _this->pattern.kind != TRAFFIC_PATTERN_LINEAR)
         {
-            vp::IoReq *req = new vp::IoReq();
-            _this->free_reqs.push_back(req);
+            _this->trace.fatal("Checking is only supported with the linear pattern\n");
         }
 
+        _this->alloc_reqs(_this->pattern.nb_outstanding);
+
         if (config->check)
         {
             _this->ref_data = new uint8_t[config->size];
@@ -223,7 +558,7 @@ void GeneratorV2::handle_step()
                 memcpy(data, this->ref_data, this->config_size);
                 this->transfers.push(new TransferV2(
                     {this->config_address, this->config_size, !this->check_write, this->packet_size,
-                       data}));
+                       data, false}));
                 this->fsm_event.enqueue();
                 this->step++;
             }
@@ -318,7 +653,8 @@ void GeneratorV2::handle_transfer()
     this->close_transfer();
 
     this->transfers.push(new TransferV2(
-        {this->config_address, this->config_size, this->check_write, this->packet_size, data}));
+        {this->config_address, this->config_size, this->check_write, this->packet_size, data,
+            true}));
     this->fsm_event.enqueue();
 }
 
@@ -326,13 +662,22 @@ void GeneratorV2::handle_post_transfer()
 {
     this->duration = this->clock.get_cycles() - this->start_cycles;
 
+    this->trace.msg(vp::Trace::LEVEL_DEBUG,
+        "Transfer latency (latency: %s, p50: %lld, p90: %lld, p99: %lld, hist: %s)\n",
+        this->stat_latency.format_value(false).c_str(),
+        (long long)this->stat_latency.percentile(50.0),
+        (long long)this->stat_latency.percentile(90.0),
+        (long long)this->stat_latency.percentile(99.0),
+        this->stat_latency.format_buckets().c_str());
+
     if (this->check && this->check_write)
     {
         this->close_transfer();
 
         uint8_t *data = new uint8_t[this->config_size];
         this->transfers.push(new TransferV2(
-            {this->config_address, this->config_size, !this->check_write, this->packet_size, data}));
+            {this->config_address, this->config_size, !this->check_write, this->packet_size, data,
+                false}));
         this->fsm_event.enqueue();
     }
 }
@@ -345,11 +690,7 @@ void GeneratorV2::handle_end()
             this->current_transfer->size) != 0;
     }
 
-    for (int i = 0; i < this->nb_pending_reqs; i++)
-    {
-        vp::IoReq *req = (vp::IoReq *)this->free_reqs.pop();
-        delete req;
-    }
+    this->free_all_reqs();
 
     this->close_transfer();
     this->busy = false;
@@ -376,6 +717,7 @@ void GeneratorV2::try_send(vp::IoReq *req)
     if (status == vp::IO_REQ_DENIED)
     {
         // v2 deny: hold the req; we'll resend on retry().
+        this->stat_denied++;
         this->stalled = true;
         this->stalled_req = req;
     }
@@ -400,32 +742,37 @@ void GeneratorV2::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
         _this->transfers.pop();
         _this->size = _this->current_transfer->size;
         _this->pending_size = _this->current_transfer->size;
-        _this->address = _this->current_transfer->address;
         _this->data = _this->current_transfer->data;
+        _this->packet_index = 0;
     }
 
     if (!_this->stalled && _this->size > 0 && !_this->free_reqs.empty())
     {
-        vp::IoReq *req = (vp::IoReq *)_this->free_reqs.pop();
+        GeneratorReq *req = (GeneratorReq *)_this->free_reqs.pop();
 
         req->prepare();
 
+        _this->address = _this->next_address(_this->current_transfer);
+
         req->set_size(_this->current_transfer->packet_size);
         req->set_addr(_this->address);
         req->set_data(_this->data);
         req->set_is_write(_this->current_transfer->do_write);
+        req->issue_cycle = _this->current_transfer->measure ? _this->clock.get_cycles() : -1;
+        _this->stat_reqs++;
 
         _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Sending request (req: %p, address: 0x%llx, size: 0x%llx, packet_size: 0x%llx)\n",
             req, _this->address, _this->current_transfer->packet_size, _this->current_transfer->packet_size);
 
-        _this->address += _this->current_transfer->packet_size;
+        // The data buffer is always walked linearly, only the address depends on
+        // the pattern.
         _this->data += _this->current_transfer->packet_size;
         _this->size -= _this->current_transfer->packet_size;
 
         _this->try_send(req);
     }
 
-    if (_this->pending_size == 0 && _this->free_reqs.size() == _this->nb_pending_reqs &&
+    if (_this->pending_size == 0 && _this->free_reqs.size() == _this->nb_allocated_reqs &&
             _this->last_req_cyclestamp <= _this->clock.get_cycles())
     {
         _this->handle_step();
@@ -439,6 +786,15 @@ void GeneratorV2::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
 
 void GeneratorV2::handle_req_end(vp::IoReq *req, int64_t latency)
 {
+    GeneratorReq *gen_req = (GeneratorReq *)req;
+    if (gen_req->issue_cycle >= 0)
+    {
+        // Latency seen by the generator, from the first send attempt to the end of
+        // the request, including the cycles it stayed denied.
+        this->stat_latency.account(this->clock.get_cycles() + req->get_latency()
+            - gen_req->issue_cycle);
+    }
+
     this->pending_size -= req->get_size();
     this->trace.msg(vp::Trace::LEVEL_DEBUG, "Handling req end (req: %p, size: 0x%x, pending_size: 0x%x, latency: %ld)\n",
         req, req->get_size(), this->pending_size.get(), latency);
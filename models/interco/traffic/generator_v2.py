@@ -18,13 +18,49 @@ import gvsoc.systree
 
 
 class GeneratorV2(gvsoc.systree.Component):
-    """v2 traffic generator (io_v2 output)."""
+    """v2 traffic generator (io_v2 output).
 
-    def __init__(self, parent, name, nb_pending_reqs=64):
+    The transfer is still started through the control interface, but the
+    address of each packet follows ``pattern``:
+
+    - ``'linear'`` (default): sweep the transfer in ``packet_size`` chunks.
+    - ``'random'``: uniformly random packet-aligned addresses in
+      ``[address, address + window)``.
+    - ``'strided'``: ``address + (n * stride) % window`` for the n-th packet.
+    - ``'hotspot'``: ``hotspot_ratio`` percent of the packets go to random
+      addresses in ``[hotspot_base, hotspot_base + hotspot_size)``, the others
+      are random within the window.
+    - ``'trace'``: addresses replayed in order from ``trace_file``, a binary
+      file of native 64-bit words, wrapping around at its end.
+
+    ``window`` defaults to the transfer size and ``stride`` to the packet size.
+    ``nb_pending_reqs`` is the number of outstanding requests. The latency of
+    each request of the transfer phase is reported in the ``latency``,
+    ``latency_p50``, ``latency_p90``, ``latency_p99`` and ``latency_hist``
+    stats.
+    """
+
+    def __init__(self, parent, name, nb_pending_reqs=64, pattern='linear', window=0,
+            stride=0, hotspot_base=0, hotspot_size=0, hotspot_ratio=0, trace_file=None,
+            seed=1):
 
         super().__init__(parent, name)
 
+        if pattern not in ['linear', 'random', 'strided', 'hotspot', 'trace']:
+            raise ValueError(f'Unknown traffic pattern: {pattern}')
+
+        if pattern == 'trace' and trace_file is None:
+            raise ValueError('The trace pattern needs a trace_file')
+
         self.add_property('nb_pending_reqs', nb_pending_reqs)
+        self.add_property('pattern', pattern)
+        self.add_property('window', window)
+        self.add_property('stride', stride)
+        self.add_property('hotspot_base', hotspot_base)
+        self.add_property('hotspot_size', hotspot_size)
+        self.add_property('hotspot_ratio', hotspot_ratio)
+        self.add_property('trace_file', trace_file if trace_file is not None else '')
+        self.add_property('seed', seed)
 
         self.add_sources(['interco/traffic/generator_v2.cpp'])
 
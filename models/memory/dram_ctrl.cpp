@@ -0,0 +1,532 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * Native DRAM controller model on the io_v2 protocol.
+ *
+ * A bank / row-buffer timing model meant as a light alternative to the
+ * DRAMSys wrappers: no SystemC, no external library, and no event per DRAM
+ * clock cycle. The data itself lives in a flat backing store, only the
+ * timing is modelled.
+ *
+ * Organization: ``nb_channels`` independent channels, each with
+ * ``nb_ranks`` ranks of ``nb_banks`` banks. Addresses are decoded
+ * row:rank:bank:channel:column, the column being the offset in a row of
+ * ``row_size`` bytes, so consecutive rows go to different channels first,
+ * then to different banks.
+ *
+ * Per channel, incoming requests wait in a queue of ``queue_size`` entries
+ * (a full queue denies the request, retry() is sent when an entry frees
+ * up). The scheduler is FR-FCFS: it picks the oldest request hitting an
+ * open row, or the oldest request if there is none. The chosen request is
+ * then timed in one go from the state of its bank and of the data bus:
+ *
+ *   row hit       col = max(now, bank.col_ready)
+ *   closed bank   act = max(now, bank.act_ready)                  col = act + tRCD
+ *   row conflict  pre = max(now, bank.act + tRAS, bank.col_ready)
+ *                 act = pre + tRP                                 col = act + tRCD
+ *   data          start = max(col + tCAS, bus_free)   end = start + bursts * tBurst
+ *
+ * With the closed-page policy, the row is precharged right after the
+ * access (auto-precharge), otherwise it stays open until a conflict or a
+ * refresh. Refresh is applied lazily per rank when the scheduler runs: every
+ * elapsed tREFI interval closes all rows of the rank and blocks activations
+ * for tRFC cycles.
+ *
+ * Events: one ClockEvent per channel, armed only on command boundaries, i.e.
+ * the next scheduling decision (the previous column command) and the end of
+ * the oldest data transfer, at which point the request is answered with
+ * resp(). Data transfers on a channel are serialized on its bus, so requests
+ * complete in scheduling order and the in-flight list is a FIFO.
+ *
+ * Simplifications: a request is timed as a single access to the row of its
+ * first byte (masters and routers split at burst or line granularity), there
+ * is no write buffer nor read/write turnaround, and no bank group or
+ * tFAW / tRRD constraint.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <vp/vp.hpp>
+#include <vp/itf/io_v2.hpp>
+#include <vp/stats/stats.hpp>
+#include <vp/debug_mem.hpp>
+#include <memory/dram_ctrl/dram_ctrl_config.hpp>
+#include <utils/ring_buffer.hpp>
+#include <utils/host_profiler.hpp>
+
+class DramCtrl;
+
+struct Bank
+{
+    // Open row, -1 when the bank is precharged
+    int64_t open_row = -1;
+    // Cycle of the last activation, for tRAS
+    int64_t act_cycle = 0;
+    // Earliest cycle for the next activation (after precharge or refresh)
+    int64_t act_ready = 0;
+    // Earliest cycle for the next column command on the open row
+    int64_t col_ready = 0;
+};
+
+struct Rank
+{
+    int64_t next_refresh = 0;
+};
+
+struct PendingReq
+{
+    vp::IoReq *req;
+    int bank;       // Index in Channel::banks (rank * nb_banks + bank)
+    int64_t row;
+};
+
+struct InFlightReq
+{
+    vp::IoReq *req;
+    int64_t done_cycle;
+};
+
+class Channel
+{
+public:
+    Channel(DramCtrl *top, int id);
+
+    DramCtrl *top;
+    int id;
+    std::vector<Bank> banks;
+    std::vector<Rank> ranks;
+    // Requests waiting for the scheduler, oldest first
+    std::vector<PendingReq> queue;
+    // Scheduled requests, in completion order
+    RingBuffer<InFlightReq> inflight;
+    // Cycle at which the data bus is free again
+    int64_t bus_free = 0;
+    // Earliest cycle of the next scheduling decision
+    int64_t next_sched_cycle = 0;
+    vp::ClockEvent event;
+    // Cycle the event is armed for, -1 if not armed
+    int64_t armed_cycle = -1;
+    // Set when a request was denied on the full queue, the input is retried
+    // once an entry of this channel frees up
+    bool input_needs_retry = false;
+};
+
+class DramCtrl : public vp::Component, public vp::DebugMemIf
+{
+    friend class Channel;
+
+public:
+    DramCtrl(vp::ComponentConf &config);
+
+    vp::DebugMemIf *debug_mem_if() override { return this; }
+    int debug_mem_access(uint64_t addr, uint8_t *data, uint64_t size,
+        bool is_write) override;
+
+    DramCtrlConfig cfg;
+
+private:
+    void reset(bool active) override;
+    void stop() override;
+
+    static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
+    static void channel_handler(vp::Block *__this, vp::ClockEvent *event);
+
+    // Apply the refreshes of the channel ranks elapsed at `now`
+    void refresh(Channel *ch, int64_t now);
+    // Pick the next request of the channel (FR-FCFS) and time it
+    void schedule(Channel *ch, int64_t now);
+    // Arm the channel event for its next command boundary
+    void arm(Channel *ch, int64_t now);
+
+    vp::Trace trace;
+    host_profiler::Counter *host_prof;
+    vp::IoSlave in{&DramCtrl::req};
+
+    std::vector<std::unique_ptr<Channel>> channels;
+
+    uint8_t *mem_data = nullptr;
+    uint64_t mapped_size = 0;
+
+    vp::StatScalar stat_reads;
+    vp::StatScalar stat_writes;
+    vp::StatScalar stat_bytes_read;
+    vp::StatScalar stat_bytes_written;
+    vp::StatBw stat_read_bw;
+    vp::StatBw stat_write_bw;
+    vp::StatScalar stat_row_hits;
+    vp::StatScalar stat_row_misses;
+    vp::StatScalar stat_row_conflicts;
+    vp::StatScalar stat_refreshes;
+};
+
+
+Channel::Channel(DramCtrl *top, int id)
+    : top(top), id(id),
+      banks(top->cfg.nb_ranks * top->cfg.nb_banks),
+      ranks(top->cfg.nb_ranks),
+      inflight(top->cfg.queue_size),
+      event(top, &DramCtrl::channel_handler)
+{
+    this->queue.reserve(top->cfg.queue_size);
+    // Stash a pointer to ourselves in the event so the handler can recover us.
+    this->event.get_args()[0] = this;
+}
+
+
+DramCtrl::DramCtrl(vp::ComponentConf &config)
+    : vp::Component(config, this->cfg)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->host_prof = host_profiler::counter(this->get_path(), "dram_ctrl");
+    this->new_slave_port("input", &this->in);
+
+    this->stats.register_stat(&this->stat_reads, "reads", "Number of read accesses");
+    this->stats.register_stat(&this->stat_writes, "writes", "Number of write accesses");
+    this->stats.register_stat(&this->stat_bytes_read, "bytes_read", "Total bytes read");
+    this->stats.register_stat(&this->stat_bytes_written, "bytes_written", "Total bytes written");
+    this->stats.register_stat(&this->stat_read_bw, "read_bandwidth", "Average read bandwidth");
+    this->stat_read_bw.set_source(&this->stat_bytes_read);
+    this->stats.register_stat(&this->stat_write_bw, "write_bandwidth", "Average write bandwidth");
+    this->stat_write_bw.set_source(&this->stat_bytes_written);
+    this->stats.register_stat(&this->stat_row_hits, "row_hits", "Accesses to an open row");
+    this->stats.register_stat(&this->stat_row_misses, "row_misses",
+        "Accesses to a precharged bank");
+    this->stats.register_stat(&this->stat_row_conflicts, "row_conflicts",
+        "Accesses to a bank with another row open");
+    this->stats.register_stat(&this->stat_refreshes, "refreshes", "Rank refreshes");
+
+    // They are all divisors of the address decoding or bounds of the queues
+    if (this->cfg.row_size <= 0 || this->cfg.burst_size <= 0 || this->cfg.nb_channels <= 0 ||
+        this->cfg.nb_ranks <= 0 || this->cfg.nb_banks <= 0 || this->cfg.queue_size <= 0)
+    {
+        this->trace.fatal("Invalid DRAM organization (row_size: %lld, burst_size: %lld, "
+            "channels: %d, ranks: %d, banks: %d, queue_size: %d)\n",
+            (long long)this->cfg.row_size, (long long)this->cfg.burst_size,
+            (int)this->cfg.nb_channels, (int)this->cfg.nb_ranks, (int)this->cfg.nb_banks,
+            (int)this->cfg.queue_size);
+        return;
+    }
+
+    for (int i = 0; i < this->cfg.nb_channels; i++)
+    {
+        this->channels.push_back(std::make_unique<Channel>(this, i));
+    }
+
+    // DRAMs are large and usually sparsely used, only reserve the address
+    // space, pages are committed on first write.
+    uint64_t page_size = sysconf(_SC_PAGESIZE);
+    this->mapped_size = (this->cfg.size + page_size - 1) & ~(page_size - 1);
+    void *data = mmap(NULL, this->mapped_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED) throw std::bad_alloc();
+    this->mem_data = (uint8_t *)data;
+
+    this->trace.msg("Building DRAM controller (size: 0x%llx, channels: %d, ranks: %d, banks: %d)\n",
+        (unsigned long long)this->cfg.size, this->cfg.nb_channels, this->cfg.nb_ranks,
+        this->cfg.nb_banks);
+}
+
+
+void DramCtrl::reset(bool active)
+{
+    if (active)
+    {
+        int64_t now = this->clock.get_cycles();
+        for (auto &ch : this->channels)
+        {
+            std::fill(ch->banks.begin(), ch->banks.end(), Bank());
+            for (Rank &rank : ch->ranks)
+            {
+                rank.next_refresh = now + this->cfg.t_refi;
+            }
+            ch->queue.clear();
+            ch->inflight.clear();
+            ch->bus_free = 0;
+            ch->next_sched_cycle = 0;
+            if (ch->armed_cycle != -1)
+            {
+                ch->event.cancel();
+                ch->armed_cycle = -1;
+            }
+            ch->input_needs_retry = false;
+        }
+    }
+}
+
+
+void DramCtrl::stop()
+{
+    if (this->mem_data != nullptr)
+    {
+        munmap(this->mem_data, this->mapped_size);
+        this->mem_data = nullptr;
+    }
+}
+
+
+vp::IoReqStatus DramCtrl::req(vp::Block *__this, vp::IoReq *req)
+{
+    DramCtrl *_this = (DramCtrl *)__this;
+    host_profiler::Scope prof(_this->host_prof);
+
+    uint64_t offset = req->get_addr();
+    uint64_t size = req->get_size();
+
+    _this->trace.msg(vp::Trace::LEVEL_DEBUG,
+        "Received IO req (req: %p, offset: 0x%llx, size: 0x%llx, is_write: %d)\n",
+        req, (unsigned long long)offset, (unsigned long long)size, req->get_is_write());
+
+    if (offset + size > (uint64_t)_this->cfg.size)
+    {
+        _this->trace.force_warning_no_error(
+            "Received out-of-bound request (reqAddr: 0x%llx, reqSize: 0x%llx, memSize: 0x%llx)\n",
+            (unsigned long long)offset, (unsigned long long)size,
+            (unsigned long long)_this->cfg.size);
+        req->set_resp_status(vp::IO_RESP_INVALID);
+        return vp::IO_REQ_DONE;
+    }
+
+    if (req->get_opcode() != vp::IoReqOpcode::READ && req->get_opcode() != vp::IoReqOpcode::WRITE)
+    {
+        _this->trace.force_warning("Received unsupported atomic operation\n");
+        req->set_resp_status(vp::IO_RESP_INVALID);
+        return vp::IO_REQ_DONE;
+    }
+
+    // row:rank:bank:channel:column
+    uint64_t unit = offset / _this->cfg.row_size;
+    Channel *ch = _this->channels[unit % _this->cfg.nb_channels].get();
+    unit /= _this->cfg.nb_channels;
+    int bank = unit % _this->cfg.nb_banks;
+    unit /= _this->cfg.nb_banks;
+    int rank = unit % _this->cfg.nb_ranks;
+    int64_t row = unit / _this->cfg.nb_ranks;
+
+    if ((int)ch->queue.size() >= _this->cfg.queue_size)
+    {
+        ch->input_needs_retry = true;
+        return vp::IO_REQ_DENIED;
+    }
+
+    req->set_resp_status(vp::IO_RESP_OK);
+    ch->queue.push_back(PendingReq{req, rank * _this->cfg.nb_banks + bank, row});
+
+    _this->arm(ch, _this->clock.get_cycles());
+
+    return vp::IO_REQ_GRANTED;
+}
+
+
+void DramCtrl::refresh(Channel *ch, int64_t now)
+{
+    if (this->cfg.t_refi <= 0) return;
+
+    for (int rank_id = 0; rank_id < this->cfg.nb_ranks; rank_id++)
+    {
+        Rank &rank = ch->ranks[rank_id];
+        if (now < rank.next_refresh) continue;
+
+        // Only the last elapsed refresh can still delay the banks, the
+        // previous ones are just accounted.
+        int64_t nb_refresh = (now - rank.next_refresh) / this->cfg.t_refi + 1;
+        int64_t last_refresh = rank.next_refresh + (nb_refresh - 1) * this->cfg.t_refi;
+        rank.next_refresh = last_refresh + this->cfg.t_refi;
+        this->stat_refreshes += nb_refresh;
+
+        this->trace.msg(vp::Trace::LEVEL_TRACE, "Refresh (channel: %d, rank: %d, cycle: %ld)\n",
+            ch->id, rank_id, last_refresh);
+
+        for (int i = 0; i < this->cfg.nb_banks; i++)
+        {
+            Bank &bank = ch->banks[rank_id * this->cfg.nb_banks + i];
+            bank.open_row = -1;
+            bank.act_ready = std::max(bank.act_ready, last_refresh + this->cfg.t_rfc);
+        }
+    }
+}
+
+
+void DramCtrl::schedule(Channel *ch, int64_t now)
+{
+    this->refresh(ch, now);
+
+    // FR-FCFS: oldest row hit first, otherwise oldest request
+    size_t index = 0;
+    for (size_t i = 0; i < ch->queue.size(); i++)
+    {
+        const PendingReq &pending = ch->queue[i];
+        if (ch->banks[pending.bank].open_row == pending.row)
+        {
+            index = i;
+            break;
+        }
+    }
+    PendingReq pending = ch->queue[index];
+    ch->queue.erase(ch->queue.begin() + index);
+
+    vp::IoReq *req = pending.req;
+    Bank &bank = ch->banks[pending.bank];
+    uint64_t offset = req->get_addr();
+    uint64_t size = req->get_size();
+    uint64_t column = offset % this->cfg.row_size;
+    int64_t nb_bursts = (column % this->cfg.burst_size + size + this->cfg.burst_size - 1) /
+        this->cfg.burst_size;
+    if (nb_bursts == 0) nb_bursts = 1;
+    int64_t transfer = nb_bursts * this->cfg.t_burst;
+
+    int64_t col;
+    if (bank.open_row == pending.row)
+    {
+        col = std::max(now, bank.col_ready);
+        this->stat_row_hits++;
+    }
+    else
+    {
+        int64_t act;
+        if (bank.open_row != -1)
+        {
+            int64_t pre = std::max({now, bank.act_cycle + this->cfg.t_ras, bank.col_ready});
+            act = pre + this->cfg.t_rp;
+            this->stat_row_conflicts++;
+        }
+        else
+        {
+            act = std::max(now, bank.act_ready);
+            this->stat_row_misses++;
+        }
+        bank.act_cycle = act;
+        col = act + this->cfg.t_rcd;
+    }
+
+    int64_t data_start = std::max(col + this->cfg.t_cas, ch->bus_free);
+    int64_t data_end = data_start + transfer;
+    ch->bus_free = data_end;
+
+    if (this->cfg.open_page)
+    {
+        bank.open_row = pending.row;
+        bank.col_ready = col + transfer;
+    }
+    else
+    {
+        bank.open_row = -1;
+        bank.act_ready = std::max(data_end, bank.act_cycle + this->cfg.t_ras) + this->cfg.t_rp;
+    }
+
+    // The next decision is taken once this column command is issued
+    ch->next_sched_cycle = std::max(now + 1, col);
+
+    this->trace.msg(vp::Trace::LEVEL_DEBUG,
+        "Scheduled req (req: %p, channel: %d, bank: %d, row: %ld, col_cycle: %ld, done_cycle: %ld)\n",
+        req, ch->id, pending.bank, pending.row, col, data_end);
+
+    uint8_t *data = req->get_data();
+    if (req->get_is_write())
+    {
+        this->stat_writes++;
+        this->stat_bytes_written += size;
+        if (data) memcpy(&this->mem_data[offset], data, size);
+    }
+    else
+    {
+        this->stat_reads++;
+        this->stat_bytes_read += size;
+        if (data) memcpy(data, &this->mem_data[offset], size);
+    }
+
+    ch->inflight.push_back(InFlightReq{req, data_end});
+}
+
+
+void DramCtrl::arm(Channel *ch, int64_t now)
+{
+    int64_t wake = -1;
+    if (!ch->inflight.empty())
+    {
+        wake = ch->inflight.front().done_cycle;
+    }
+    if (!ch->queue.empty())
+    {
+        int64_t sched = std::max(ch->next_sched_cycle, now + 1);
+        wake = wake == -1 ? sched : std::min(wake, sched);
+    }
+
+    if (wake == -1 || (ch->armed_cycle != -1 && ch->armed_cycle <= wake))
+    {
+        return;
+    }
+
+    if (ch->armed_cycle != -1)
+    {
+        ch->event.cancel();
+    }
+    ch->armed_cycle = wake;
+    ch->event.enqueue(std::max(wake - now, (int64_t)1));
+}
+
+
+void DramCtrl::channel_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    Channel *ch = (Channel *)event->get_args()[0];
+    DramCtrl *_this = ch->top;
+    host_profiler::Scope prof(_this->host_prof);
+    int64_t now = _this->clock.get_cycles();
+
+    ch->armed_cycle = -1;
+
+    if (!ch->queue.empty() && now >= ch->next_sched_cycle)
+    {
+        _this->schedule(ch, now);
+    }
+
+    // Requests whose data transfer is over
+    while (!ch->inflight.empty() && ch->inflight.front().done_cycle <= now)
+    {
+        vp::IoReq *req = ch->inflight.front().req;
+        ch->inflight.pop_front();
+        _this->in.resp(req);
+    }
+
+    _this->arm(ch, now);
+
+    if (ch->input_needs_retry && (int)ch->queue.size() < _this->cfg.queue_size)
+    {
+        ch->input_needs_retry = false;
+        _this->in.retry();
+    }
+}
+
+
+int DramCtrl::debug_mem_access(uint64_t addr, uint8_t *data, uint64_t size, bool is_write)
+{
+    if (addr + size > (uint64_t)this->cfg.size)
+    {
+        return -1;
+    }
+
+    if (is_write)
+    {
+        memcpy(&this->mem_data[addr], data, size);
+    }
+    else
+    {
+        memcpy(data, &this->mem_data[addr], size);
+    }
+
+    return 0;
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new DramCtrl(config);
+}
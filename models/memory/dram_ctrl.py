@@ -0,0 +1,221 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+"""Native DRAM controller model on io_v2.
+
+This module provides the ``DramCtrl`` generator (``dram_ctrl.cpp``), a
+bank / row-buffer DRAM timing model which does not need SystemC, and its
+configuration struct :class:`DramCtrlConfig`.
+"""
+
+from __future__ import annotations
+
+import gvsoc.systree
+from config_tree import Config, cfg_field, HasSize
+
+
+class DramCtrlConfig(Config, HasSize):
+    """Configuration for the ``DramCtrl`` generator.
+
+    Timings are in cycles of the controller clock.
+
+    Attributes
+    ----------
+    size: int
+        Memory size in bytes.
+    nb_channels: int
+        Number of independent channels.
+    nb_ranks: int
+        Number of ranks per channel.
+    nb_banks: int
+        Number of banks per rank.
+    row_size: int
+        Size in bytes of a row of one bank.
+    burst_size: int
+        Bytes moved on the data bus by one burst.
+    t_burst: int
+        Data bus cycles per burst.
+    open_page: bool
+        True to keep rows open after an access, False to precharge them
+        right away.
+    t_rcd: int
+        Activate to column command delay.
+    t_rp: int
+        Precharge duration.
+    t_cas: int
+        Column command to data delay.
+    t_ras: int
+        Minimum activate to precharge delay.
+    t_refi: int
+        Refresh interval, 0 to disable refresh.
+    t_rfc: int
+        Refresh duration.
+    queue_size: int
+        Number of requests queued per channel before denying new ones.
+    """
+
+    size: int = cfg_field(default=0, fmt="hex", dump=True, desc=(
+        "Memory size in bytes"
+    ))
+
+    nb_channels: int = cfg_field(default=1, dump=True, desc=(
+        "Number of independent channels"
+    ))
+
+    nb_ranks: int = cfg_field(default=1, dump=True, desc=(
+        "Number of ranks per channel"
+    ))
+
+    nb_banks: int = cfg_field(default=8, dump=True, desc=(
+        "Number of banks per rank"
+    ))
+
+    row_size: int = cfg_field(default=2048, dump=True, desc=(
+        "Size in bytes of a row of one bank"
+    ))
+
+    burst_size: int = cfg_field(default=64, dump=True, desc=(
+        "Bytes moved on the data bus by one burst"
+    ))
+
+    t_burst: int = cfg_field(default=4, dump=True, desc=(
+        "Data bus cycles per burst"
+    ))
+
+    open_page: bool = cfg_field(default=True, dump=True, desc=(
+        "Keep rows open after an access (open-page policy), otherwise precharge "
+        "them right away (closed-page policy)"
+    ))
+
+    t_rcd: int = cfg_field(default=14, dump=True, desc=(
+        "Activate to column command delay, in cycles"
+    ))
+
+    t_rp: int = cfg_field(default=14, dump=True, desc=(
+        "Precharge duration, in cycles"
+    ))
+
+    t_cas: int = cfg_field(default=14, dump=True, desc=(
+        "Column command to data delay, in cycles"
+    ))
+
+    t_ras: int = cfg_field(default=32, dump=True, desc=(
+        "Minimum delay between an activate and the precharge of the same bank, in cycles"
+    ))
+
+    t_refi: int = cfg_field(default=7800, dump=True, desc=(
+        "Refresh interval in cycles, 0 to disable refresh"
+    ))
+
+    t_rfc: int = cfg_field(default=350, dump=True, desc=(
+        "Refresh duration, in cycles"
+    ))
+
+    queue_size: int = cfg_field(default=16, dump=True, desc=(
+        "Number of requests queued per channel before denying new ones"
+    ))
+
+
+class DramCtrl(gvsoc.systree.Component):
+    """DRAM controller with a bank / row-buffer timing model.
+
+    Overview
+    ~~~~~~~~
+
+    A native alternative to :class:`memory.dramsys.Dramsys` for io_v2
+    systems. It models the timing that matters most for a DRAM seen
+    from the SoC — row hits, misses and conflicts, bank parallelism,
+    data bus occupancy and refresh — without SystemC and without an
+    event per DRAM cycle: the model only wakes up on command
+    boundaries (scheduling decisions and end of data transfers). The
+    data is kept in a flat, sparsely committed backing store.
+
+    Request flow
+    ~~~~~~~~~~~~
+
+    - **Decode**: the address is split as row:rank:bank:channel:column,
+      the column being the offset in a row of ``row_size`` bytes.
+    - **Queue**: the request goes to the queue of its channel and
+      ``IO_REQ_GRANTED`` is returned. When the queue holds
+      ``queue_size`` requests, ``IO_REQ_DENIED`` is returned instead
+      and ``retry()`` is sent once an entry is free.
+    - **Schedule (FR-FCFS)**: the channel picks the oldest request
+      hitting an open row, or the oldest one if there is none, and
+      computes its activate / column / data cycles from the state of
+      its bank and of the channel data bus. The next decision is taken
+      once the column command is issued.
+    - **Respond**: ``resp()`` is sent at the end of the data transfer.
+      The data is read or written in the backing store when the
+      request is scheduled.
+
+    Timing model
+    ~~~~~~~~~~~~
+
+    - Row hit: column command as soon as the bank accepts it.
+    - Closed bank: activate, then column command ``t_rcd`` later.
+    - Row conflict: precharge (not before ``t_ras`` after the
+      activate), activate ``t_rp`` later, then column command.
+    - Data: ``t_cas`` after the column command, once the bus is free,
+      for ``t_burst`` cycles per ``burst_size`` bytes.
+    - Closed-page policy (``open_page=False``): the row is precharged
+      right after each access.
+    - Refresh: every ``t_refi`` cycles, all rows of a rank are closed
+      and no activation can happen for ``t_rfc`` cycles.
+
+    Statistics: ``row_hits``, ``row_misses``, ``row_conflicts`` and
+    ``refreshes`` on top of the usual access counts and bandwidths.
+
+    Constraints and limitations
+    ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    - A request is timed as one access to the row of its first byte.
+      Requests are expected to be split upstream at burst or cache
+      line granularity.
+    - No write buffer, read/write turnaround, bank groups, tRRD or
+      tFAW.
+    - Atomics are refused with ``IO_RESP_INVALID``.
+
+    Example
+    ~~~~~~~
+
+    .. code-block:: python
+
+        ddr = DramCtrl(self, 'ddr', config=DramCtrlConfig(size=0x4000_0000,
+            nb_channels=2, nb_banks=8))
+        ico.o_MAP(ddr.i_INPUT(), RouterMapping(base=0x8000_0000, size=0x4000_0000))
+
+    Parameters
+    ----------
+    parent : Component
+        Parent component this controller is instantiated under.
+    name : str
+        Local name of the controller within ``parent``.
+    config : DramCtrlConfig
+        Full configuration.
+    """
+
+    __gvsoc_doc__ = {
+        'title': 'DRAM controller',
+        'tests_dirs': [
+            {'dir':       'gvsoc/core/tests/memory/dram_ctrl',
+             'component': 'memory.dram_ctrl'},
+        ],
+    }
+
+    def __init__(self, parent: gvsoc.systree.Component, name: str,
+                 config: DramCtrlConfig):
+        super().__init__(parent, name, config=config)
+
+        self.add_sources(['memory/dram_ctrl.cpp'])
+
+    def i_INPUT(self) -> gvsoc.systree.SlaveItf:
+        """Returns the io_v2 input port.
+
+        Requests are answered asynchronously with ``resp()`` at the end
+        of their data transfer, or denied when the queue of their
+        channel is full.
+        """
+        return gvsoc.systree.SlaveItf(self, 'input', signature='io_v2')
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * Memcheck buffer tracking shared by the memory models.
+ *
+ * Keeps the buffers declared through memcheck_alloc/memcheck_free in two
+ * forms:
+ *   - a packed shadow bitmap, one bit per byte, checked on every access on
+ *     whole 64-bit words (an aligned 8-byte access inside one word is a
+ *     single mask-and-compare);
+ *   - an interval map of the live buffers, used only when an access is
+ *     invalid, to report the closest buffer without scanning the bitmap.
+ *
+ * Offsets are in the memcheck space of the memory (its size times the
+ * expansion factor), as computed by the memory model.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <vector>
+
+class MemcheckShadow
+{
+public:
+    void init(uint64_t size)
+    {
+        this->size = size;
+        this->valid.assign((size + 63) / 64, 0);
+        this->buffers.clear();
+    }
+
+    bool is_enabled() const { return this->size != 0; }
+
+    uint64_t get_size() const { return this->size; }
+
+    // Declare [base, base + size) as a live buffer (enable) or release it.
+    void set_buffer(uint64_t base, uint64_t size, bool enable)
+    {
+        if (enable)
+        {
+            this->buffers[base] = size;
+        }
+        else
+        {
+            this->buffers.erase(base);
+        }
+
+        uint64_t end = base + size;
+        while (base < end)
+        {
+            uint64_t bit = base & 63;
+            uint64_t nb_bits = std::min<uint64_t>(64 - bit, end - base);
+            uint64_t mask = word_mask(bit, nb_bits);
+            if (enable)
+            {
+                this->valid[base >> 6] |= mask;
+            }
+            else
+            {
+                this->valid[base >> 6] &= ~mask;
+            }
+            base += nb_bits;
+        }
+    }
+
+    // Check that [offset, offset + size) is fully inside live buffers. If
+    // not, `invalid_offset` is set to the first invalid byte.
+    inline bool check(uint64_t offset, uint64_t size, uint64_t &invalid_offset) const
+    {
+        uint64_t end = offset + size;
+        while (offset < end)
+        {
+            uint64_t bit = offset & 63;
+            uint64_t nb_bits = std::min<uint64_t>(64 - bit, end - offset);
+            uint64_t mask = word_mask(bit, nb_bits);
+            uint64_t invalid = ~this->valid[offset >> 6] & mask;
+            if (invalid)
+            {
+                invalid_offset = (offset & ~(uint64_t)63) + __builtin_ctzll(invalid);
+                return false;
+            }
+            offset += nb_bits;
+        }
+        return true;
+    }
+
+    // Find the live buffer closest to `offset`. `distance` is 0 when there
+    // is no buffer at all. On a tie, the buffer before the offset wins.
+    void find_closest_buffer(uint64_t offset, uint64_t &distance,
+        uint64_t &buffer_offset, uint64_t &buffer_size) const
+    {
+        uint64_t distance_before = 0, distance_after = 0;
+        auto after = this->buffers.upper_bound(offset);
+
+        if (after != this->buffers.begin())
+        {
+            auto before = std::prev(after);
+            uint64_t last = before->first + before->second - 1;
+            if (before->second != 0 && last < offset)
+            {
+                distance_before = offset - last;
+            }
+        }
+
+        if (after != this->buffers.end())
+        {
+            distance_after = after->first - offset;
+        }
+
+        if (distance_before == 0 && distance_after == 0)
+        {
+            distance = 0;
+            return;
+        }
+
+        if (distance_before == 0 || (distance_after != 0 && distance_after < distance_before))
+        {
+            distance = distance_after;
+            buffer_offset = after->first;
+            buffer_size = after->second;
+        }
+        else
+        {
+            auto before = std::prev(after);
+            distance = distance_before;
+            buffer_offset = before->first;
+            buffer_size = before->second;
+        }
+    }
+
+private:
+    static inline uint64_t word_mask(uint64_t bit, uint64_t nb_bits)
+    {
+        return (nb_bits == 64 ? ~(uint64_t)0 : (((uint64_t)1 << nb_bits) - 1)) << bit;
+    }
+
+    uint64_t size = 0;
+    std::vector<uint64_t> valid;
+    // Live buffers, start offset -> size
+    std::map<uint64_t, uint64_t> buffers;
+};
@@ -6,8 +6,8 @@
 //
 // io_v2 port of the ``memory_v2`` SRAM model.
 //
-// Functionally identical to memory_v2.cpp minus the memcheck
-// bookkeeping and the bandwidth model: configurable-size
+// Functionally identical to memory_v2.cpp minus the memcheck data
+// sideband and the bandwidth model: configurable-size
 // byte-addressable store, fixed per-request latency, optional RISC-V
 // atomics, preload-from-file, and a ``power_ctrl`` wire to gate the
 // backing store.
@@ -18,11 +18,11 @@
 //   - Completion status is ``IO_REQ_DONE`` (never ``GRANTED`` /
 //     ``DENIED`` — memory never stalls), with ``IO_RESP_OK`` /
 //     ``IO_RESP_INVALID`` on the response-status sideband.
-//   - Timing is a single fixed latency annotated via
+//   - Timing is a fixed latency annotated via
 //     ``req->inc_latency(cfg.latency)``, read inline by the master
-//     under the IoV2Sync contract. The v2 per-byte bandwidth model
-//     (``width_log2`` / ``set_duration``) is not reproduced; place a
-//     shaper (e.g. interco.limiter_v2.Limiter) upstream if needed.
+//     under the IoV2Sync contract. The v2 per-byte bandwidth model is
+//     replaced by an optional banked timing policy (see below), compiled
+//     in only when ``width`` or ``nb_banks`` is set.
 //   - ``req->is_debug()`` is gone; every access goes through the full
 //     timing path.
 //   - ``req->get_initiator()`` returns ``void *`` instead of ``int``;
@@ -31,28 +31,134 @@
 //     atomics, ...) is read exclusively from the compiled
 //     :class:`MemoryV3Config` struct. The model reads zero entries via
 //     ``get_js_config()``.
-//   - Memcheck bookkeeping is entirely dropped. v1 / v2 carried a
-//     shadow buffer, an allocator wire port, and a per-request memcheck
-//     sideband; none of that is reproduced here. v3 is a plain backing
-//     store. Use :class:`memory.memory_v2.Memory` when memcheck
-//     integration is needed.
+//   - Memcheck keeps only the buffer tracking: the allocator wire port
+//     and the shadow of live buffers (see memcheck_shadow.hpp), so that
+//     accesses outside the buffers are reported and answered with
+//     ``IO_RESP_INVALID``. io_v2 requests carry no memcheck sideband,
+//     so the per-byte initialized-data tracking of v2 is not
+//     reproduced.
 //   - Power-source instantiation is dropped. The v2 model pulled
 //     per-access energy tables out of the JSON tree
 //     (``**/read_8`` etc.); in the config-only port those energy
 //     tables would have to be promoted into the struct too, which is
 //     out of scope. The ``power_trigger`` start/stop-capture feature
 //     still works because it only looks at magic payload values.
+//
+// Backing store: heap-allocated by default. With ``sparse`` the full
+// size is only reserved as address space (anonymous MAP_NORESERVE
+// mapping); host pages are committed by the kernel on first write and
+// untouched ones read as zero. The store stays one contiguous array, so
+// the backdoor (debug_mem_access) and the meminfo pointer work the same
+// in both modes. The ``resident_bytes`` stat reports how much of it is
+// actually committed.
+//
+// With ``stim_mmap`` the stim file is not copied but mapped MAP_PRIVATE
+// over the start of such a reservation: simulations preloading the same
+// image share its pages through the page cache, and a page is only
+// copied when the guest writes to it.
+//
+// Timing policy: the request handler is a template on the timing policy,
+// selected at compile time with CONFIG_MEMORY_TIMING (added by the
+// generator when ``width`` or ``nb_banks`` is set). The default policy
+// compiles down to the fixed-latency path. The banked one splits the
+// memory into ``nb_banks`` banks interleaved on 2^bank_interleaving_bits
+// bytes, each serving ``width`` bytes per cycle: an access occupies the
+// banks it covers for ceil(size / width) cycles (set_duration), and waits
+// (added to the latency) until all of them are free.
+//
+// Snapshots: snapshot() marks the current content as a restore point and
+// restore() brings the memory back to it. Once a snapshot exists, the
+// first write to a page since the last snapshot or restore sets its dirty
+// bit and, if not already done, saves the page's previous content (undo
+// log). restore() only copies back the dirty pages, so both operations cost
+// the number of pages modified, not the memory size. Writes done directly
+// through the meminfo pointer are not tracked. Both are also available as
+// proxy commands (``mem_snapshot`` / ``mem_restore``).
 
 #include <stdio.h>
 #include <string.h>
-#include <map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 #include <vp/vp.hpp>
 #include <vp/signal.hpp>
 #include <vp/stats/stats.hpp>
 #include <vp/itf/io_v2.hpp>
 #include <vp/itf/wire.hpp>
 #include <vp/debug_mem.hpp>
+#include <vp/proxy.hpp>
+#include <vp/memcheck.hpp>
 #include <memory/memory_v3/memory_v3_config.hpp>
+#include <memory/reservation_table.hpp>
+#include <memory/memcheck_shadow.hpp>
+#include <utils/host_profiler.hpp>
+
+// Host memory actually committed for the backing store, sampled with
+// mincore() when the stat is dumped. Heap backings are fully committed and
+// report their size.
+class StatResidentBytes : public vp::StatCommon
+{
+public:
+    void set_backing(uint8_t *data, uint64_t size, bool mapped)
+    {
+        this->data = data;
+        this->size = size;
+        this->mapped = mapped;
+    }
+
+    uint64_t get_resident() const
+    {
+        if (!this->mapped || this->size == 0) return this->size;
+
+        uint64_t page_size = sysconf(_SC_PAGESIZE);
+        std::vector<unsigned char> pages((this->size + page_size - 1) / page_size);
+        if (mincore(this->data, this->size, pages.data()) != 0) return this->size;
+
+        uint64_t resident = 0;
+        for (unsigned char page : pages)
+        {
+            if (page & 1) resident += page_size;
+        }
+        return resident < this->size ? resident : this->size;
+    }
+
+    std::string format_value(bool raw) const override
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), raw ? "%llu" : "%llu B",
+            (unsigned long long)this->get_resident());
+        return buf;
+    }
+
+    void reset() override {}
+
+private:
+    uint8_t *data = nullptr;
+    uint64_t size = 0;
+    bool mapped = false;
+};
+
+// Fixed per-request latency only
+struct FixedLatencyTiming
+{
+    static constexpr bool banked = false;
+};
+
+// Width-based duration and bank conflicts
+struct BankedTiming
+{
+    static constexpr bool banked = true;
+};
+
+#ifdef CONFIG_MEMORY_TIMING
+using MemoryTiming = BankedTiming;
+#else
+using MemoryTiming = FixedLatencyTiming;
+#endif
 
 class Memory : public vp::Component, public vp::DebugMemIf
 {
@@ -60,12 +166,23 @@ class Memory : public vp::Component, public vp::DebugMemIf
 public:
     Memory(vp::ComponentConf &config);
 
+    template<typename Timing>
     static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
 
     vp::DebugMemIf *debug_mem_if() override { return this; }
     int debug_mem_access(uint64_t addr, uint8_t *data, uint64_t size,
         bool is_write) override;
 
+    std::string handle_command(gv::GvProxy *proxy, FILE *req_file, FILE *reply_file,
+        std::vector<std::string> args, std::string cmd_req) override;
+
+    // Make the current content the restore point. Returns the number of pages
+    // modified since the previous snapshot.
+    uint64_t snapshot();
+    // Restore the content of the last snapshot. Returns the number of pages
+    // copied back, or -1 if no snapshot was taken.
+    int64_t restore();
+
     MemoryV3Config cfg;
 
 private:
@@ -76,16 +193,28 @@ private:
     static void power_ctrl_sync(vp::Block *__this, bool value);
     static void meminfo_sync_back(vp::Block *__this, void **value);
     static void meminfo_sync(vp::Block *__this, void *value);
+    static void memcheck_sync(vp::Block *__this, vp::MemCheckRequest *req);
+    uint64_t memcheck_alloc(uint64_t ptr, uint64_t size);
+    uint64_t memcheck_free(uint64_t virtual_ptr, uint64_t size);
+    void memcheck_buffer_setup(uint64_t base, uint64_t size, bool enable);
+    bool check_buffer_access(uint64_t offset, uint64_t size, bool is_write);
     vp::IoReqStatus handle_write(uint64_t addr, uint64_t size, uint8_t *data);
     vp::IoReqStatus handle_read(uint64_t addr, uint64_t size, uint8_t *data);
     vp::IoReqStatus handle_atomic(uint64_t addr, uint64_t size, uint8_t *in_data,
         uint8_t *out_data, vp::IoReqOpcode opcode, void *initiator);
     void log_access(uint64_t addr, uint64_t size, bool is_write);
+    void map_stim_file();
+    // Banked timing policy: bank wait and duration of an access
+    void bank_timing(vp::IoReq *req, uint64_t offset, uint64_t size);
+    // Snapshot bookkeeping of a write to [offset, offset + size)
+    void track_write(uint64_t offset, uint64_t size);
+    uint64_t page_bytes(uint64_t page);
 
     vp::Trace trace;
+    host_profiler::Counter *host_prof;
     // io_v2 slave port — request callback is attached via the in-class
     // initializer; no set_req_meth() in v2.
-    vp::IoSlave in{&Memory::req};
+    vp::IoSlave in{&Memory::req<MemoryTiming>};
 
     uint64_t truncate_mask;
 
@@ -94,13 +223,36 @@ private:
 
     vp::WireSlave<bool> power_ctrl_itf;
     vp::WireSlave<void *> meminfo_itf;
+    vp::WireSlave<vp::MemCheckRequest *> memcheck_itf;
+
+    // Live memcheck buffers, enabled when the memory has a memcheck id
+    MemcheckShadow memcheck_shadow;
 
     bool powered_up;
 
     // LR/SC reservation table. Keyed on ``req->initiator`` (void* in v2).
-    std::map<void *, uint64_t> res_table;
+    ReservationTable<void *> res_table;
 
     bool free_mem = false;
+    // Size of the mmap backing mem_data, 0 when it comes from the heap.
+    uint64_t mapped_size = 0;
+
+    // Banked timing policy: cycle at which each bank is free again
+    std::vector<int64_t> bank_next_cycle;
+    int nb_banks = 1;
+    int64_t width = 0;
+
+    // Snapshot state, allocated by the first snapshot()
+    static constexpr int SNAPSHOT_PAGE_BITS = 12;
+    bool snapshot_active = false;
+    // Pages written since the last snapshot or restore
+    std::vector<bool> page_dirty;
+    std::vector<uint32_t> dirty_pages;
+    // Content of the pages at snapshot time, saved on their first write.
+    // page_slot gives the offset of a page in saved_data, -1 if not saved.
+    std::vector<int64_t> page_slot;
+    std::vector<uint32_t> saved_pages;
+    std::vector<uint8_t> saved_data;
     vp::Signal<uint64_t> log_addr;
     vp::Signal<uint64_t> log_size;
     vp::Signal<bool> log_is_write;
@@ -114,6 +266,9 @@ private:
     vp::StatScalar stat_bytes_written;
     vp::StatBw stat_read_bw;
     vp::StatBw stat_write_bw;
+    StatResidentBytes stat_resident_bytes;
+    vp::StatScalar stat_bank_conflicts;
+    vp::StatScalar stat_bank_conflict_cycles;
 };
 
 
@@ -125,6 +280,7 @@ log_size(*this, "req_size", 64, vp::SignalCommon::ResetKind::HighZ),
 log_is_write(*this, "req_is_write", 1, vp::SignalCommon::ResetKind::HighZ)
 {
     traces.new_trace("trace", &trace, vp::DEBUG);
+    host_prof = host_profiler::counter(get_path(), "memory_v3");
     new_slave_port("input", &in);
 
     // Register statistics
@@ -136,6 +292,19 @@ log_is_write(*this, "req_is_write", 1, vp::SignalCommon::ResetKind::HighZ)
     this->stat_read_bw.set_source(&this->stat_bytes_read);
     this->stats.register_stat(&this->stat_write_bw, "write_bandwidth", "Average write bandwidth");
     this->stat_write_bw.set_source(&this->stat_bytes_written);
+    this->stats.register_stat(&this->stat_resident_bytes, "resident_bytes",
+        "Host memory committed for the backing store");
+
+    if (MemoryTiming::banked)
+    {
+        this->nb_banks = this->cfg.nb_banks > 0 ? this->cfg.nb_banks : 1;
+        this->width = this->cfg.width;
+        this->bank_next_cycle.resize(this->nb_banks, 0);
+        this->stats.register_stat(&this->stat_bank_conflicts, "bank_conflicts",
+            "Accesses delayed by a busy bank");
+        this->stats.register_stat(&this->stat_bank_conflict_cycles, "bank_conflict_cycles",
+            "Cycles spent waiting for busy banks");
+    }
 
     this->power_ctrl_itf.set_sync_meth(&Memory::power_ctrl_sync);
     new_slave_port("power_ctrl", &this->power_ctrl_itf);
@@ -144,12 +313,30 @@ log_is_write(*this, "req_is_write", 1, vp::SignalCommon::ResetKind::HighZ)
     this->meminfo_itf.set_sync_meth(&Memory::meminfo_sync);
     new_slave_port("meminfo", &this->meminfo_itf);
 
+    this->memcheck_itf.set_sync_meth(&Memory::memcheck_sync);
+    new_slave_port("memcheck", &this->memcheck_itf);
+
     this->truncate_mask = this->cfg.truncate ? this->cfg.size - 1 : -1;
 
     trace.msg("Building Memory (size: 0x%llx, check: %d)\n",
               (unsigned long long)this->cfg.size, this->cfg.check);
 
-    if (this->cfg.align)
+    bool has_stim = this->cfg.stim_file != nullptr && this->cfg.stim_file[0] != '\0';
+    bool map_stim = has_stim && this->cfg.stim_mmap;
+
+    if (this->cfg.sparse || map_stim)
+    {
+        // Only reserve the address space, the kernel commits zeroed pages on
+        // first touch. Rounded to whole pages so that the stim file mapping
+        // never goes past the reservation.
+        uint64_t page_size = sysconf(_SC_PAGESIZE);
+        this->mapped_size = (this->cfg.size + page_size - 1) & ~(page_size - 1);
+        void *data = mmap(NULL, this->mapped_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (data == MAP_FAILED) throw std::bad_alloc();
+        mem_data = (uint8_t *)data;
+    }
+    else if (this->cfg.align)
     {
         mem_data = (uint8_t *)aligned_alloc(this->cfg.align, this->cfg.size);
     }
@@ -159,6 +346,7 @@ log_is_write(*this, "req_is_write", 1, vp::SignalCommon::ResetKind::HighZ)
         if (mem_data == NULL) throw std::bad_alloc();
     }
     this->free_mem = true;
+    this->stat_resident_bytes.set_backing(mem_data, this->cfg.size, this->mapped_size != 0);
 
     if (this->cfg.check)
     {
@@ -169,12 +357,17 @@ log_is_write(*this, "req_is_write", 1, vp::SignalCommon::ResetKind::HighZ)
         check_mem = NULL;
     }
 
-    if (this->cfg.init && this->cfg.size < (2<<24))
+    // The poison fill would commit every page of a mapped memory
+    if (this->cfg.init && this->mapped_size == 0 && this->cfg.size < (2<<24))
     {
         memset(mem_data, 0x57, this->cfg.size);
     }
 
-    if (this->cfg.stim_file != nullptr && this->cfg.stim_file[0] != '\0')
+    if (map_stim)
+    {
+        this->map_stim_file();
+    }
+    else if (has_stim)
     {
         trace.msg("Preloading Memory with stimuli file (path: %s)\n", this->cfg.stim_file);
 
@@ -191,7 +384,52 @@ log_is_write(*this, "req_is_write", 1, vp::SignalCommon::ResetKind::HighZ)
                                this->cfg.stim_file, strerror(errno));
             return;
         }
+        fclose(file);
+    }
+
+#ifdef VP_MEMCHECK_ACTIVE
+    if (this->traces.get_trace_engine()->is_memcheck_enabled() && this->cfg.memcheck_id != -1)
+    {
+        this->memcheck_shadow.init((uint64_t)this->cfg.size * this->cfg.memcheck_expansion_factor);
+        this->get_memcheck()->register_memory(this->cfg.memcheck_id, &this->memcheck_itf);
+    }
+#endif
+}
+
+
+void Memory::map_stim_file()
+{
+    trace.msg("Mapping stimuli file (path: %s)\n", this->cfg.stim_file);
+
+    int fd = open(this->cfg.stim_file, O_RDONLY);
+    if (fd == -1)
+    {
+        this->trace.fatal("Unable to open stim file: %s, %s\n",
+                           this->cfg.stim_file, strerror(errno));
+        return;
     }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        this->trace.fatal("Unable to stat stim file: %s, %s\n",
+                           this->cfg.stim_file, strerror(errno));
+        close(fd);
+        return;
+    }
+
+    // Map over the start of the anonymous reservation. Bytes past the end of
+    // the file read as zero, up to the end of its last page from the file
+    // mapping, then from the reservation.
+    uint64_t size = std::min((uint64_t)st.st_size, (uint64_t)this->cfg.size);
+    if (size > 0 && mmap(this->mem_data, size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        this->trace.fatal("Unable to map stim file: %s, %s\n",
+                           this->cfg.stim_file, strerror(errno));
+    }
+
+    close(fd);
 }
 
 
@@ -218,9 +456,44 @@ void Memory::log_access(uint64_t addr, uint64_t size, bool is_write)
 }
 
 
+void Memory::bank_timing(vp::IoReq *req, uint64_t offset, uint64_t size)
+{
+    int64_t now = this->clock.get_cycles();
+    int64_t duration = this->width > 0 ? ((int64_t)size + this->width - 1) / this->width : 1;
+    if (duration == 0) duration = 1;
+
+    // Banks covered by the access, at most all of them
+    uint64_t first = offset >> this->cfg.bank_interleaving_bits;
+    uint64_t last = (offset + (size ? size : 1) - 1) >> this->cfg.bank_interleaving_bits;
+    uint64_t nb = std::min(last - first + 1, (uint64_t)this->nb_banks);
+
+    int64_t wait = 0;
+    for (uint64_t i = 0; i < nb; i++)
+    {
+        wait = std::max(wait, this->bank_next_cycle[(first + i) % this->nb_banks] - now);
+    }
+    for (uint64_t i = 0; i < nb; i++)
+    {
+        this->bank_next_cycle[(first + i) % this->nb_banks] = now + wait + duration;
+    }
+
+    if (wait > 0)
+    {
+        this->trace.msg(vp::Trace::LEVEL_TRACE, "Bank conflict (bank: %ld, wait: %ld)\n",
+            first % this->nb_banks, wait);
+        this->stat_bank_conflicts++;
+        this->stat_bank_conflict_cycles += wait;
+        req->inc_latency(wait);
+    }
+    req->set_duration(duration);
+}
+
+
+template<typename Timing>
 vp::IoReqStatus Memory::req(vp::Block *__this, vp::IoReq *req)
 {
     Memory *_this = (Memory *)__this;
+    host_profiler::Scope prof(_this->host_prof);
 
     uint64_t offset = req->get_addr() & _this->truncate_mask;
     uint8_t *data = req->get_data();
@@ -243,12 +516,14 @@ vp::IoReqStatus Memory::req(vp::Block *__this, vp::IoReq *req)
 
     _this->log_access(offset, size, req->get_is_write());
 
-    // Timing annotation. memory_v3 only models a fixed per-request
-    // latency; it is read inline by the master under the IoV2Sync
-    // contract (no async response). Bandwidth / per-byte duration is
-    // deliberately not modelled here — put a shaper (e.g.
-    // interco.limiter_v2.Limiter) upstream if that is needed.
+    // Timing annotation, read inline by the master under the IoV2Sync
+    // contract (no async response). Without the banked policy, only the
+    // fixed per-request latency is modelled.
     req->inc_latency((int64_t)_this->cfg.latency);
+    if constexpr (Timing::banked)
+    {
+        _this->bank_timing(req, offset, size);
+    }
 
 #ifdef VP_TRACE_ACTIVE
     if (_this->cfg.power_trigger)
@@ -281,6 +556,14 @@ vp::IoReqStatus Memory::req(vp::Block *__this, vp::IoReq *req)
         return vp::IO_REQ_DONE;
     }
 
+#ifdef VP_MEMCHECK_ACTIVE
+    if (_this->check_buffer_access(offset, size, req->get_is_write()))
+    {
+        req->set_resp_status(vp::IO_RESP_INVALID);
+        return vp::IO_REQ_DONE;
+    }
+#endif
+
     if (req->get_opcode() == vp::IoReqOpcode::READ)
     {
         return _this->handle_read(offset, size, data);
@@ -333,8 +616,16 @@ vp::IoReqStatus Memory::handle_write(uint64_t offset, uint64_t size, uint8_t *da
         return vp::IO_REQ_DONE;
     }
 
+#ifdef CONFIG_ATOMICS
+    this->res_table.invalidate(offset, size);
+#endif
+
     if (data)
     {
+        if (this->snapshot_active)
+        {
+            this->track_write(offset, size);
+        }
         memcpy((void *)&this->mem_data[offset], (void *)data, size);
     }
 
@@ -386,20 +677,15 @@ vp::IoReqStatus Memory::handle_atomic(uint64_t addr, uint64_t size, uint8_t *in_
     switch (opcode)
     {
         case vp::IoReqOpcode::LR:
-            this->res_table[initiator] = addr;
+            this->res_table.reserve(initiator, addr, size);
             is_write = false;
             break;
         case vp::IoReqOpcode::SC:
         {
-            auto it = this->res_table.find(initiator);
-            if (it != this->res_table.end() && it->second == addr)
+            // On success, the write below drops all the reservations on the
+            // location, including this one.
+            if (this->res_table.check(initiator, addr))
             {
-                for (auto &e : this->res_table) {
-                    if (e.second >= addr && e.second < addr + size)
-                    {
-                        e.second = -1;
-                    }
-                }
                 result   = operand;
                 prev_val = 0;
             }
@@ -438,11 +724,127 @@ vp::IoReqStatus Memory::handle_atomic(uint64_t addr, uint64_t size, uint8_t *in_
 }
 
 
+uint64_t Memory::page_bytes(uint64_t page)
+{
+    uint64_t offset = page << SNAPSHOT_PAGE_BITS;
+    return std::min((uint64_t)1 << SNAPSHOT_PAGE_BITS, (uint64_t)this->cfg.size - offset);
+}
+
+
+void Memory::track_write(uint64_t offset, uint64_t size)
+{
+    if (size == 0) return;
+
+    uint64_t first = offset >> SNAPSHOT_PAGE_BITS;
+    uint64_t last = (offset + size - 1) >> SNAPSHOT_PAGE_BITS;
+    for (uint64_t page = first; page <= last; page++)
+    {
+        if (this->page_dirty[page]) continue;
+
+        this->page_dirty[page] = true;
+        this->dirty_pages.push_back(page);
+
+        if (this->page_slot[page] == -1)
+        {
+            uint8_t *src = &this->mem_data[page << SNAPSHOT_PAGE_BITS];
+            this->page_slot[page] = this->saved_data.size();
+            this->saved_data.insert(this->saved_data.end(), src, src + this->page_bytes(page));
+            this->saved_pages.push_back(page);
+        }
+    }
+}
+
+
+uint64_t Memory::snapshot()
+{
+    uint64_t nb_dirty = this->dirty_pages.size();
+
+    if (!this->snapshot_active)
+    {
+        uint64_t nb_pages = ((uint64_t)this->cfg.size + (1 << SNAPSHOT_PAGE_BITS) - 1)
+            >> SNAPSHOT_PAGE_BITS;
+        this->page_dirty.assign(nb_pages, false);
+        this->page_slot.assign(nb_pages, -1);
+        this->snapshot_active = true;
+    }
+    else
+    {
+        for (uint32_t page : this->dirty_pages)
+        {
+            this->page_dirty[page] = false;
+        }
+        for (uint32_t page : this->saved_pages)
+        {
+            this->page_slot[page] = -1;
+        }
+    }
+
+    this->dirty_pages.clear();
+    this->saved_pages.clear();
+    this->saved_data.clear();
+
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Snapshot (modified pages: %ld)\n", nb_dirty);
+
+    return nb_dirty;
+}
+
+
+int64_t Memory::restore()
+{
+    if (!this->snapshot_active)
+    {
+        return -1;
+    }
+
+    uint64_t nb_dirty = this->dirty_pages.size();
+
+    // Saved pages stay valid, a page written again after the restore is
+    // only marked dirty.
+    for (uint32_t page : this->dirty_pages)
+    {
+        memcpy(&this->mem_data[(uint64_t)page << SNAPSHOT_PAGE_BITS],
+            &this->saved_data[this->page_slot[page]], this->page_bytes(page));
+        this->page_dirty[page] = false;
+    }
+    this->dirty_pages.clear();
+
+    // Reservations refer to the discarded execution
+    this->res_table.clear();
+
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Restore (restored pages: %ld)\n", nb_dirty);
+
+    return nb_dirty;
+}
+
+
+std::string Memory::handle_command(gv::GvProxy *proxy, FILE *req_file, FILE *reply_file,
+    std::vector<std::string> args, std::string cmd_req)
+{
+    if (args.size() >= 1 && args[0] == "mem_snapshot")
+    {
+        this->snapshot();
+        return "err=0";
+    }
+    else if (args.size() >= 1 && args[0] == "mem_restore")
+    {
+        return this->restore() < 0 ? "err=1" : "err=0";
+    }
+    return "err=1";
+}
+
+
 void Memory::stop()
 {
     if (this->free_mem)
     {
-        free(this->mem_data);
+        if (this->mapped_size)
+        {
+            munmap(this->mem_data, this->mapped_size);
+        }
+        else
+        {
+            free(this->mem_data);
+        }
         this->free_mem = false;
     }
     if (this->cfg.check)
@@ -456,6 +858,7 @@ void Memory::reset(bool active)
     if (active)
     {
         this->powered_up = true;
+        std::fill(this->bank_next_cycle.begin(), this->bank_next_cycle.end(), 0);
     }
 }
 
@@ -482,6 +885,111 @@ void Memory::meminfo_sync(vp::Block *__this, void *value)
     Memory *_this = (Memory *)__this;
     _this->mem_data = (uint8_t *)value;
     _this->free_mem = false;
+    _this->mapped_size = 0;
+    _this->stat_resident_bytes.set_backing(_this->mem_data, _this->cfg.size, false);
+}
+
+
+
+void Memory::memcheck_sync(vp::Block *__this, vp::MemCheckRequest *req)
+{
+    Memory *_this = (Memory *)__this;
+    if (req->is_alloc)
+    {
+        req->offset = _this->memcheck_alloc(req->offset, req->size);
+    }
+    else
+    {
+        req->offset = _this->memcheck_free(req->offset, req->size);
+    }
+}
+
+
+bool Memory::check_buffer_access(uint64_t offset, uint64_t size, bool is_write)
+{
+    uint64_t current_offset;
+    if (this->memcheck_shadow.is_enabled() &&
+        !this->memcheck_shadow.check(offset, size, current_offset))
+    {
+        // Only look for the closest buffer once the access is known to be
+        // invalid, to help the user understand the overflow
+        uint64_t buffer_offset, buffer_size, distance;
+        this->memcheck_shadow.find_closest_buffer(current_offset, distance, buffer_offset, buffer_size);
+
+        this->trace.force_warning_no_error("%s access outside buffer (virtual addr: 0x%llx)\n",
+            is_write ? "Write" : "Read",
+            (unsigned long long)(current_offset + this->cfg.memcheck_virtual_base));
+
+        if (distance == 0)
+        {
+            this->trace.force_warning_no_error("%s access with no buffer\n", is_write ? "Write" : "Read");
+        }
+        else
+        {
+            bool is_before = buffer_offset > current_offset;
+            uint64_t buffer_real_addr = (buffer_offset - buffer_size * (this->cfg.memcheck_expansion_factor / 2)) /
+                this->cfg.memcheck_expansion_factor + this->cfg.memcheck_base;
+
+            this->trace.force_warning_no_error("%s access is %llu byte(s) %s buffer "
+                "(buffer_addr: 0x%llx, buffer_virtual_addr: 0x%llx, buffer_size: 0x%llx)\n",
+                is_write ? "Write" : "Read", (unsigned long long)distance,
+                is_before ? "before" : "after", (unsigned long long)buffer_real_addr,
+                (unsigned long long)(buffer_offset + this->cfg.memcheck_virtual_base),
+                (unsigned long long)buffer_size);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+
+void Memory::memcheck_buffer_setup(uint64_t base, uint64_t size, bool enable)
+{
+    this->trace.msg(vp::Trace::LEVEL_INFO, "%s valid buffer (offset: 0x%llx, size: 0x%llx)\n",
+        enable ? "Adding" : "Removing", (unsigned long long)base, (unsigned long long)size);
+
+    if (base + size >= this->memcheck_shadow.get_size())
+    {
+        this->trace.force_warning("Trying to %s invalid buffer (offset: 0x%llx, size: 0x%llx, mem_size: 0x%llx)\n",
+            enable ? "add" : "remove", (unsigned long long)base, (unsigned long long)size,
+            (unsigned long long)this->cfg.size);
+        return;
+    }
+
+    this->memcheck_shadow.set_buffer(base, size, enable);
+}
+
+
+uint64_t Memory::memcheck_alloc(uint64_t ptr, uint64_t size)
+{
+    if (this->memcheck_shadow.is_enabled())
+    {
+        uint64_t virtual_offset = (ptr - this->cfg.memcheck_base) * this->cfg.memcheck_expansion_factor +
+            size * (this->cfg.memcheck_expansion_factor / 2);
+
+        this->memcheck_buffer_setup(virtual_offset, size, true);
+
+        return virtual_offset + this->cfg.memcheck_virtual_base;
+    }
+
+    return ptr;
+}
+
+
+uint64_t Memory::memcheck_free(uint64_t virtual_ptr, uint64_t size)
+{
+    if (this->memcheck_shadow.is_enabled())
+    {
+        uint64_t virtual_offset = virtual_ptr - this->cfg.memcheck_virtual_base;
+
+        this->memcheck_buffer_setup(virtual_offset, size, false);
+
+        return (virtual_offset - size * (this->cfg.memcheck_expansion_factor / 2)) /
+            this->cfg.memcheck_expansion_factor + this->cfg.memcheck_base;
+    }
+
+    return virtual_ptr;
 }
 
 
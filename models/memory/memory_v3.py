@@ -41,6 +41,13 @@ class MemoryV3Config(Config, HasSize):
         extra simulation time, so leave ``False`` when not needed.
     latency: int
         Extra latency (cycles) added to every request. Default ``1``.
+    width: int
+        Bytes served per cycle by one bank. ``0`` disables the
+        width-based duration.
+    nb_banks: int
+        Number of banks of the conflict model. ``1`` disables it.
+    bank_interleaving_bits: int
+        Log2 of the bank interleaving granule, in bytes.
     truncate: bool
         If True, the incoming address is masked with ``size - 1`` so
         the memory appears as a repeating window over the whole
@@ -48,6 +55,9 @@ class MemoryV3Config(Config, HasSize):
     align: int
         Alignment (bytes) requested from ``aligned_alloc`` for the
         backing buffer. ``0`` falls back to ``calloc``.
+    sparse: bool
+        Reserve the backing buffer as address space only; host pages
+        are committed on first write.
     check: bool
         Allocate a side-band bitmap for tracking uninitialised
         accesses.
@@ -57,10 +67,21 @@ class MemoryV3Config(Config, HasSize):
     stim_file: str
         Optional path to a raw-binary file preloaded into the backing
         buffer at startup. Empty string means "no preload".
+    stim_mmap: bool
+        Map ``stim_file`` copy-on-write as the initial backing store
+        instead of copying it.
     power_trigger: bool
         True to enable the power-capture trigger (magic writes of
         ``0xabbaabba`` / ``0xdeadcaca`` at offset 0 start/stop
         capture).
+    memcheck_id: int
+        Memcheck memory id, ``-1`` to keep the memory out of memcheck.
+    memcheck_base: int
+        Physical base address of the memory, for memcheck.
+    memcheck_virtual_base: int
+        Base address of the memcheck virtual window.
+    memcheck_expansion_factor: int
+        Size of the memcheck virtual window, in multiples of ``size``.
     """
 
     size: int = cfg_field(default=0, fmt="hex", dump=True, desc=(
@@ -78,6 +99,20 @@ class MemoryV3Config(Config, HasSize):
         "incoming request"
     ))
 
+    width: int = cfg_field(default=0, dump=True, desc=(
+        "Bytes per cycle served by one bank, 0 for no bandwidth limit. "
+        "Setting it compiles in the banked timing model"
+    ))
+
+    nb_banks: int = cfg_field(default=1, dump=True, desc=(
+        "Number of banks of the bank-conflict model. More than 1 compiles in "
+        "the banked timing model"
+    ))
+
+    bank_interleaving_bits: int = cfg_field(default=2, dump=True, desc=(
+        "Log2 of the number of consecutive bytes mapped to the same bank"
+    ))
+
     truncate: int = cfg_field(default=True, dump=True, desc=(
         "If true, this truncates the global input address with the "
         "memory size to make it relative to the memory"
@@ -87,6 +122,11 @@ class MemoryV3Config(Config, HasSize):
         "Alignment in bytes requested from aligned_alloc for the backing buffer"
     ))
 
+    sparse: bool = cfg_field(default=False, dump=True, desc=(
+        "Reserve the backing buffer with mmap(MAP_NORESERVE) instead of "
+        "allocating it, untouched pages read as zero and cost no host memory"
+    ))
+
     check: bool = cfg_field(default=False, dump=True, desc=(
         "Allocate a bitmap for tracking uninitialised accesses"
     ))
@@ -100,10 +140,31 @@ class MemoryV3Config(Config, HasSize):
         "(empty string means no preload)"
     ))
 
+    stim_mmap: bool = cfg_field(default=False, dump=True, desc=(
+        "Map stim_file MAP_PRIVATE as the initial backing store instead of "
+        "reading it, pages are shared through the page cache and copied on write"
+    ))
+
     power_trigger: bool = cfg_field(default=False, dump=True, desc=(
         "Enable power-capture start/stop triggers on magic writes to offset 0"
     ))
 
+    memcheck_id: int = cfg_field(default=-1, dump=True, desc=(
+        "Memcheck memory id, -1 to keep the memory out of memcheck"
+    ))
+
+    memcheck_base: int = cfg_field(default=0, fmt="hex", dump=True, desc=(
+        "Physical base address of the memory, used by memcheck"
+    ))
+
+    memcheck_virtual_base: int = cfg_field(default=0, fmt="hex", dump=True, desc=(
+        "Base address of the memcheck virtual window"
+    ))
+
+    memcheck_expansion_factor: int = cfg_field(default=5, dump=True, desc=(
+        "Size of the memcheck virtual window, in multiples of the memory size"
+    ))
+
 
 class Memory(gvsoc.systree.Component):
     """SRAM backing store on the io_v2 protocol.
@@ -119,8 +180,8 @@ class Memory(gvsoc.systree.Component):
     masters that speak the io_v2 protocol — every other aspect
     (preload, power-capture trigger, atomics) is identical, except
     that v3 models only a fixed per-request latency (no bandwidth /
-    per-byte duration). Memcheck bookkeeping is *not* carried over:
-    v3 is a plain backing store.
+    per-byte duration). Of the memcheck bookkeeping, only the buffer
+    tracking is carried over (see *Memcheck* below).
 
     Pair this with io_v2 interconnect components like
     :class:`interco.router_v2.Router`,
@@ -141,8 +202,10 @@ class Memory(gvsoc.systree.Component):
       served inline when ``atomics=True`` was passed at
       construction. The reservation table is keyed on
       ``req->initiator`` (a ``void *`` in v2) so different masters
-      hold independent reservations, and ``SC`` returns 1 in the
-      previous-value slot on failure. Without ``atomics=True`` the
+      hold independent reservations. Any write overlapping a
+      reservation (plain store, AMO or successful ``SC``) cancels
+      it, and ``SC`` returns 1 in the previous-value slot on
+      failure. Without ``atomics=True`` the
       request is refused with ``IO_RESP_INVALID``.
     - **Out-of-bounds** (``addr + size > cfg.size`` after optional
       truncation): a warning is logged and the request returns
@@ -156,17 +219,27 @@ class Memory(gvsoc.systree.Component):
     Timing model
     ~~~~~~~~~~~~
 
-    Fully synchronous: every request is annotated with a single fixed
+    Fully synchronous: every request is annotated with a fixed
     latency (``cfg.latency`` cycles) via ``req->inc_latency()``, which
-    the master reads inline under the IoV2Sync contract. There is no
-    bandwidth / per-byte duration model — back-to-back accesses are
-    each charged the same fixed latency. Model bandwidth with an
-    upstream shaper (e.g. :class:`interco.limiter_v2.Limiter`) if it
-    is needed.
+    the master reads inline under the IoV2Sync contract. By default
+    there is no bandwidth / per-byte duration model — back-to-back
+    accesses are each charged the same fixed latency.
+
+    Setting ``width`` or ``nb_banks > 1`` compiles in a banked timing
+    policy instead (the request handler is a template on the policy,
+    so the default build keeps the plain fixed-latency path). The
+    memory is split into ``nb_banks`` banks interleaved on
+    ``2**bank_interleaving_bits`` bytes, each serving ``width`` bytes
+    per cycle. An access occupies every bank it covers for
+    ``ceil(size / width)`` cycles, reported with ``set_duration()``,
+    and an access hitting a busy bank gets the wait added to its
+    latency. The ``bank_conflicts`` / ``bank_conflict_cycles``
+    statistics count them. This gives L2-style contention numbers
+    without an external shaper.
 
     Under the ``functional`` hierarchical timing level (see
-    ``gvrun.timing``) the latency is forced to 0, whatever the config
-    says.
+    ``gvrun.timing``) the latency is forced to 0 and the banked
+    policy is not compiled in, whatever the config says.
 
     Debug-flag bypass does not exist in io_v2 (there is no
     ``req->is_debug()``), so every access — including syscalls and
@@ -175,6 +248,20 @@ class Memory(gvsoc.systree.Component):
     user should route them through a separate, zero-latency memory
     instance if needed.
 
+    Snapshots
+    ~~~~~~~~~
+
+    The ``mem_snapshot`` proxy command (``Memory::snapshot()`` from
+    C++) marks the current content as a restore point, and
+    ``mem_restore`` (``Memory::restore()``) brings the memory back to
+    it, as many times as needed. Tracking is off until the first
+    snapshot. After it, the first write to a 4 KiB page saves the
+    page's previous content and marks it dirty, so both commands only
+    cost the pages modified since the previous one — this is what
+    makes checkpoint-and-fork sweeps from a warm state cheap. Writes
+    done directly through the ``meminfo`` pointer bypass the tracking.
+    LR/SC reservations are dropped on restore.
+
     Ports
     ~~~~~
 
@@ -209,10 +296,14 @@ class Memory(gvsoc.systree.Component):
       refuses atomic opcodes with ``IO_RESP_INVALID``. Atomics cost
       latency on the model, so leave the default off where they are
       not exercised.
-    - **No memcheck integration.** v3 is deliberately a plain
-      backing store — no buffer-overflow tracking, no allocator
-      hook, no shadow buffer. Use :class:`memory.memory_v2.Memory`
-      when memcheck bookkeeping is needed.
+    - **Memcheck tracks buffers, not data.** With memcheck enabled
+      and a ``memcheck_id`` set, the memory registers to the
+      memcheck allocator hook, keeps the live buffers, and answers
+      accesses outside them with ``IO_RESP_INVALID`` after a
+      warning naming the closest buffer. io_v2 requests carry no
+      memcheck sideband, so uninitialized-data tracking is left to
+      :class:`memory.memory_v2.Memory`. Backdoor accesses are not
+      checked.
     - **Size must satisfy the bounds check.** Any ``addr+size`` past
       ``cfg.size`` (after truncation) is rejected at the request
       level; no partial completion. Masters that want to straddle a
@@ -237,6 +328,15 @@ class Memory(gvsoc.systree.Component):
         ``False`` (atomics respond with ``IO_RESP_INVALID``).
     ``latency``
         Extra latency (cycles) added to every request. Default 1.
+    ``width``
+        Bytes served per cycle by one bank of the banked timing
+        policy. ``0`` (default) means no width-based duration.
+    ``nb_banks``
+        Number of banks of the banked timing policy. Default ``1``
+        (no bank conflicts).
+    ``bank_interleaving_bits``
+        Log2 of the bank interleaving granule in bytes. Default ``2``
+        (word-interleaved).
     ``truncate``
         When ``True``, the incoming address is masked by
         ``cfg.size - 1`` before bounds checking and lookup —
@@ -246,6 +346,17 @@ class Memory(gvsoc.systree.Component):
     ``align``
         Alignment (bytes) passed to ``aligned_alloc`` for the
         backing buffer. ``0`` falls back to ``calloc``.
+    ``sparse``
+        When ``True``, the backing buffer is an anonymous
+        ``MAP_NORESERVE`` mapping: the whole size is reserved as
+        address space but host pages are only committed when first
+        written, and untouched pages read as zero. Meant for large
+        windows (e.g. a 4 GiB DDR) of which the software touches a
+        fraction, so that many simulations fit on one host. ``init``
+        is ignored (the poison fill would commit every page) and
+        ``align`` is implied (the mapping is page-aligned). The
+        ``resident_bytes`` statistic reports the committed size.
+        Default ``False``.
     ``check``
         Allocate a side-band bitmap for tracking uninitialised
         accesses.
@@ -255,10 +366,38 @@ class Memory(gvsoc.systree.Component):
     ``stim_file``
         Path to a raw-binary file loaded via ``fread`` into the
         backing store at startup. Empty string means "no preload".
+    ``stim_mmap``
+        When ``True``, ``stim_file`` is mapped ``MAP_PRIVATE`` over
+        the start of a ``sparse``-style reservation instead of being
+        read. Simulations preloading the same image share its pages
+        through the host page cache, and a page is only copied when
+        the guest writes to it; the file itself is never modified.
+        Bytes past the end of the file read as zero (``init`` is
+        ignored). Default ``False``.
     ``power_trigger``
         When ``True``, a write of ``0xabbaabba`` to offset 0 starts
         power capture; ``0xdeadcaca`` stops it and prints a measure
         line.
+    ``memcheck_id``
+        Memcheck memory id the allocator refers to. ``-1`` (default)
+        leaves the memory out of memcheck.
+    ``memcheck_base`` / ``memcheck_virtual_base``
+        Physical base of the memory and base of its virtual memcheck
+        window, as seen by the allocator.
+    ``memcheck_expansion_factor``
+        Expansion of the virtual window over the memory size, leaving
+        room around each buffer to detect overflows. Default ``5``.
+
+    Memcheck
+    ~~~~~~~~
+
+    Buffers declared through the allocator hook are kept twice (see
+    ``memcheck_shadow.hpp``): a packed one-bit-per-byte shadow,
+    checked on whole 64-bit words on every access, and an interval
+    map of the live buffers, only queried on a faulting access to
+    find the closest buffer. The check is compiled in only in builds
+    with memcheck support (``VP_MEMCHECK_ACTIVE``) and costs nothing
+    unless the memory has a ``memcheck_id``.
 
     Example
     ~~~~~~~
@@ -318,6 +457,11 @@ class Memory(gvsoc.systree.Component):
         if config.atomics:
             self.add_c_flags(['-DCONFIG_ATOMICS=1'])
 
+        # Same for the banked timing policy, which is never needed in
+        # functional runs.
+        if level != gvrun.timing.FUNCTIONAL and (config.width > 0 or config.nb_banks > 1):
+            self.add_c_flags(['-DCONFIG_MEMORY_TIMING=1'])
+
     def i_INPUT(self) -> gvsoc.systree.SlaveItf:
         """Returns the io_v2 input port.
 
@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * LR/SC reservation table shared by the memory models.
+ *
+ * Initiators (an int for io v1 requests, a void * for io_v2 ones) are mapped
+ * to small dense ids through a hash map the first time they take a
+ * reservation, and the reservations are then held in a flat array indexed by
+ * that id. Manycore clusters can have hundreds of cores spinning with LR on
+ * the same word, so LR and SC must not scan the initiators.
+ *
+ * Any write must drop the reservations it overlaps. To keep plain stores
+ * cheap, the table also maintains a counting filter over the reserved
+ * granules: a store first checks the number of active reservations, then
+ * the filter buckets of the granules it covers, and only scans the
+ * reservations when one of them is set. Without any reservation, a store
+ * pays a single compare.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+template<typename Key>
+class ReservationTable
+{
+public:
+    // Reserve [addr, addr + size) for `initiator`, replacing its previous
+    // reservation.
+    void reserve(Key initiator, uint64_t addr, uint64_t size)
+    {
+        int id = this->get_id(initiator);
+        Reservation &res = this->reservations[id];
+        if (res.valid)
+        {
+            this->drop(res);
+        }
+        res.addr = addr;
+        res.size = size;
+        res.valid = true;
+        this->nb_active++;
+        this->filter_update(addr, size, 1);
+    }
+
+    // Check that `initiator` holds a reservation on exactly `addr`.
+    bool check(Key initiator, uint64_t addr)
+    {
+        auto it = this->ids.find(initiator);
+        if (it == this->ids.end())
+        {
+            return false;
+        }
+        const Reservation &res = this->reservations[it->second];
+        return res.valid && res.addr == addr;
+    }
+
+    // Drop every reservation overlapping [addr, addr + size). Called on all
+    // writes, including successful SC.
+    inline void invalidate(uint64_t addr, uint64_t size)
+    {
+        if (this->nb_active == 0 || !this->filter_hit(addr, size))
+        {
+            return;
+        }
+
+        for (Reservation &res : this->reservations)
+        {
+            if (res.valid && res.addr < addr + size && addr < res.addr + res.size)
+            {
+                this->drop(res);
+            }
+        }
+    }
+
+    void clear()
+    {
+        for (Reservation &res : this->reservations)
+        {
+            res.valid = false;
+        }
+        for (uint32_t &bucket : this->filter)
+        {
+            bucket = 0;
+        }
+        this->nb_active = 0;
+    }
+
+private:
+    struct Reservation
+    {
+        uint64_t addr = 0;
+        uint64_t size = 0;
+        bool valid = false;
+    };
+
+    // Filter granule and number of buckets. Reservations are usually on a few
+    // lock words, so a small filter is enough to keep false hits rare.
+    static constexpr int GRANULE_BITS = 3;
+    static constexpr int NB_BUCKETS = 256;
+
+    int get_id(Key initiator)
+    {
+        auto it = this->ids.try_emplace(initiator, (int)this->reservations.size()).first;
+        if (it->second == (int)this->reservations.size())
+        {
+            this->reservations.emplace_back();
+        }
+        return it->second;
+    }
+
+    void drop(Reservation &res)
+    {
+        res.valid = false;
+        this->nb_active--;
+        this->filter_update(res.addr, res.size, -1);
+    }
+
+    void filter_update(uint64_t addr, uint64_t size, int incr)
+    {
+        uint64_t first = addr >> GRANULE_BITS;
+        uint64_t last = (addr + (size ? size : 1) - 1) >> GRANULE_BITS;
+        for (uint64_t granule = first; granule <= last && granule - first < NB_BUCKETS; granule++)
+        {
+            this->filter[granule % NB_BUCKETS] += incr;
+        }
+    }
+
+    inline bool filter_hit(uint64_t addr, uint64_t size)
+    {
+        uint64_t first = addr >> GRANULE_BITS;
+        uint64_t last = (addr + (size ? size : 1) - 1) >> GRANULE_BITS;
+        if (last - first >= NB_BUCKETS)
+        {
+            return true;
+        }
+        for (uint64_t granule = first; granule <= last; granule++)
+        {
+            if (this->filter[granule % NB_BUCKETS]) return true;
+        }
+        return false;
+    }
+
+    std::unordered_map<Key, int> ids;
+    std::vector<Reservation> reservations;
+    int nb_active = 0;
+    // Number of reservations per bucket. Wide enough for every initiator of
+    // a cluster to reserve the same granule.
+    uint32_t filter[NB_BUCKETS] = {};
+};
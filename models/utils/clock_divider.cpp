@@ -17,15 +17,25 @@ private:
     void reset(bool active) override;
     static void clock_sync(vp::Block *__this, bool value);
     static void ctrl_sync(vp::Block *__this, int value);
+    static void clock_en_sync(vp::Block *__this, bool enabled);
+    // Recompute whether the output clock runs and notify the subscribers of
+    // clock_en_out if it changed.
+    void update_enabled();
 
     ClockDividerConfig cfg;
     vp::Trace trace;
     vp::ClockSlave input_itf;
     vp::ClockMaster output_itf;
     vp::WireSlave<int> ctrl_itf;
+    // Gating of the input clock, as notified by the upstream clock model
+    vp::WireSlave<bool> clock_en_in_itf;
+    // Gating of the output clock, so that subscribers can disarm their events
+    vp::WireMaster<bool> clock_en_out_itf;
 
     int count;
     int value;
+    bool input_enabled = true;
+    bool output_enabled = true;
 };
 
 ClockDivider::ClockDivider(vp::ComponentConf &config)
@@ -39,11 +49,33 @@ ClockDivider::ClockDivider(vp::ComponentConf &config)
     this->new_slave_port("clock_in", &this->input_itf);
 
     this->new_master_port("clock_out", &this->output_itf);
+
+    this->clock_en_in_itf.set_sync_meth(&ClockDivider::clock_en_sync);
+    this->new_slave_port("clock_en_in", &this->clock_en_in_itf);
+
+    this->new_master_port("clock_en_out", &this->clock_en_out_itf);
 }
 
 void ClockDivider::reset(bool active) {
     this->count = 0;
     this->value = 0;
+    if (!active) {
+        // A divider of 0 at reset starts with the output gated
+        this->update_enabled();
+    }
+}
+
+void ClockDivider::update_enabled() {
+    // The output stops when the input is gated or when the divider is 0,
+    // since no input edge then ever reaches the division count.
+    bool enabled = this->input_enabled && this->cfg.divider != 0;
+    if (enabled != this->output_enabled) {
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Output clock %s\n", enabled ? "ungated" : "gated");
+        this->output_enabled = enabled;
+        if (this->clock_en_out_itf.is_bound()) {
+            this->clock_en_out_itf.sync(enabled);
+        }
+    }
 }
 
 void ClockDivider::clock_sync(vp::Block *__this, bool active) {
@@ -60,6 +92,13 @@ void ClockDivider::ctrl_sync(vp::Block *__this, int value) {
     ClockDivider *_this = (ClockDivider *)__this;
     _this->count = 0;
     _this->cfg.divider = value;
+    _this->update_enabled();
+}
+
+void ClockDivider::clock_en_sync(vp::Block *__this, bool enabled) {
+    ClockDivider *_this = (ClockDivider *)__this;
+    _this->input_enabled = enabled;
+    _this->update_enabled();
 }
 
 extern "C" vp::Component *gv_new(vp::ComponentConf &config) { return new ClockDivider(config); }
@@ -28,3 +28,13 @@ class ClockDivider(Component):
 
     def i_CLOCK_CTRL(self) -> SlaveItf:
         return SlaveItf(self, itf_name='clock_ctrl', signature='wire<int>')
+
+    def i_CLOCK_EN_IN(self) -> SlaveItf:
+        # Gating of the input clock (False when gated), from the upstream
+        # clock model
+        return SlaveItf(self, itf_name='clock_en_in', signature='wire<bool>')
+
+    def o_CLOCK_EN_OUT(self, itf: SlaveItf):
+        # Gating of the output clock (False when gated), sent when it changes
+        # so that the components of the domain can disarm their events
+        self.itf_bind('clock_en_out', itf, signature='wire<bool>')
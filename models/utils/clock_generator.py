@@ -39,6 +39,11 @@ class ClockGenerator(Component):
     def o_CLOCK_CTRL(self, itf: SlaveItf):
         self.itf_bind('clock_ctrl', itf, signature='clock')
 
+    def o_CLOCK_EN(self, itf: SlaveItf):
+        # Power state of the generator (False when powered down), sent when
+        # it changes so that the clock is seen as gated downstream
+        self.itf_bind('clock_en', itf, signature='wire<bool>')
+
 
 class Clock_generator(st.Component):
 
@@ -43,6 +43,8 @@ private:
     vp::WireSlave<bool> power_itf;
     vp::ClockMaster clock_ctrl_itf;
     vp::ClockMaster clock_sync_itf;
+    // Sent with the power state, so that subscribers see the clock as gated
+    vp::WireMaster<bool> clock_en_itf;
     vp::ClockEvent *event;
     int value;
     float target_frequency;
@@ -66,6 +68,7 @@ Clock::Clock(vp::ComponentConf &config)
     this->new_slave_port("power", &this->power_itf);
     this->new_master_port("clock_ctrl", &this->clock_ctrl_itf);
     this->new_master_port("clock_sync", &this->clock_sync_itf);
+    this->new_master_port("clock_en", &this->clock_en_itf);
     this->value = 0;
 }
 
@@ -123,6 +126,11 @@ void Clock::power_sync(vp::Block *__this, bool active)
                 _this->event->disable();
             }
         }
+
+        if (_this->clock_en_itf.is_bound())
+        {
+            _this->clock_en_itf.sync(active);
+        }
     }
 
     _this->cfg.powered_on = active;
@@ -136,6 +144,11 @@ void Clock::reset(bool active)
         this->frequency = this->clock.get_engine()->get_frequency();
         this->clock_sync_itf.set_frequency(this->clock.get_engine()->get_frequency() / 2);
 
+        if (!this->cfg.powered_on && this->clock_en_itf.is_bound())
+        {
+            this->clock_en_itf.sync(false);
+        }
+
         if (this->cfg.powered_on)
         {
             if (!this->event->is_enqueued())
@@ -17,12 +17,24 @@ public:
 private:
     static void clock_sync(vp::Block *__this, bool value, int id);
     static void ctrl_sync(vp::Block *__this, int value);
+    static void clock_en_sync(vp::Block *__this, bool enabled, int id);
+    void reset(bool active) override;
+    // Recompute whether the output clock runs and notify the subscribers of
+    // clock_en_out if it changed.
+    void update_enabled();
 
     ClockMuxConfig cfg;
     vp::Trace trace;
     std::vector<vp::ClockSlave> input_itf;
     vp::ClockMaster output_itf;
     vp::WireSlave<int> ctrl_itf;
+    // Gating of each input clock, as notified by the upstream clock models
+    std::vector<vp::WireSlave<bool>> clock_en_in_itf;
+    // Gating of the output clock, so that subscribers can disarm their events
+    vp::WireMaster<bool> clock_en_out_itf;
+
+    std::vector<bool> input_enabled;
+    bool output_enabled = true;
 };
 
 ClockMux::ClockMux(vp::ComponentConf &config)
@@ -33,13 +45,39 @@ ClockMux::ClockMux(vp::ComponentConf &config)
     this->new_slave_port("clock_ctrl", &this->ctrl_itf);
 
     this->input_itf.resize(this->cfg.nb_clocks);
+    this->clock_en_in_itf.resize(this->cfg.nb_clocks);
+    this->input_enabled.assign(this->cfg.nb_clocks, true);
     for (int i=0; i<this->cfg.nb_clocks; i++)
     {
         this->input_itf[i].set_sync_meth_muxed(&ClockMux::clock_sync, i);
         this->new_slave_port("clock_in_" + std::to_string(i), &this->input_itf[i]);
+        this->clock_en_in_itf[i].set_sync_meth_muxed(&ClockMux::clock_en_sync, i);
+        this->new_slave_port("clock_en_in_" + std::to_string(i), &this->clock_en_in_itf[i]);
     }
 
     this->new_master_port("clock_out", &this->output_itf);
+    this->new_master_port("clock_en_out", &this->clock_en_out_itf);
+}
+
+void ClockMux::reset(bool active) {
+    if (!active) {
+        // An out-of-range selection at reset starts with the output gated
+        this->update_enabled();
+    }
+}
+
+void ClockMux::update_enabled() {
+    // The output only runs when an existing input is selected and this
+    // input is not gated.
+    int selected = this->cfg.selected_clock;
+    bool enabled = selected >= 0 && selected < this->cfg.nb_clocks && this->input_enabled[selected];
+    if (enabled != this->output_enabled) {
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Output clock %s\n", enabled ? "ungated" : "gated");
+        this->output_enabled = enabled;
+        if (this->clock_en_out_itf.is_bound()) {
+            this->clock_en_out_itf.sync(enabled);
+        }
+    }
 }
 
 
@@ -53,6 +91,13 @@ void ClockMux::clock_sync(vp::Block *__this, bool active, int id) {
 void ClockMux::ctrl_sync(vp::Block *__this, int value) {
     ClockMux *_this = (ClockMux *)__this;
     _this->cfg.selected_clock = value;
+    _this->update_enabled();
+}
+
+void ClockMux::clock_en_sync(vp::Block *__this, bool enabled, int id) {
+    ClockMux *_this = (ClockMux *)__this;
+    _this->input_enabled[id] = enabled;
+    _this->update_enabled();
 }
 
 extern "C" vp::Component *gv_new(vp::ComponentConf &config) { return new ClockMux(config); }
@@ -31,3 +31,14 @@ class ClockMux(Component):
 
     def i_CLOCK_CTRL(self) -> SlaveItf:
         return SlaveItf(self, itf_name='clock_ctrl', signature='wire<int>')
+
+    def i_CLOCK_EN_IN(self, id: int) -> SlaveItf:
+        # Gating of input clock `id` (False when gated), from the upstream
+        # clock model
+        return SlaveItf(self, itf_name=f'clock_en_in_{id}', signature='wire<bool>')
+
+    def o_CLOCK_EN_OUT(self, itf: SlaveItf):
+        # Gating of the output clock (False when gated or when no existing
+        # input is selected), sent when it changes so that the components of
+        # the domain can disarm their events
+        self.itf_bind('clock_en_out', itf, signature='wire<bool>')
@@ -0,0 +1,399 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * Cache of parsed ELF binaries, for the models which read the same binaries
+ * (the ELF loaders, the ISS trace symbol resolution).
+ *
+ * An image is looked up by path and is reused as long as the file keeps the
+ * same modification time and size; a binary rebuilt in-place is parsed again.
+ * An image holds:
+ *   - the read-only mapping of the file, kept alive as long as the image is
+ *     referenced, so segment data can be pointed at directly;
+ *   - the entry point and the PT_LOAD segments, parsed on lookup;
+ *   - the address-sorted symbol and line tables of <cpu/dwarf_trace.hpp>,
+ *     parsed on first use only, so a run without tracing never pays for them.
+ *
+ * The cache is a function-local static of an inline function, so every
+ * translation unit of a library including this header uses the same one (e.g.
+ * all cores of one ISS model). Whether it is also shared by the model
+ * libraries depends on the toolchain: GCC emits it as a unique symbol, but
+ * with clang, -fno-gnu-unique or RTLD_DEEPBIND each library gets its own.
+ * To share the debug tables across libraries and runs in any case, set
+ * GV_ELF_INDEX in the environment: the tables are then saved next to the
+ * binary as <binary>.gvidx the first time they are parsed, and loaded from
+ * there afterwards as long as the binary is unchanged. A stale, foreign or
+ * unwritable index is silently ignored.
+ *
+ * Like dwarf_trace, the ELF headers are read straight from the bytes (both
+ * classes, both byte orders), without <elf.h>.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cpu/dwarf_trace.hpp>
+
+namespace elf_cache
+{
+
+// One PT_LOAD segment. `data` points into the image mapping.
+struct Segment
+{
+    uint64_t       paddr;
+    const uint8_t *data;
+    uint64_t       filesz;
+    uint64_t       memsz;
+};
+
+// Symbol and line tables, address-sorted (see dwarf_trace::load).
+struct DebugInfo
+{
+    bool valid = false;
+    std::vector<dwarf_trace::SymEntry> syms;
+    std::vector<dwarf_trace::LineRow> lines;
+};
+
+class Image
+{
+public:
+    ~Image()
+    {
+        if (this->data != nullptr)
+        {
+            munmap((void *)this->data, this->size);
+        }
+    }
+
+    const std::string &get_path() const { return this->path; }
+
+    // Debug tables, parsed (or read from the on-disk index) on first call.
+    // `valid` is false if the binary could not be read as ELF.
+    const DebugInfo &get_debug_info()
+    {
+        std::call_once(this->debug_once, [this]() {
+            if (!this->index_load())
+            {
+                this->debug.valid = dwarf_trace::load(this->data, this->size,
+                    this->debug.syms, this->debug.lines);
+                if (this->debug.valid)
+                {
+                    this->index_save();
+                }
+            }
+        });
+        return this->debug;
+    }
+
+    std::string path;
+    // Modification time in ns, so that a binary rebuilt within the same
+    // second is still seen as changed
+    int64_t     mtime_ns = 0;
+    uint64_t    size = 0;
+    const uint8_t *data = nullptr;
+
+    bool        is_32 = true;
+    uint64_t    entry = 0;
+    std::vector<Segment> segments;
+
+private:
+    static constexpr char INDEX_MAGIC[8] = { 'G', 'V', 'E', 'L', 'F', 'I', 'D', 'X' };
+    static constexpr uint32_t INDEX_VERSION = 2;
+
+    bool index_enabled() const { return getenv("GV_ELF_INDEX") != nullptr; }
+    std::string index_path() const { return this->path + ".gvidx"; }
+
+    // Index layout, host byte order: magic, version, binary mtime in ns and size,
+    // file-name table, symbols, then line rows referring to the file names
+    // by index.
+    bool index_load()
+    {
+        if (!this->index_enabled())
+        {
+            return false;
+        }
+        FILE *f = fopen(this->index_path().c_str(), "rb");
+        if (f == nullptr)
+        {
+            return false;
+        }
+
+        bool ok = false;
+        char magic[8];
+        uint32_t version;
+        int64_t mtime_ns;
+        uint64_t size, nb_files, nb_syms, nb_lines;
+        std::vector<std::string> files;
+        std::vector<dwarf_trace::SymEntry> syms;
+        std::vector<dwarf_trace::LineRow> lines;
+
+        if (fread(magic, sizeof(magic), 1, f) != 1 || memcmp(magic, INDEX_MAGIC, 8)
+            || !read_pod(f, version) || version != INDEX_VERSION
+            || !read_pod(f, mtime_ns) || mtime_ns != this->mtime_ns
+            || !read_pod(f, size) || size != this->size
+            || !read_pod(f, nb_files))
+        {
+            goto end;
+        }
+
+        for (uint64_t i = 0; i < nb_files; i++)
+        {
+            files.emplace_back();
+            if (!read_string(f, files.back())) goto end;
+        }
+
+        if (!read_pod(f, nb_syms)) goto end;
+        for (uint64_t i = 0; i < nb_syms; i++)
+        {
+            dwarf_trace::SymEntry sym;
+            if (!read_pod(f, sym.low) || !read_pod(f, sym.high) || !read_pod(f, sym.idx)
+                || !read_string(f, sym.name)) goto end;
+            syms.push_back(std::move(sym));
+        }
+
+        if (!read_pod(f, nb_lines)) goto end;
+        for (uint64_t i = 0; i < nb_lines; i++)
+        {
+            dwarf_trace::LineRow row;
+            int32_t line;
+            uint32_t file;
+            uint8_t is_end;
+            if (!read_pod(f, row.addr) || !read_pod(f, line) || !read_pod(f, file)
+                || !read_pod(f, is_end) || file >= files.size()) goto end;
+            row.line = line;
+            row.file = files[file];
+            row.end = is_end != 0;
+            lines.push_back(std::move(row));
+        }
+
+        this->debug.syms.swap(syms);
+        this->debug.lines.swap(lines);
+        this->debug.valid = true;
+        ok = true;
+
+    end:
+        fclose(f);
+        return ok;
+    }
+
+    void index_save()
+    {
+        if (!this->index_enabled())
+        {
+            return;
+        }
+
+        // Written to a temporary file and renamed, so that a concurrent run
+        // never reads a partial index.
+        std::string tmp_path = this->index_path() + "." + std::to_string(getpid());
+        FILE *f = fopen(tmp_path.c_str(), "wb");
+        if (f == nullptr)
+        {
+            return;
+        }
+
+        std::vector<const std::string *> files;
+        std::unordered_map<std::string, uint32_t> file_ids;
+        for (const dwarf_trace::LineRow &row : this->debug.lines)
+        {
+            if (file_ids.emplace(row.file, (uint32_t)files.size()).second)
+            {
+                files.push_back(&row.file);
+            }
+        }
+
+        bool ok = fwrite(INDEX_MAGIC, sizeof(INDEX_MAGIC), 1, f) == 1
+            && write_pod(f, INDEX_VERSION) && write_pod(f, this->mtime_ns)
+            && write_pod(f, this->size) && write_pod(f, (uint64_t)files.size());
+        for (const std::string *file : files)
+        {
+            ok = ok && write_string(f, *file);
+        }
+        ok = ok && write_pod(f, (uint64_t)this->debug.syms.size());
+        for (const dwarf_trace::SymEntry &sym : this->debug.syms)
+        {
+            ok = ok && write_pod(f, sym.low) && write_pod(f, sym.high)
+                && write_pod(f, sym.idx) && write_string(f, sym.name);
+        }
+        ok = ok && write_pod(f, (uint64_t)this->debug.lines.size());
+        for (const dwarf_trace::LineRow &row : this->debug.lines)
+        {
+            ok = ok && write_pod(f, row.addr) && write_pod(f, (int32_t)row.line)
+                && write_pod(f, file_ids[row.file]) && write_pod(f, (uint8_t)row.end);
+        }
+
+        if (fclose(f) != 0 || !ok || rename(tmp_path.c_str(), this->index_path().c_str()) != 0)
+        {
+            unlink(tmp_path.c_str());
+        }
+    }
+
+    template<typename T> static bool read_pod(FILE *f, T &value)
+    {
+        return fread(&value, sizeof(T), 1, f) == 1;
+    }
+
+    template<typename T> static bool write_pod(FILE *f, const T &value)
+    {
+        return fwrite(&value, sizeof(T), 1, f) == 1;
+    }
+
+    static bool read_string(FILE *f, std::string &str)
+    {
+        uint32_t len;
+        if (!read_pod(f, len) || len > (1 << 20)) return false;
+        str.resize(len);
+        return len == 0 || fread(&str[0], len, 1, f) == 1;
+    }
+
+    static bool write_string(FILE *f, const std::string &str)
+    {
+        return write_pod(f, (uint32_t)str.size())
+            && (str.empty() || fwrite(str.data(), str.size(), 1, f) == 1);
+    }
+
+    std::once_flag debug_once;
+    DebugInfo debug;
+};
+
+
+// Map the file and parse its ELF header and program headers.
+static inline bool parse_image(Image &image, int fd, std::string *error)
+{
+    if (image.size < 52)
+    {
+        *error = "file too small";
+        return false;
+    }
+
+    void *buf = mmap(NULL, image.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (buf == MAP_FAILED)
+    {
+        *error = strerror(errno);
+        return false;
+    }
+    image.data = (const uint8_t *)buf;
+
+    const uint8_t *b = image.data;
+    if (memcmp(b, "\177ELF", 4) != 0)
+    {
+        *error = "not an ELF file";
+        return false;
+    }
+
+    bool le = b[5] != 2;
+    auto r16 = [le](const uint8_t *p) -> uint64_t
+        { return le ? (p[0] | p[1] << 8) : (p[1] | p[0] << 8); };
+    auto r32 = [le](const uint8_t *p) -> uint64_t
+    {
+        return le ? ((uint32_t)p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24)
+                  : ((uint32_t)p[3] | p[2] << 8 | p[1] << 16 | (uint32_t)p[0] << 24);
+    };
+    auto r64 = [le, r32](const uint8_t *p) -> uint64_t
+        { uint64_t a = r32(p), c = r32(p + 4); return le ? (a | (c << 32)) : ((a << 32) | c); };
+
+    image.is_32 = b[4] != 2;
+    bool is64 = !image.is_32;
+    if (is64 && image.size < 64)
+    {
+        *error = "file too small";
+        return false;
+    }
+
+    image.entry = is64 ? r64(b + 0x18) : r32(b + 0x18);
+    uint64_t phoff     = is64 ? r64(b + 0x20) : r32(b + 0x1c);
+    uint64_t phentsize = is64 ? r16(b + 0x36) : r16(b + 0x2a);
+    uint64_t phnum     = is64 ? r16(b + 0x38) : r16(b + 0x2c);
+    if (phoff + phentsize * phnum > image.size)
+    {
+        *error = "truncated program headers";
+        return false;
+    }
+
+    const uint32_t PT_LOAD = 1;
+    for (uint64_t i = 0; i < phnum; i++)
+    {
+        const uint8_t *ph = b + phoff + i * phentsize;
+        if (r32(ph) != PT_LOAD)
+        {
+            continue;
+        }
+        uint64_t offset = is64 ? r64(ph + 0x08) : r32(ph + 0x04);
+        uint64_t paddr  = is64 ? r64(ph + 0x18) : r32(ph + 0x0c);
+        uint64_t filesz = is64 ? r64(ph + 0x20) : r32(ph + 0x10);
+        uint64_t memsz  = is64 ? r64(ph + 0x28) : r32(ph + 0x14);
+        if (offset + filesz > image.size)
+        {
+            *error = "segment outside of the file";
+            return false;
+        }
+        image.segments.push_back({ paddr, b + offset, filesz, memsz });
+    }
+
+    return true;
+}
+
+
+// Return the image of the binary at `path`, parsing it if it is not in the
+// cache or changed on disk since. Returns nullptr and fills `error` if the
+// file cannot be opened or is not a valid ELF file.
+inline std::shared_ptr<Image> get(const std::string &path, std::string *error)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<Image>> images;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat s;
+    if (fd < 0 || fstat(fd, &s) < 0)
+    {
+        *error = strerror(errno);
+        if (fd >= 0) close(fd);
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    int64_t mtime_ns = (int64_t)s.st_mtim.tv_sec * 1000000000 + s.st_mtim.tv_nsec;
+
+    auto it = images.find(path);
+    if (it != images.end() && it->second->mtime_ns == mtime_ns
+        && it->second->size == (uint64_t)s.st_size)
+    {
+        close(fd);
+        return it->second;
+    }
+
+    // Images replaced here stay alive as long as a user still holds them.
+    auto image = std::make_shared<Image>();
+    image->path = path;
+    image->mtime_ns = mtime_ns;
+    image->size = s.st_size;
+    bool ok = parse_image(*image, fd, error);
+    close(fd);
+    if (!ok)
+    {
+        return nullptr;
+    }
+
+    images[path] = image;
+    return image;
+}
+
+}  // namespace elf_cache
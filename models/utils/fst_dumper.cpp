@@ -23,16 +23,30 @@
  * idea as utils/fsdb_dumper.cpp; the main shape difference is that the FST
  * reader API delivers a single, globally time-sorted value-change stream via
  * fstReaderIterBlocks2, so the per-signal traversal handles + heap that
- * FSDB needs collapse into one flat sorted vector here.
+ * FSDB needs collapse into a flat sorted stream here.
+ *
+ * The stream is not loaded at once: full-chip RTL dumps would need tens of
+ * GB of RAM. A loader thread walks the file one time window at a time
+ * (fstReaderSetLimitTimeRange) and hands the decoded changes of each window
+ * to the simulation thread as a compact chunk. Only a few chunks are alive
+ * at any time and they are recycled, so memory stays bounded whatever the
+ * file size.
  */
 
 #include <vp/vp.hpp>
 #include <vp/signal.hpp>
 
+#include <utils/logic_value.hpp>
+
 #include "fstapi.h"
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -70,6 +84,11 @@ public:
     uint64_t last_flags = 0;
     std::vector<uint64_t> last_elem_values;
     std::vector<uint64_t> last_elem_flags;
+    // Decode buffers, one 64-bit (value, flags) chunk per 64 bits of the
+    // variable. Sized once at hierarchy-walk time so decoding a value change
+    // never allocates.
+    std::vector<uint64_t> values;
+    std::vector<uint64_t> flags;
     // Pre-formatted "dir|type" metadata sent through vp::Signal's description
     // field so the trace-engine forwards it to the GUI's Vcd_user proxy. Kept
     // here because vp::Event stores the description as a non-owning const
@@ -93,11 +112,29 @@ private:
     // vcd_user to the trace engine; the allocation happens in reset(false).
     void walk_hierarchy();
 
-    // Pre-load every value change in time order via fstReaderIterBlocks2.
-    // The reader streams VCs through value_change_cb (and the varlen variant
-    // for strings, which we ignore); each callback push_back's into all_vcs.
-    // This is the heaviest step (O(file size) I/O), so it runs in the
-    // constructor and overlaps with GUI startup.
+    // Value changes of one FST time window, in time order. The raw values
+    // are stored back to back in `data`, each one taking the bit_size of its
+    // signal, so an entry only holds its time and handle and the consumer
+    // finds the value by advancing a cursor.
+    struct VcChunk
+    {
+        struct Entry
+        {
+            uint64_t time_ps;
+            fstHandle handle;
+        };
+        std::vector<Entry> entries;
+        std::vector<unsigned char> data;
+        // Set on the chunk covering the end of the file.
+        bool last = false;
+    };
+
+    // Loader thread body. Iterates the value changes window by window via
+    // fstReaderSetLimitTimeRange + fstReaderIterBlocks2 and queues one chunk
+    // per window, blocking while MAX_READY_CHUNKS are waiting to be
+    // replayed. This is the heaviest step (O(file size) I/O), so it starts
+    // in the constructor and overlaps with GUI startup, and then keeps a few
+    // windows ahead of the simulation.
     void load_value_changes();
 
     static void value_change_cb(void *ud, uint64_t time, fstHandle h,
@@ -110,24 +147,18 @@ private:
     // bound by the time signal.enable() registers each event.
     void materialize_signals();
 
+    // Chunk being replayed, switching to the next one queued by the loader
+    // thread (waiting for it if needed) once the current one is exhausted.
+    // Returns nullptr once the whole file has been replayed.
+    VcChunk *current_chunk();
+
     static void event_handler(vp::Block *__this, vp::TimeEvent *event);
     // time_delay is added to the current simulated time so one handler call
     // can emit VCs that belong to multiple future timestamps; this keeps the
     // number of TimeEvent schedulings bounded even for densely-sampled FSTs.
-    void inject_value(FstSignal *sig, const std::string &raw, int64_t time_delay);
+    void inject_value(FstSignal *sig, const unsigned char *raw, int64_t time_delay);
     void enqueue_next();
 
-    // Decode an FST per-bit value buffer into one or more 64-bit (value,
-    // flags) chunks under the 4-state convention:
-    //   (flag=0,val=0/1) -> 0/1, (flag=1,val=0) -> X, (flag=1,val=1) -> Z.
-    // Chunk i (0-indexed) covers bits [(i+1)*64-1 : i*64] of the original
-    // signal (low-order chunk first). Signals wider than 64 bits therefore
-    // produce multiple chunks rather than being truncated. FST encodes one
-    // ASCII character per bit, MSB-first; the 9-state SystemVerilog letters
-    // (h/l/u/w/-) are folded into 0/1/X.
-    void decode_logic_value(const unsigned char *vc_ptr, int bit_size,
-        std::vector<uint64_t> &values, std::vector<uint64_t> &flags) const;
-
     // FST stores its timescale as a base-10 exponent (e.g. -9 = 1 ns,
     // -12 = 1 ps, -15 = 1 fs). Convert to picoseconds-per-tick, the unit
     // GVSoC's trace engine works in.
@@ -135,7 +166,11 @@ private:
 
     fstReaderContext *fst_ctx = nullptr;
     std::vector<std::string> scope_stack;
-    std::unordered_map<fstHandle, FstSignal *> signals;
+    // Signals indexed by FST handle. FST handles are dense (1 to
+    // fstReaderGetMaxHandle), so a flat vector replaces a hash lookup on
+    // every value change. Entries are nullptr for handle 0 and for the
+    // variables skipped by the hierarchy walk.
+    std::vector<FstSignal *> signals;
     // Handles in the order the hierarchy walk first encountered them
     // (= VCD/FST declaration order). materialize_signals() iterates this so
     // every signal is registered with the trace engine in the same order the
@@ -144,20 +179,38 @@ private:
     std::vector<fstHandle> signals_order;
     std::unordered_map<std::string, int> element_size_map;
 
-    // One entry per value change in the file, in monotonically increasing
-    // time order (fstReaderIterBlocks2 guarantees this). Pre-allocated in
-    // the constructor so the event-driven drain in reset(false) just walks
-    // the index. Storing the raw bytes rather than the decoded chunks keeps
-    // memory usage in line with the on-disk format and lets decode happen
-    // lazily at injection time when the dedup cache also lives.
-    struct VcEntry
-    {
-        uint64_t time_ps;
-        fstHandle handle;
-        std::string value;
-    };
-    std::vector<VcEntry> all_vcs;
-    size_t vc_index = 0;
+    // Number of decoded windows the loader thread can queue ahead of the
+    // replay, and number of value changes a window should roughly hold. The
+    // window span starts at one FST block on average and is then halved or
+    // doubled to stay around the target, since the change density of RTL
+    // dumps varies a lot over time.
+    static constexpr size_t MAX_READY_CHUNKS = 4;
+    static constexpr size_t TARGET_CHUNK_CHANGES = 1 << 20;
+
+    // Loader thread state. fst_ctx is only used by the loader thread once
+    // it is started. Storing the raw bytes rather than the decoded chunks
+    // keeps memory usage in line with the on-disk format and lets decode
+    // happen lazily at injection time when the dedup cache also lives.
+    std::thread loader_thread;
+    std::mutex chunks_mutex;
+    std::condition_variable chunks_cond;
+    std::deque<VcChunk *> ready_chunks;
+    std::vector<VcChunk *> free_chunks;
+    bool loader_stop = false;
+    // Window being loaded, only accessed by the loader thread. The reader
+    // delivers every change of the blocks overlapping the window, so
+    // value_change_cb drops the ones outside of it.
+    VcChunk *loading_chunk = nullptr;
+    uint64_t window_start = 0;
+    uint64_t window_end = 0;
+
+    // Replay state, only accessed by the simulation thread. chunk_data is
+    // the offset in chunk->data of the value of entry chunk_index.
+    VcChunk *chunk = nullptr;
+    size_t chunk_index = 0;
+    size_t chunk_data = 0;
+    bool replay_done = false;
+    uint64_t nb_replayed = 0;
 
     int64_t ps_per_tick = 1;
     bool signals_materialized = false;
@@ -211,18 +264,36 @@ FstDumper::FstDumper(vp::ComponentConf &config)
 
     this->walk_hierarchy();
 
-    // Mark every variable as wanted, then iterate. This is the heavy step;
-    // it overlaps with GUI startup so reset(false) only does cheap signal
-    // allocation + register.
+    // Mark every variable as wanted, then start iterating. This is the heavy
+    // step; it overlaps with GUI startup so reset(false) only does cheap
+    // signal allocation + register.
     fstReaderSetFacProcessMaskAll(this->fst_ctx);
-    this->load_value_changes();
+    this->loader_thread = std::thread(&FstDumper::load_value_changes, this);
 }
 
 FstDumper::~FstDumper()
 {
-    for (auto &kv : this->signals)
+    if (this->loader_thread.joinable())
     {
-        delete kv.second;
+        {
+            std::lock_guard<std::mutex> lock(this->chunks_mutex);
+            this->loader_stop = true;
+        }
+        this->chunks_cond.notify_all();
+        this->loader_thread.join();
+    }
+    delete this->chunk;
+    for (VcChunk *chunk : this->ready_chunks)
+    {
+        delete chunk;
+    }
+    for (VcChunk *chunk : this->free_chunks)
+    {
+        delete chunk;
+    }
+    for (FstSignal *sig : this->signals)
+    {
+        delete sig;
     }
     if (this->fst_ctx)
     {
@@ -254,6 +325,7 @@ void FstDumper::reset(bool active)
 
 void FstDumper::walk_hierarchy()
 {
+    this->signals.assign((size_t)fstReaderGetMaxHandle(this->fst_ctx) + 1, nullptr);
     fstReaderIterateHierRewind(this->fst_ctx);
     struct fstHier *h;
     while ((h = fstReaderIterateHier(this->fst_ctx)) != NULL)
@@ -321,6 +393,8 @@ void FstDumper::walk_hierarchy()
             sig->handle = h->u.var.handle;
             sig->full_name = full_name;
             sig->bit_size = bit_size;
+            sig->values.resize((bit_size + 63) / 64);
+            sig->flags.resize((bit_size + 63) / 64);
 
             // Encode direction and VCD type as "<dir>|<type>" so the GUI's
             // Vcd_user proxy can split it back out and populate the Dir/Type
@@ -394,10 +468,18 @@ void FstDumper::walk_hierarchy()
 
             // First time we see this handle, append it to signals_order so the
             // materialization pass below replays signals in declaration order.
-            if (this->signals.find(sig->handle) == this->signals.end())
+            if (sig->handle >= this->signals.size())
+            {
+                this->signals.resize((size_t)sig->handle + 1, nullptr);
+            }
+            if (this->signals[sig->handle] == nullptr)
             {
                 this->signals_order.push_back(sig->handle);
             }
+            else
+            {
+                delete this->signals[sig->handle];
+            }
             this->signals[sig->handle] = sig;
             break;
         }
@@ -420,36 +502,98 @@ void FstDumper::walk_hierarchy()
 
 void FstDumper::load_value_changes()
 {
-    fstReaderIterBlocks2(this->fst_ctx,
-        &FstDumper::value_change_cb,
-        &FstDumper::value_change_cb_varlen,
-        this,
-        nullptr);
-    this->trace.msg(vp::Trace::LEVEL_INFO,
-        "FST loaded %lu value changes across %lu signals\n",
-        (unsigned long)this->all_vcs.size(),
-        (unsigned long)this->signals.size());
+    uint64_t start = fstReaderGetStartTime(this->fst_ctx);
+    uint64_t end = fstReaderGetEndTime(this->fst_ctx);
+    uint64_t nb_sections = std::max<uint64_t>(
+        fstReaderGetValueChangeSectionCount(this->fst_ctx), 1);
+    uint64_t span = std::max<uint64_t>((end - start) / nb_sections, 1);
+
+    this->window_start = start;
+    while (true)
+    {
+        VcChunk *chunk;
+        {
+            std::unique_lock<std::mutex> lock(this->chunks_mutex);
+            this->chunks_cond.wait(lock, [this] {
+                return this->loader_stop || this->ready_chunks.size() < MAX_READY_CHUNKS;
+            });
+            if (this->loader_stop)
+            {
+                return;
+            }
+            if (this->free_chunks.empty())
+            {
+                chunk = new VcChunk();
+            }
+            else
+            {
+                chunk = this->free_chunks.back();
+                this->free_chunks.pop_back();
+            }
+        }
+
+        chunk->entries.clear();
+        chunk->data.clear();
+        this->window_end = end - this->window_start < span ?
+            end : this->window_start + span - 1;
+        chunk->last = this->window_end == end;
+
+        this->loading_chunk = chunk;
+        fstReaderSetLimitTimeRange(this->fst_ctx, this->window_start, this->window_end);
+        fstReaderIterBlocks2(this->fst_ctx,
+            &FstDumper::value_change_cb,
+            &FstDumper::value_change_cb_varlen,
+            this,
+            nullptr);
+        this->loading_chunk = nullptr;
+
+        size_t nb_changes = chunk->entries.size();
+        {
+            std::lock_guard<std::mutex> lock(this->chunks_mutex);
+            this->ready_chunks.push_back(chunk);
+        }
+        this->chunks_cond.notify_all();
+
+        if (chunk->last)
+        {
+            return;
+        }
+
+        this->window_start = this->window_end + 1;
+        if (nb_changes > TARGET_CHUNK_CHANGES * 2 && span > 1)
+        {
+            span /= 2;
+        }
+        else if (nb_changes < TARGET_CHUNK_CHANGES / 4 && span < end - start)
+        {
+            span *= 2;
+        }
+    }
 }
 
 void FstDumper::value_change_cb(void *ud, uint64_t time, fstHandle h,
     const unsigned char *value)
 {
     FstDumper *_this = (FstDumper *)ud;
-    auto it = _this->signals.find(h);
-    if (it == _this->signals.end())
+    // The reader delivers whole blocks, including the changes of the
+    // previous and next windows, plus an initial frame when leading blocks
+    // were skipped. Keep only the ones of the window being loaded.
+    if (time < _this->window_start || time > _this->window_end)
+    {
+        return;
+    }
+    FstSignal *sig = h < _this->signals.size() ? _this->signals[h] : nullptr;
+    if (sig == nullptr)
     {
         // Unknown handle (skipped at hierarchy walk, e.g. real type) -- drop.
         return;
     }
-    int bit_size = it->second->bit_size;
+    int bit_size = sig->bit_size;
     // The reader owns `value` only for the duration of this callback, so we
-    // must copy. std::string is a convenient byte container with SSO for
-    // narrow signals (the typical case).
-    _this->all_vcs.push_back({
-        (uint64_t)time * (uint64_t)_this->ps_per_tick,
-        h,
-        std::string((const char *)value, (size_t)bit_size)
-    });
+    // must copy it, into the chunk byte arena.
+    VcChunk *chunk = _this->loading_chunk;
+    chunk->entries.push_back({(uint64_t)time * (uint64_t)_this->ps_per_tick, h});
+    chunk->data.insert(chunk->data.end(), value, value + bit_size);
 }
 
 void FstDumper::value_change_cb_varlen(void *ud, uint64_t time, fstHandle h,
@@ -472,13 +616,11 @@ void FstDumper::materialize_signals()
     // synchronously with the GUI's Db; doing this in the constructor (or
     // from start(), which runs inside gvsoc->open() before Db::bind) would
     // take the vcd_user == NULL branch and the events would never appear.
-    // The FST value-change load already ran in the constructor, so this
+    // The FST value-change load already started in the constructor, so this
     // pass is only the cheap allocation + register step and runs fast.
     for (fstHandle handle : this->signals_order)
     {
-        auto it = this->signals.find(handle);
-        if (it == this->signals.end()) continue;
-        FstSignal *sig = it->second;
+        FstSignal *sig = this->signals[handle];
         const char *desc = sig->meta_description.empty()
             ? nullptr : sig->meta_description.c_str();
         if (sig->element_size == 0)
@@ -542,34 +684,80 @@ void FstDumper::event_handler(vp::Block *__this, vp::TimeEvent *event)
     // scheduling round-trips from millions down to a handful per second.
     constexpr int BATCH_LIMIT = 16384;
     int processed = 0;
-    while (_this->vc_index < _this->all_vcs.size() && processed < BATCH_LIMIT)
+    VcChunk *chunk;
+    while (processed < BATCH_LIMIT && (chunk = _this->current_chunk()) != nullptr)
     {
-        VcEntry &e = _this->all_vcs[_this->vc_index];
+        VcChunk::Entry &e = chunk->entries[_this->chunk_index];
         int64_t delay = (int64_t)e.time_ps - now;
         if (delay < 0)
         {
             delay = 0;
         }
-        auto it = _this->signals.find(e.handle);
-        if (it != _this->signals.end())
-        {
-            _this->inject_value(it->second, e.value, delay);
-        }
-        _this->vc_index++;
+        // The loader only keeps changes of known handles, so the entry
+        // can't be null and the value is always bit_size bytes.
+        FstSignal *sig = _this->signals[e.handle];
+        _this->inject_value(sig, &chunk->data[_this->chunk_data], delay);
+        _this->chunk_data += sig->bit_size;
+        _this->chunk_index++;
         processed++;
     }
+    _this->nb_replayed += processed;
 
     _this->enqueue_next();
 }
 
+FstDumper::VcChunk *FstDumper::current_chunk()
+{
+    while (this->chunk == nullptr || this->chunk_index == this->chunk->entries.size())
+    {
+        if (this->replay_done || this->fst_ctx == nullptr)
+        {
+            return nullptr;
+        }
+
+        std::unique_lock<std::mutex> lock(this->chunks_mutex);
+        if (this->chunk)
+        {
+            if (this->chunk->last)
+            {
+                this->replay_done = true;
+                this->trace.msg(vp::Trace::LEVEL_INFO,
+                    "FST replayed %lu value changes across %lu signals\n",
+                    (unsigned long)this->nb_replayed,
+                    (unsigned long)this->signals_order.size());
+            }
+            // Give the chunk back to the loader so its buffers are reused
+            // for the next window instead of being reallocated.
+            this->free_chunks.push_back(this->chunk);
+            this->chunk = nullptr;
+            this->chunks_cond.notify_all();
+            if (this->replay_done)
+            {
+                return nullptr;
+            }
+        }
+
+        this->chunks_cond.wait(lock, [this] { return !this->ready_chunks.empty(); });
+        this->chunk = this->ready_chunks.front();
+        this->ready_chunks.pop_front();
+        this->chunk_index = 0;
+        this->chunk_data = 0;
+        this->trace.msg(vp::Trace::LEVEL_DEBUG,
+            "Replaying window (changes: %lu, last: %d)\n",
+            (unsigned long)this->chunk->entries.size(), this->chunk->last);
+    }
+    return this->chunk;
+}
+
 void FstDumper::enqueue_next()
 {
-    if (this->vc_index >= this->all_vcs.size())
+    VcChunk *chunk = this->current_chunk();
+    if (chunk == nullptr)
     {
         this->time.get_engine()->quit(0);
         return;
     }
-    int64_t next = (int64_t)this->all_vcs[this->vc_index].time_ps;
+    int64_t next = (int64_t)chunk->entries[this->chunk_index].time_ps;
     int64_t now = this->time.get_time();
     int64_t delta = next - now;
     if (delta < 0)
@@ -579,23 +767,12 @@ void FstDumper::enqueue_next()
     this->event.enqueue(delta);
 }
 
-void FstDumper::inject_value(FstSignal *sig, const std::string &raw, int64_t time_delay)
+void FstDumper::inject_value(FstSignal *sig, const unsigned char *raw, int64_t time_delay)
 {
-    if ((int)raw.size() != sig->bit_size)
-    {
-        // Defensive: load_value_changes captured `bit_size` bytes per VC
-        // because that's what FST advertises for the var. Anything else is
-        // a reader-side bug we'd rather not silently propagate.
-        this->trace.msg(vp::Trace::LEVEL_DEBUG,
-            "VC for %s has %zu bytes but bit_size=%d; skipping\n",
-            sig->full_name.c_str(), raw.size(), sig->bit_size);
-        return;
-    }
-
-    std::vector<uint64_t> values;
-    std::vector<uint64_t> flags;
-    this->decode_logic_value((const unsigned char *)raw.data(), sig->bit_size,
-        values, flags);
+    // raw holds exactly bit_size bytes, as captured by value_change_cb.
+    uint64_t *values = sig->values.data();
+    uint64_t *flags = sig->flags.data();
+    logic_value::decode(raw, sig->bit_size, values, flags);
 
     if (sig->signal_array.size() > 0)
     {
@@ -614,7 +791,7 @@ void FstDumper::inject_value(FstSignal *sig, const std::string &raw, int64_t tim
             int bit_in_chunk = bit_lo % 64;
             uint64_t v_slice = 0;
             uint64_t f_slice = 0;
-            if (chunk_idx < (int)values.size())
+            if (chunk_idx < (int)sig->values.size())
             {
                 v_slice = (values[chunk_idx] >> bit_in_chunk) & mask;
                 f_slice = (flags[chunk_idx] >> bit_in_chunk) & mask;
@@ -626,76 +803,30 @@ void FstDumper::inject_value(FstSignal *sig, const std::string &raw, int64_t tim
             }
             sig->last_elem_values[i] = v_slice;
             sig->last_elem_flags[i] = f_slice;
+            this->trace.msg(vp::Trace::LEVEL_DEBUG,
+                "Setting signal (name: %s[%d], value: 0x%lx, flags: 0x%lx, time: %ld)\n",
+                sig->full_name.c_str(), i, v_slice, f_slice,
+                this->time.get_time() + time_delay);
             sig->signal_array[i]->set(v_slice, f_slice, 0, time_delay);
         }
     }
     else if (sig->signal)
     {
         // Scalar (<=64 bits) -- decoder produced exactly one chunk.
-        uint64_t v = values.empty() ? 0 : values[0];
-        uint64_t f = flags.empty() ? 0 : flags[0];
+        uint64_t v = values[0];
+        uint64_t f = flags[0];
         if (v != sig->last_value || f != sig->last_flags)
         {
             sig->last_value = v;
             sig->last_flags = f;
+            this->trace.msg(vp::Trace::LEVEL_DEBUG,
+                "Setting signal (name: %s, value: 0x%lx, flags: 0x%lx, time: %ld)\n",
+                sig->full_name.c_str(), v, f, this->time.get_time() + time_delay);
             sig->signal->set(v, f, 0, time_delay);
         }
     }
 }
 
-void FstDumper::decode_logic_value(const unsigned char *vc_ptr, int bit_size,
-    std::vector<uint64_t> &values, std::vector<uint64_t> &flags) const
-{
-    // vc_ptr[0] is MSB, vc_ptr[bit_size-1] is LSB (matches GTKWave's display
-    // order). Each byte is one ASCII character: '0'/'1'/'x'/'z' for the
-    // 4-state model, plus the SystemVerilog 9-state extras h/l/u/w/-, which
-    // we fold into the 4-state encoding the GUI consumes.
-    int nb_chunks = bit_size > 0 ? (bit_size + 63) / 64 : 0;
-    values.assign(nb_chunks, 0);
-    flags.assign(nb_chunks, 0);
-
-    for (int i = 0; i < bit_size; i++)
-    {
-        int bit_from_lsb = bit_size - 1 - i;
-        int chunk_idx = bit_from_lsb / 64;
-        int bit_in_chunk = bit_from_lsb % 64;
-        uint64_t mask = (uint64_t)1 << bit_in_chunk;
-        unsigned char c = vc_ptr[i];
-        switch (c)
-        {
-        case '0':
-            break;
-        case '1':
-            values[chunk_idx] |= mask;
-            break;
-        case 'x': case 'X':
-            flags[chunk_idx] |= mask;
-            break;
-        case 'z': case 'Z':
-            values[chunk_idx] |= mask;
-            flags[chunk_idx] |= mask;
-            break;
-        case 'h': case 'H':
-            // weak high -> 1
-            values[chunk_idx] |= mask;
-            break;
-        case 'l': case 'L':
-            // weak low -> 0
-            break;
-        case 'u': case 'U':
-        case 'w': case 'W':
-        case '-':
-            // uninit / weak unknown / dontcare -> X
-            flags[chunk_idx] |= mask;
-            break;
-        default:
-            // Unknown FST value byte -- treat as X so it's visible.
-            flags[chunk_idx] |= mask;
-            break;
-        }
-    }
-}
-
 int64_t FstDumper::exponent_to_ps_per_tick(signed char exponent)
 {
     // FST exponent: 0 = 1 s, -3 = 1 ms, -6 = 1 us, -9 = 1 ns, -12 = 1 ps,
@@ -0,0 +1,325 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * Host-time profiler of the model callbacks, to find out which components of
+ * a platform consume the host CPU.
+ *
+ * A component gets a counter with host_profiler::counter() at construction
+ * and opens a host_profiler::Scope at the top of its hot callbacks (request
+ * handlers, clock event handlers). Each counter accumulates, per component
+ * instance:
+ *   - the number of callbacks;
+ *   - their total host time;
+ *   - their self time, i.e. the total time minus the time spent in the
+ *     scopes of other components called synchronously (e.g. a router
+ *     forwarding a request to a memory).
+ * Times are taken with the CPU timestamp counter and converted to ns at the
+ * end of the run, against the steady clock.
+ *
+ * Profiling is enabled by setting GV_HOST_PROFILE in the environment. Its
+ * value is the path of the report, or 1 to print it on stderr. The report is
+ * written when the process exits, sorted by decreasing self time. When
+ * profiling is disabled, counter() returns nullptr and a scope costs a single
+ * test.
+ *
+ * The registry is a function-local static of an inline function. Whether it
+ * is shared by the model libraries depends on the toolchain: GCC emits it as
+ * a unique symbol, but with clang, -fno-gnu-unique or RTLD_DEEPBIND each
+ * library gets its own. Each registry therefore merges its counters into the
+ * report file under an exclusive lock, and the report starts over when it
+ * was written by another process. On stderr, one table is printed per
+ * registry. With one registry per library, the scopes of another library
+ * are not seen as nested, so their time also counts as self time of the
+ * caller. Scopes must only be opened from the simulation thread.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace host_profiler
+{
+
+static inline uint64_t read_ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+class Scope;
+
+struct Counter
+{
+    std::string path;
+    std::string kind;
+    uint64_t calls = 0;
+    uint64_t total_ticks = 0;
+    uint64_t self_ticks = 0;
+};
+
+class Registry
+{
+public:
+    Registry()
+    {
+        const char *env = getenv("GV_HOST_PROFILE");
+        this->enabled = env != nullptr && env[0] != '\0';
+        if (this->enabled && strcmp(env, "1") != 0)
+        {
+            this->report_path = env;
+        }
+        this->start_ticks = read_ticks();
+        this->start_time = std::chrono::steady_clock::now();
+    }
+
+    ~Registry()
+    {
+        if (this->enabled && !this->counters.empty())
+        {
+            this->dump();
+        }
+    }
+
+    Counter *get(const std::string &path, const std::string &kind)
+    {
+        if (!this->enabled) return nullptr;
+
+        auto it = this->by_path.find(path);
+        if (it != this->by_path.end()) return it->second;
+
+        // Deque so that the counters already handed out never move
+        Counter *counter = &this->counters.emplace_back();
+        counter->path = path;
+        counter->kind = kind;
+        this->by_path[path] = counter;
+        return counter;
+    }
+
+    void dump()
+    {
+        uint64_t ticks = read_ticks() - this->start_ticks;
+        double wall_ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - this->start_time).count();
+        double ns_per_tick = ticks ? wall_ns / ticks : 0.0;
+
+        std::map<std::string, Row> rows;
+        for (Counter &counter : this->counters)
+        {
+            if (counter.calls == 0) continue;
+            Row &row = rows[counter.path];
+            row.kind = counter.kind;
+            row.calls += counter.calls;
+            row.self_ns += counter.self_ticks * ns_per_tick;
+            row.total_ns += counter.total_ticks * ns_per_tick;
+        }
+
+        if (this->report_path.empty())
+        {
+            print(stderr, rows, wall_ns);
+            return;
+        }
+
+        // Several registries of the process may write the report, each one
+        // merges its rows with the ones already there.
+        int fd = open(this->report_path.c_str(), O_RDWR | O_CREAT, 0644);
+        FILE *file = fd == -1 ? nullptr : fdopen(fd, "r+");
+        if (file == nullptr)
+        {
+            fprintf(stderr, "[host_profiler] Unable to open report %s: %s\n",
+                this->report_path.c_str(), strerror(errno));
+            if (fd != -1) close(fd);
+            return;
+        }
+        flock(fd, LOCK_EX);
+
+        parse(file, rows, wall_ns);
+
+        rewind(file);
+        if (ftruncate(fd, 0) == 0)
+        {
+            print(file, rows, wall_ns);
+        }
+        fflush(file);
+        flock(fd, LOCK_UN);
+        fclose(file);
+    }
+
+    // Innermost open scope, to attribute nested time to the right counter
+    Scope *current = nullptr;
+
+private:
+    struct Row
+    {
+        std::string kind;
+        uint64_t calls = 0;
+        double self_ns = 0.0;
+        double total_ns = 0.0;
+    };
+
+    // Add to `rows` the rows of a report written by this process, if
+    // `file` holds one. The wall time is the one of the longest registry.
+    static void parse(FILE *file, std::map<std::string, Row> &rows, double &wall_ns)
+    {
+        char line[4096];
+        int pid;
+        double self_ms, wall_ms;
+        size_t nb_rows;
+        if (fgets(line, sizeof(line), file) == nullptr
+            || sscanf(line, "Host time profile (pid %d): %lf ms in %zu components, %lf ms wall",
+                &pid, &self_ms, &nb_rows, &wall_ms) != 4
+            || pid != getpid())
+        {
+            return;
+        }
+        wall_ns = std::max(wall_ns, wall_ms * 1e6);
+
+        // Column headers
+        if (fgets(line, sizeof(line), file) == nullptr) return;
+
+        while (fgets(line, sizeof(line), file) != nullptr)
+        {
+            double total_ms, percent, ns_per_call;
+            uint64_t calls;
+            char kind[256];
+            int path_pos;
+            if (sscanf(line, "%lf %lf%% %lf %" SCNu64 " %lf %255s %n", &self_ms, &percent,
+                &total_ms, &calls, &ns_per_call, kind, &path_pos) != 6)
+            {
+                continue;
+            }
+            std::string path(line + path_pos);
+            while (!path.empty() && (path.back() == '\n' || path.back() == '\r'))
+            {
+                path.pop_back();
+            }
+            Row &row = rows[path];
+            row.kind = kind;
+            row.calls += calls;
+            row.self_ns += self_ms * 1e6;
+            row.total_ns += total_ms * 1e6;
+        }
+    }
+
+    static void print(FILE *file, const std::map<std::string, Row> &rows, double wall_ns)
+    {
+        std::vector<std::pair<const std::string *, const Row *>> sorted;
+        double self_ns = 0.0;
+        for (auto &it : rows)
+        {
+            sorted.emplace_back(&it.first, &it.second);
+            self_ns += it.second.self_ns;
+        }
+        std::sort(sorted.begin(), sorted.end(), [](auto &a, auto &b)
+        {
+            return a.second->self_ns > b.second->self_ns;
+        });
+
+        fprintf(file, "Host time profile (pid %d): %.3f ms in %zu components, %.3f ms wall\n",
+            (int)getpid(), self_ns / 1e6, sorted.size(), wall_ns / 1e6);
+        fprintf(file, "%12s %7s %12s %12s %10s  %-16s %s\n", "self (ms)", "self %",
+            "total (ms)", "calls", "ns/call", "kind", "component");
+        for (auto &it : sorted)
+        {
+            const Row *row = it.second;
+            fprintf(file, "%12.3f %6.2f%% %12.3f %12" PRIu64 " %10.1f  %-16s %s\n",
+                row->self_ns / 1e6, self_ns > 0 ? 100.0 * row->self_ns / self_ns : 0.0,
+                row->total_ns / 1e6, row->calls, row->self_ns / row->calls,
+                row->kind.c_str(), it.first->c_str());
+        }
+    }
+
+    bool enabled;
+    std::string report_path;
+    uint64_t start_ticks;
+    std::chrono::steady_clock::time_point start_time;
+    std::deque<Counter> counters;
+    std::map<std::string, Counter *> by_path;
+};
+
+inline Registry &registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+// Return the counter of the component at `path`, or nullptr if profiling is
+// disabled. Components sharing a path (e.g. the blocks of one core) share the
+// counter; `kind` is only used in the report.
+inline Counter *counter(const std::string &path, const std::string &kind)
+{
+    return registry().get(path, kind);
+}
+
+// Account the host time from construction to destruction to `counter`, if
+// not null.
+class Scope
+{
+public:
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    inline Scope(Counter *counter) : counter(counter)
+    {
+        if (__builtin_expect(counter != nullptr, 0))
+        {
+            Registry &reg = registry();
+            this->parent = reg.current;
+            reg.current = this;
+            this->start = read_ticks();
+        }
+    }
+
+    inline ~Scope()
+    {
+        if (__builtin_expect(this->counter != nullptr, 0))
+        {
+            uint64_t elapsed = read_ticks() - this->start;
+            this->counter->calls++;
+            this->counter->total_ticks += elapsed;
+            this->counter->self_ticks += elapsed - this->child_ticks;
+            if (this->parent)
+            {
+                this->parent->child_ticks += elapsed;
+            }
+            registry().current = this->parent;
+        }
+    }
+
+private:
+    Counter *counter;
+    Scope *parent = nullptr;
+    uint64_t start = 0;
+    uint64_t child_ticks = 0;
+};
+
+}  // namespace host_profiler
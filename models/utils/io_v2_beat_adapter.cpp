@@ -16,6 +16,7 @@ IoV2BeatAdapter::IoV2BeatAdapter(vp::ComponentConf &config)
       fsm_event(this, &IoV2BeatAdapter::fsm_handler)
 {
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->host_prof = host_profiler::counter(this->get_path(), "io_v2_beat_adapter");
 
     this->beat_width = this->get_js_config()->get_child_int("beat_width");
     if (this->beat_width <= 0)
@@ -32,6 +33,7 @@ IoV2BeatAdapter::IoV2BeatAdapter(vp::ComponentConf &config)
 vp::IoReqStatus IoV2BeatAdapter::req_handler(vp::Block *__this, vp::IoReq *req)
 {
     auto *self = static_cast<IoV2BeatAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
     uint64_t size = req->get_size();
 
     self->trace.msg(vp::Trace::LEVEL_TRACE,
@@ -90,6 +92,7 @@ vp::IoReqStatus IoV2BeatAdapter::req_handler(vp::Block *__this, vp::IoReq *req)
 vp::IoRespAck IoV2BeatAdapter::resp_handler(vp::Block *__this, vp::IoReq *req)
 {
     auto *self = static_cast<IoV2BeatAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
 
     // The adapter always accepts the downstream response (it buffers it and
     // paces the upstream stream itself), so it never back-pressures downstream.
@@ -121,6 +124,7 @@ vp::IoRespAck IoV2BeatAdapter::resp_handler(vp::Block *__this, vp::IoReq *req)
 void IoV2BeatAdapter::retry_handler(vp::Block *__this, vp::IoRetryChannel channel)
 {
     auto *self = static_cast<IoV2BeatAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
 
     // A held downstream read sub-request can now be re-issued. The io_v2
     // contract requires the re-send to happen synchronously inside retry().
@@ -440,6 +444,7 @@ void IoV2BeatAdapter::resp_retry_in_handler(vp::Block *__this,
                                             vp::IoRetryChannel /*channel*/)
 {
     auto *self = static_cast<IoV2BeatAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
     if (!self->resp_held)
     {
         return;
@@ -462,6 +467,7 @@ void IoV2BeatAdapter::resp_retry_in_handler(vp::Block *__this,
 void IoV2BeatAdapter::fsm_handler(vp::Block *__this, vp::ClockEvent *)
 {
     auto *self = static_cast<IoV2BeatAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
     int64_t now = self->clock.get_cycles();
 
     // Emit any upstream beats that are due this cycle. Stop the instant a beat
@@ -47,6 +47,7 @@
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
 #include <vp/debug_mem.hpp>
+#include <utils/host_profiler.hpp>
 
 
 class IoV2BeatAdapter : public vp::Component, public vp::DebugMemIf
@@ -199,4 +200,5 @@ private:
     vp::IoReq *held_req = nullptr;
 
     vp::Trace trace;
+    host_profiler::Counter *host_prof;
 };
@@ -43,6 +43,7 @@
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
 #include <vp/debug_mem.hpp>
+#include <utils/host_profiler.hpp>
 
 class IoV2BeatCollapseAdapter : public vp::Component, public vp::DebugMemIf
 {
@@ -66,6 +67,7 @@ private:
     void maybe_retry_input();
 
     vp::Trace trace;
+    host_profiler::Counter *host_prof;
 
     vp::IoSlave  in{&IoV2BeatCollapseAdapter::in_req};
     vp::IoMaster out{&IoV2BeatCollapseAdapter::out_retry,
@@ -89,6 +91,7 @@ IoV2BeatCollapseAdapter::IoV2BeatCollapseAdapter(vp::ComponentConf &config)
     : vp::Component(config)
 {
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->host_prof = host_profiler::counter(this->get_path(), "io_v2_beat_collapse");
     this->new_slave_port("input", &this->in);
     this->new_master_port("output", &this->out);
 }
@@ -116,6 +119,7 @@ void IoV2BeatCollapseAdapter::maybe_retry_input()
 vp::IoReqStatus IoV2BeatCollapseAdapter::in_req(vp::Block *__this, vp::IoReq *req)
 {
     auto *self = static_cast<IoV2BeatCollapseAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
 
     // Single outstanding: refuse while busy; retried on completion.
     if (self->pending != nullptr)
@@ -179,6 +183,7 @@ vp::IoReqStatus IoV2BeatCollapseAdapter::in_req(vp::Block *__this, vp::IoReq *re
 vp::IoRespAck IoV2BeatCollapseAdapter::out_resp(vp::Block *__this, vp::IoReq *req)
 {
     auto *self = static_cast<IoV2BeatCollapseAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
     vp::IoReq *master = self->pending;
 
     // Two response shapes reach us, both owned by us as the consumer:
@@ -217,6 +222,7 @@ vp::IoRespAck IoV2BeatCollapseAdapter::out_resp(vp::Block *__this, vp::IoReq *re
 void IoV2BeatCollapseAdapter::out_retry(vp::Block *__this, vp::IoRetryChannel)
 {
     auto *self = static_cast<IoV2BeatCollapseAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
     // The downstream that denied our forward is ready again. If we owe the
     // master a retry and can accept now, let it re-send (synchronously).
     self->maybe_retry_input();
@@ -49,6 +49,7 @@ IoV2BeatToSingleReqAdapter::IoV2BeatToSingleReqAdapter(vp::ComponentConf &config
       fsm_event(this, &IoV2BeatToSingleReqAdapter::fsm_handler)
 {
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->host_prof = host_profiler::counter(this->get_path(), "io_v2_beat_to_single");
 
     this->beat_width = (int)this->cfg.beat_width;
     if (this->beat_width <= 0)
@@ -77,6 +78,7 @@ IoV2BeatToSingleReqAdapter::IoV2BeatToSingleReqAdapter(vp::ComponentConf &config
 vp::IoReqStatus IoV2BeatToSingleReqAdapter::req_handler(vp::Block *__this, vp::IoReq *req)
 {
     auto *self = static_cast<IoV2BeatToSingleReqAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
     uint64_t size = req->get_size();
 
     self->trace.msg(vp::Trace::LEVEL_TRACE,
@@ -150,6 +152,7 @@ vp::IoReqStatus IoV2BeatToSingleReqAdapter::req_handler(vp::Block *__this, vp::I
 vp::IoRespAck IoV2BeatToSingleReqAdapter::resp_handler(vp::Block *__this, vp::IoReq *req)
 {
     auto *self = static_cast<IoV2BeatToSingleReqAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
 
     // The adapter always accepts the downstream response (it buffers it and paces
     // the upstream stream itself), so it never back-pressures downstream.
@@ -188,6 +191,7 @@ vp::IoRespAck IoV2BeatToSingleReqAdapter::resp_handler(vp::Block *__this, vp::Io
 void IoV2BeatToSingleReqAdapter::retry_handler(vp::Block *__this, vp::IoRetryChannel channel)
 {
     auto *self = static_cast<IoV2BeatToSingleReqAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
 
     // A denied downstream sub-read can now be re-issued. The io_v2 contract
     // requires the re-send to happen synchronously inside retry(). issued_beats
@@ -548,6 +552,7 @@ void IoV2BeatToSingleReqAdapter::resp_retry_in_handler(vp::Block *__this,
                                             vp::IoRetryChannel /*channel*/)
 {
     auto *self = static_cast<IoV2BeatToSingleReqAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
     if (!self->resp_held)
     {
         return;
@@ -593,6 +598,7 @@ void IoV2BeatToSingleReqAdapter::resp_retry_in_handler(vp::Block *__this,
 void IoV2BeatToSingleReqAdapter::fsm_handler(vp::Block *__this, vp::ClockEvent *)
 {
     auto *self = static_cast<IoV2BeatToSingleReqAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
     int64_t now = self->clock.get_cycles();
 
     // Emit due read beats. Stop the instant one is back-pressured (resp_held):
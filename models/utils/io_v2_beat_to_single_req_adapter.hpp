@@ -85,6 +85,7 @@
 // Generated from the IoV2BeatToSingleReqAdapterConfig dataclass in the Python
 // generator (config tree). Provides struct IoV2BeatToSingleReqAdapterConfig.
 #include <utils/io_v2_beat_to_single_req_adapter/io_v2_beat_to_single_req_adapter_config.hpp>
+#include <utils/host_profiler.hpp>
 
 
 class IoV2BeatToSingleReqAdapter : public vp::Component, public vp::DebugMemIf
@@ -263,4 +264,5 @@ private:
     bool held_write = false;
 
     vp::Trace trace;
+    host_profiler::Counter *host_prof;
 };
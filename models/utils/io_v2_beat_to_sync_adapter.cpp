@@ -16,6 +16,7 @@ IoV2BeatToSyncAdapter::IoV2BeatToSyncAdapter(vp::ComponentConf &config)
       fsm_event(this, &IoV2BeatToSyncAdapter::fsm_handler)
 {
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->host_prof = host_profiler::counter(this->get_path(), "io_v2_beat_to_sync");
 
     this->beat_width = this->get_js_config()->get_child_int("beat_width");
     if (this->beat_width <= 0)
@@ -32,6 +33,7 @@ IoV2BeatToSyncAdapter::IoV2BeatToSyncAdapter(vp::ComponentConf &config)
 vp::IoReqStatus IoV2BeatToSyncAdapter::req_handler(vp::Block *__this, vp::IoReq *req)
 {
     auto *self = static_cast<IoV2BeatToSyncAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
 
     self->trace.msg(vp::Trace::LEVEL_TRACE,
         "Submit (req=%p, addr=0x%lx, size=%lu, write=%d, burst_id=%ld)\n",
@@ -126,6 +128,7 @@ void IoV2BeatToSyncAdapter::resp_retry_in_handler(vp::Block *__this,
                                                 vp::IoRetryChannel /*channel*/)
 {
     auto *self = static_cast<IoV2BeatToSyncAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
     if (!self->resp_held)
     {
         return;
@@ -155,6 +158,7 @@ void IoV2BeatToSyncAdapter::resp_retry_in_handler(vp::Block *__this,
 void IoV2BeatToSyncAdapter::fsm_handler(vp::Block *__this, vp::ClockEvent *)
 {
     auto *self = static_cast<IoV2BeatToSyncAdapter *>(__this);
+    host_profiler::Scope prof(self->host_prof);
 
     // Blocked on upstream back-pressure: the held beat must be re-sent first
     // (from resp_retry_in_handler), so don't stream anything now.
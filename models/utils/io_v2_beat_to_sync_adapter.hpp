@@ -42,6 +42,7 @@
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
 #include <vp/debug_mem.hpp>
+#include <utils/host_profiler.hpp>
 
 
 class IoV2BeatToSyncAdapter : public vp::Component, public vp::DebugMemIf
@@ -106,4 +107,5 @@ private:
     uint64_t  held_beat = 0;
 
     vp::Trace trace;
+    host_profiler::Counter *host_prof;
 };
@@ -6,6 +6,8 @@
 
 #include "io_v2_clock_bridge.hpp"
 
+#include <algorithm>
+
 
 IoV2ClockBridge::IoV2ClockBridge(vp::ComponentConf &config)
     : vp::Component(config)
@@ -22,12 +24,28 @@ IoV2ClockBridge::IoV2ClockBridge(vp::ComponentConf &config)
         this->k_dst_per_dir = c->get_int();
     if (js::Config *c = js->get("depth"); c != nullptr)
         this->depth = c->get_int();
+    if (js::Config *c = js->get("analytic"); c != nullptr)
+        this->analytic = c->get_bool();
 
     if (this->k_src_per_dir < 0) this->k_src_per_dir = 0;
     if (this->k_dst_per_dir < 0) this->k_dst_per_dir = 0;
     if (this->depth < 1) this->depth = 1;
 
     this->parametric = (this->k_src_per_dir > 0 || this->k_dst_per_dir > 0);
+    this->analytic = this->analytic && this->parametric;
+    this->done_times.resize(this->depth, -1);
+    // Stage FIFOs sized on the crossing window, so that they don't allocate
+    // during the run.
+    this->resp_queue.reserve(this->depth);
+    this->fwd_src_queue.reserve(this->depth);
+    this->fwd_dst_queue.reserve(this->depth);
+    this->rev_src_queue.reserve(this->depth);
+    this->rev_dst_queue.reserve(this->depth);
+
+    this->stats.register_stat(&this->stat_analytic_txns, "analytic_txns",
+        "Transactions whose crossing was computed analytically");
+    this->stats.register_stat(&this->stat_evented_txns, "evented_txns",
+        "Transactions whose crossing was modeled with stage events");
 
     if (this->parametric)
     {
@@ -56,12 +74,14 @@ void IoV2ClockBridge::start()
                           master_port != nullptr, slave_port != nullptr);
         return;
     }
-    this->master_engine = master_port->get_owner()->clock.get_engine();
-    this->slave_engine  = slave_port->get_owner()->clock.get_engine();
+    this->master_block = master_port->get_owner();
+    this->slave_block  = slave_port->get_owner();
+    this->master_engine = this->master_block->clock.get_engine();
+    this->slave_engine  = this->slave_block->clock.get_engine();
 
     this->trace.msg(vp::Trace::LEVEL_INFO,
         "bridge mode=%s k_src=%d k_dst=%d depth=%d\n",
-        this->parametric ? "parametric" : "sync_only",
+        this->analytic ? "analytic" : this->parametric ? "parametric" : "sync_only",
         this->k_src_per_dir, this->k_dst_per_dir, this->depth);
 }
 
@@ -91,13 +111,22 @@ void IoV2ClockBridge::reset(bool active)
     this->rev_src_queue.clear();
     this->rev_dst_queue.clear();
     this->retry_owed = false;
+
+    this->last_fwd_src_time = -1;
+    this->last_fwd_dst_time = -1;
+    this->last_rev_src_time = -1;
+    this->last_rev_dst_time = -1;
+    std::fill(this->done_times.begin(), this->done_times.end(), -1);
+    this->done_times_index = 0;
+    this->analytic_retry_owed = false;
+    this->slave_pending = 0;
 }
 
 
 // ---- Helpers (parametric path) --------------------------------------------
 
 void IoV2ClockBridge::reschedule_event(vp::ClockEvent &ev,
-                                        const std::deque<Txn> &queue,
+                                        const RingBuffer<Txn> &queue,
                                         vp::ClockEngine *engine)
 {
     if (ev.is_enqueued()) engine->cancel(&ev);
@@ -109,7 +138,7 @@ void IoV2ClockBridge::reschedule_event(vp::ClockEvent &ev,
 }
 
 
-void IoV2ClockBridge::enqueue_in(std::deque<Txn> &queue, vp::IoReq *req,
+void IoV2ClockBridge::enqueue_in(RingBuffer<Txn> &queue, vp::IoReq *req,
                                   int64_t now_cycle, int min_spacing_cycles)
 {
     int64_t deadline = now_cycle;
@@ -123,6 +152,96 @@ void IoV2ClockBridge::enqueue_in(std::deque<Txn> &queue, vp::IoReq *req,
 }
 
 
+int IoV2ClockBridge::in_flight()
+{
+    return (int)(this->fwd_src_queue.size() + this->fwd_dst_queue.size()
+                 + this->rev_src_queue.size() + this->rev_dst_queue.size())
+           + this->slave_pending;
+}
+
+
+// ---- Analytic path ----------------------------------------------------------
+
+// First edge of a clock of period `period` at or after `time`. Integer-ratio
+// clocks are assumed to share their edge at time 0.
+static inline int64_t align_up(int64_t time, int64_t period)
+{
+    return ((time + period - 1) / period) * period;
+}
+
+bool IoV2ClockBridge::analytic_req(vp::IoReq *req, vp::IoReqStatus &status)
+{
+    int64_t pm = this->master_block->clock.get_period();
+    int64_t ps = this->slave_block->clock.get_period();
+
+    // Evented transactions still in the stages would be overtaken, and a
+    // fractional ratio makes the stage boundaries drift with respect to the
+    // events, so both go through the evented path. The path must be chosen
+    // before forwarding, so it is only taken while the slave has always
+    // answered inline.
+    if (this->slave_async || this->in_flight() != 0 || pm <= 0 || ps <= 0
+        || (pm % ps != 0 && ps % pm != 0))
+    {
+        return false;
+    }
+
+    // Walk the four stages in absolute time, each one starting on an edge of its
+    // clock and keeping one cycle between consecutive transactions, as the
+    // stage FIFOs of the evented path do.
+    int64_t now = align_up(this->time.get_time(), pm);
+    int64_t &oldest_done = this->done_times[this->done_times_index];
+    int64_t enter = std::max(now, oldest_done);
+
+    int64_t fwd_src = std::max(enter + this->k_src_per_dir * pm, this->last_fwd_src_time + pm);
+    int64_t fwd_dst = std::max(align_up(fwd_src, ps) + this->k_dst_per_dir * ps,
+                               this->last_fwd_dst_time + ps);
+
+    this->slave_engine->sync();
+
+    int64_t lat_in = req->get_latency();
+    req->set_latency(0);
+    status = this->out.req(req);
+
+    if (status == vp::IO_REQ_DENIED)
+    {
+        req->set_latency(lat_in);
+        this->analytic_retry_owed = true;
+        return true;
+    }
+
+    if (status == vp::IO_REQ_GRANTED)
+    {
+        // The slave turned out to answer asynchronously. It already got the
+        // request now instead of after the forward stages, so their crossing
+        // is charged on the response, which then goes through the evented
+        // reverse stages from out_resp_handler. The request is counted as in
+        // flight until then, and later ones take the evented path.
+        req->set_latency(lat_in + (fwd_dst - now) / pm);
+        this->slave_async = true;
+        this->slave_pending++;
+        this->stat_evented_txns++;
+        return true;
+    }
+
+    int64_t slave_done = fwd_dst + req->get_latency() * ps;
+    int64_t rev_src = std::max(slave_done + this->k_src_per_dir * ps, this->last_rev_src_time + ps);
+    int64_t rev_dst = std::max(align_up(rev_src, pm) + this->k_dst_per_dir * pm,
+                               this->last_rev_dst_time + pm);
+
+    this->last_fwd_src_time = fwd_src;
+    this->last_fwd_dst_time = fwd_dst;
+    this->last_rev_src_time = rev_src;
+    this->last_rev_dst_time = rev_dst;
+    oldest_done = rev_dst;
+    this->done_times_index = (this->done_times_index + 1) % this->depth;
+
+    req->set_latency(lat_in + (rev_dst - now) / pm);
+    this->stat_analytic_txns++;
+
+    return true;
+}
+
+
 // ---- v2 IO callbacks (branch on parametric) ------------------------------
 
 vp::IoReqStatus IoV2ClockBridge::in_req_handler(vp::Block *__this, vp::IoReq *req)
@@ -136,17 +255,24 @@ vp::IoReqStatus IoV2ClockBridge::in_req_handler(vp::Block *__this, vp::IoReq *re
         return self->out.req(req);
     }
 
+    if (self->analytic)
+    {
+        vp::IoReqStatus status;
+        if (self->analytic_req(req, status))
+        {
+            return status;
+        }
+    }
+
     // Parametric path: depth gate + enqueue in fwd_src.
-    int in_flight = (int)(self->fwd_src_queue.size()
-                          + self->fwd_dst_queue.size()
-                          + self->rev_src_queue.size()
-                          + self->rev_dst_queue.size());
-    if (in_flight >= self->depth)
+    if (self->in_flight() >= self->depth)
     {
         self->retry_owed = true;
         return vp::IO_REQ_DENIED;
     }
 
+    self->stat_evented_txns++;
+
     int64_t now_master = self->master_engine->get_cycles();
     int64_t deadline = now_master + self->k_src_per_dir;
     if (!self->fwd_src_queue.empty())
@@ -179,6 +305,10 @@ vp::IoRespAck IoV2ClockBridge::out_resp_handler(vp::Block *__this, vp::IoReq *re
         return vp::IO_RESP_ACCEPTED;
     }
 
+    // The slave answered asynchronously, the request moves from the pending
+    // count to the reverse stages.
+    self->slave_pending--;
+
     int64_t now_slave = self->slave_engine->get_cycles();
     self->enqueue_in(self->rev_src_queue, req,
                      now_slave + self->k_src_per_dir, 1);
@@ -200,6 +330,15 @@ void IoV2ClockBridge::out_retry_handler(vp::Block *__this, vp::IoRetryChannel ch
         self->in.retry(channel);
         return;
     }
+    if (self->analytic_retry_owed)
+    {
+        // The downstream denied an analytic forward, the upstream can now try
+        // again.
+        self->analytic_retry_owed = false;
+        self->master_engine->sync();
+        self->in.retry(channel);
+        return;
+    }
     // Downstream became ready after DENIED β€” unused for sync-DONE slaves.
 }
 
@@ -263,7 +402,13 @@ void IoV2ClockBridge::fwd_dst_done_handler(vp::Block *_this, vp::ClockEvent *)
             self->enqueue_in(self->rev_src_queue, t.req,
                              now_slave + self->k_src_per_dir, 1);
         }
-        // GRANTED: out_resp_handler will handle. DENIED: not modeled.
+        else if (st == vp::IO_REQ_GRANTED)
+        {
+            // out_resp_handler will handle it.
+            self->slave_async = true;
+            self->slave_pending++;
+        }
+        // DENIED: not modeled.
     }
 
     self->reschedule_event(*self->fwd_dst_event, self->fwd_dst_queue,
@@ -310,11 +455,7 @@ void IoV2ClockBridge::rev_dst_done_handler(vp::Block *_this, vp::ClockEvent *)
 
     if (self->retry_owed)
     {
-        int in_flight = (int)(self->fwd_src_queue.size()
-                              + self->fwd_dst_queue.size()
-                              + self->rev_src_queue.size()
-                              + self->rev_dst_queue.size());
-        if (in_flight < self->depth)
+        if (self->in_flight() < self->depth)
         {
             self->retry_owed = false;
             self->in.retry();
@@ -35,6 +35,22 @@
  *     `depth` caps total in-flight across all four stages. depth=1 is
  *     strictly serial; depth>1 lets FIFO kinds pipeline.
  *
+ *   analytic = true (parametric kinds only):
+ *     Zero-event variant of the parametric model. When the two clocks are
+ *     integer-ratio related, the stage FIFOs are empty and the downstream
+ *     slave answers the forwarded req with IO_REQ_DONE, the bridge computes
+ *     the four stage deadlines in absolute time instead of walking them with
+ *     events, and annotates the resulting master-cycle latency on the req,
+ *     which it completes inline. Stage spacing and the `depth` window are
+ *     tracked through the completion times of the last transactions, so
+ *     back-to-back requests see the same serialization as with events (within
+ *     one destination cycle, as stage boundaries are rounded up to the next
+ *     edge). Anything else (fractional ratio, pending evented transactions)
+ *     falls back to the evented path. As the path is chosen before
+ *     forwarding, once the slave answers a request with IO_REQ_GRANTED, every
+ *     later one goes through the evented path; that first request gets the
+ *     forward crossing charged on its response.
+ *
  * Python wrappers (io_v2_clock_bridge.py) set sensible defaults per kind:
  *
  *   IoV2ClockBridge       k_src=0 k_dst=0 depth=1   (sync_only default)
@@ -48,8 +64,9 @@
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
 #include <vp/debug_mem.hpp>
+#include <utils/ring_buffer.hpp>
 
-#include <deque>
+#include <vector>
 
 
 class IoV2ClockBridge : public vp::Component, public vp::DebugMemIf
@@ -91,10 +108,15 @@ private:
     static void rev_src_done_handler(vp::Block *_this, vp::ClockEvent *ev);
     static void rev_dst_done_handler(vp::Block *_this, vp::ClockEvent *ev);
 
-    void reschedule_event(vp::ClockEvent &ev, const std::deque<Txn> &queue,
+    void reschedule_event(vp::ClockEvent &ev, const RingBuffer<Txn> &queue,
                           vp::ClockEngine *engine);
-    void enqueue_in(std::deque<Txn> &queue, vp::IoReq *req,
+    void enqueue_in(RingBuffer<Txn> &queue, vp::IoReq *req,
                     int64_t now_cycle, int min_spacing_cycles);
+    int in_flight();
+
+    // Analytic path. Returns false if the request must go through the evented
+    // path, otherwise `status` holds the status to return upstream.
+    bool analytic_req(vp::IoReq *req, vp::IoReqStatus &status);
 
     vp::IoSlave  in{&IoV2ClockBridge::in_req_handler};
     vp::IoMaster out{&IoV2ClockBridge::out_retry_handler,
@@ -105,22 +127,49 @@ private:
     int k_dst_per_dir = 0;
     int depth = 1;
     bool parametric = false;
+    bool analytic = false;
 
     vp::ClockEngine *master_engine = nullptr;
     vp::ClockEngine *slave_engine  = nullptr;
+    // Owners of the remote ports, used to read the current clock periods.
+    vp::Block *master_block = nullptr;
+    vp::Block *slave_block  = nullptr;
 
     // sync_only-path state: responses pending delivery on the next master edge
     vp::ClockEvent *resp_event = nullptr;
-    std::deque<vp::IoReq *> resp_queue;
+    RingBuffer<vp::IoReq *> resp_queue;
 
     // Parametric-path state (unused when k=0)
     vp::ClockEvent *fwd_src_event = nullptr;
     vp::ClockEvent *rev_dst_event = nullptr;
     vp::ClockEvent *fwd_dst_event = nullptr;
     vp::ClockEvent *rev_src_event = nullptr;
-    std::deque<Txn> fwd_src_queue;
-    std::deque<Txn> fwd_dst_queue;
-    std::deque<Txn> rev_src_queue;
-    std::deque<Txn> rev_dst_queue;
+    RingBuffer<Txn> fwd_src_queue;
+    RingBuffer<Txn> fwd_dst_queue;
+    RingBuffer<Txn> rev_src_queue;
+    RingBuffer<Txn> rev_dst_queue;
     bool retry_owed = false;
+    // Requests the slave answered with IO_REQ_GRANTED and whose response has
+    // not come back yet. They are still in flight for the `depth` window.
+    int slave_pending = 0;
+    // Set once the slave answered a request with IO_REQ_GRANTED. Kept across
+    // resets, as it is a property of the slave.
+    bool slave_async = false;
+
+    // Analytic-path state. Absolute times (ps) at which the last transaction
+    // left each stage, to enforce the one-cycle spacing of each stage FIFO,
+    // and completion times of the last `depth` transactions, to enforce the
+    // in-flight window.
+    int64_t last_fwd_src_time = -1;
+    int64_t last_fwd_dst_time = -1;
+    int64_t last_rev_src_time = -1;
+    int64_t last_rev_dst_time = -1;
+    std::vector<int64_t> done_times;
+    int done_times_index = 0;
+    // Set when the downstream denied an analytic forward, cleared by the
+    // downstream retry() which is then propagated upstream.
+    bool analytic_retry_owed = false;
+
+    vp::StatScalar stat_analytic_txns;
+    vp::StatScalar stat_evented_txns;
 };
@@ -30,6 +30,12 @@ With k_src = k_dst = 0 the C++ takes the fast pass-through path
 to the parametric per-stage ClockEvent path with cycle-accurate
 deadlines and FIFO pipelining up to ``depth`` in-flight transactions.
 
+``analytic=True`` (parametric kinds only) makes the bridge compute the
+four stage deadlines analytically and annotate the resulting latency on
+the request when both clocks are integer-ratio related and the downstream
+answers synchronously, instead of scheduling one event per stage. Other
+crossings still go through the evented path.
+
 The four classes share an implementation; subclasses just set
 per-kind defaults. The cdc_*_beh defaults are calibrated against the
 matching common_cells RTL via the io_v2_clkbridge test β€” see
@@ -50,7 +56,8 @@ class IoV2ClockBridge(Component):
     def __init__(self, parent: Component, name: str, *,
                  k_src_per_dir: int | None = None,
                  k_dst_per_dir: int | None = None,
-                 depth: int | None = None):
+                 depth: int | None = None,
+                 analytic: bool = False):
         super().__init__(parent, name)
         # Compile the bridge .cpp on demand alongside any target that uses
         # it (the framework dedupes by source-hash, so many bridges sharing
@@ -70,6 +77,7 @@ class IoV2ClockBridge(Component):
                                         else self._DEFAULT_K_DST)
         self.add_property('depth',
                           depth if depth is not None else self._DEFAULT_DEPTH)
+        self.add_property('analytic', analytic)
 
     def i_INPUT(self) -> SlaveItf:
         return SlaveItf(self, 'input', signature=IoV2BigPacket())
@@ -6,14 +6,16 @@
 //
 // ELF binary loader on the io_v2 protocol.
 //
-// Direct port of loader.cpp to io_v2. The model mmap's one or more ELF
-// binaries from the host filesystem, walks their PT_LOAD segments, and
-// streams the section data into simulated memory through its ``out``
-// master port. Each chunk is up to 64 KiB; one chunk is in flight at
-// any time. After the last chunk lands, the loader optionally writes
-// the entry address to a configured location and/or a fetch-enable
-// value to another location, then pulses ``entry`` and ``start`` wires
-// so downstream cores can start executing.
+// Direct port of loader.cpp to io_v2. The model maps one or more ELF
+// binaries from the host filesystem through the shared ELF cache
+// (utils/elf_cache.hpp), walks their PT_LOAD segments, and streams the
+// section data into simulated memory through its ``out`` master port. Each
+// chunk is up to 64 KiB; up to ``max_pending_chunks`` chunks (1 by
+// default) are in flight at any time, each with its own request object.
+// After the last chunk lands, the loader optionally writes the entry
+// address to a configured location and/or a fetch-enable value to another
+// location, then pulses ``entry`` and ``start`` wires so downstream cores
+// can start executing.
 //
 // What changed vs v1:
 //   - ``out`` port is an io_v2 master. Replies travel back through its
@@ -23,10 +25,11 @@
 //     ``IO_REQ_DENIED``. The response status
 //     (``IO_RESP_OK`` / ``IO_RESP_INVALID``) is consumed when the
 //     downstream replies.
-//   - Section pointer advances only on success: on a DENY the chunk
-//     stays pending, and is re-sent from the output's retry callback
-//     with the same (addr, data, size) — guaranteeing no byte is lost
-//     or duplicated.
+//   - On a DENY the chunk stays pending, and is re-sent from the
+//     output's retry callback with the same (addr, data, size) —
+//     guaranteeing no byte is lost or duplicated. No other chunk is
+//     issued until the denied one is accepted, so chunks reach the
+//     downstream in section order.
 //   - Error responses (``IO_RESP_INVALID``) no longer hang the loader:
 //     the chunk is considered consumed, a warning is emitted, and the
 //     next chunk is scheduled normally (v1 would stall forever on any
@@ -39,9 +42,18 @@
 // Timing model: big-packet. The loader does not annotate latency
 // itself; it simply paces itself by the downstream's ``req->latency``
 // annotation (sync path) or the wall-clock time at which ``resp()``
-// fires (async path). Between one chunk's completion and the next
-// one's issue, a single idle cycle is added so the simulator has a
-// chance to advance other components.
+// fires (async path). Each chunk slot becomes available one idle cycle
+// after its chunk completes, so the simulator has a chance to advance
+// other components. With a single slot this serializes the load; more
+// slots let the loader keep the downstream busy.
+//
+// Backdoor loading: with the ``backdoor`` option, the sections are instead
+// written at reset through the debug-memory backdoor (vp/debug_mem.hpp) of
+// the component bound to ``out``, which resolves each access down to the
+// terminal memory and copies it directly, in zero simulated time. Sections
+// the backdoor cannot reach (e.g. behind a flash controller model) stay
+// queued and are streamed through the port as usual. ``entry`` and
+// ``start`` then fire on the first cycle after reset if nothing is left.
 
 #include <cstring>
 #include <fcntl.h>
@@ -53,9 +65,9 @@
 #include <memory>
 #include <vector>
 #include <vp/vp.hpp>
+#include <vp/debug_mem.hpp>
 #include <vp/itf/io_v2.hpp>
-
-#include "elf.h"
+#include <utils/elf_cache.hpp>
 
 
 class Section
@@ -77,42 +89,69 @@ public:
     void reset(bool active) override;
 
 private:
+    // One chunk request slot. The request object is owned by the slot so
+    // that several chunks can be in flight at once.
+    struct ChunkSlot
+    {
+        vp::IoReq req;
+        uint64_t  paddr = 0;
+        uint8_t  *data  = nullptr;  // nullptr if the chunk is a clear
+        size_t    size  = 0;
+        // Waiting for a resp() or, for the denied slot, for a retry()
+        bool      busy  = false;
+        // First cycle at which the slot can carry a new chunk
+        int64_t   ready_cycle = 0;
+    };
+
     static void event_handler(vp::Block *__this, vp::ClockEvent *event);
     static vp::IoRespAck output_resp(vp::Block *__this, vp::IoReq *req);
     static void output_retry(vp::Block *__this, vp::IoRetryChannel);
 
     bool load_elf(const char *file, uint64_t *entry);
-    bool load_elf32(unsigned char *file, uint64_t *entry);
-    bool load_elf64(unsigned char *file, uint64_t *entry);
     void section_copy(uint64_t paddr, uint8_t *data, size_t size);
     void section_clear(uint64_t paddr, size_t size);
 
-    // Emit the current chunk on the output. Called from event_handler
+    // Write every queued section through the backdoor of the component
+    // bound to ``out`` and drop the ones which fully landed. Does nothing if
+    // that component has no backdoor.
+    void backdoor_load();
+    // Write one section through the backdoor. On failure, the section is
+    // trimmed to the part which did not land and false is returned.
+    bool backdoor_write(vp::DebugMemIf *debug_mem, Section *section);
+
+    // Carve the next chunk out of the section queue into `slot` and send it.
+    void issue_chunk(ChunkSlot *slot);
+    // Emit the chunk of `slot` on the output. Called from issue_chunk
     // (initial attempt) and from output_retry (after a DENY).
-    void send_chunk();
-    // Called after any successful completion (DONE or deferred resp) of
-    // the in-flight chunk. Advances the section pointer and schedules
-    // the next event.
-    void chunk_completed();
+    void send_chunk(ChunkSlot *slot);
+    // Called after any completion (DONE or deferred resp) of the chunk of
+    // `slot`. Releases the slot after the idle cycle.
+    void chunk_completed(ChunkSlot *slot, int64_t latency);
+    // Arm the event for the next time something can be done: a slot
+    // becoming ready while there are chunks left, or the end of the last
+    // chunk to fire the finalisation wires.
+    void schedule();
+    void finalize();
 
     vp::Trace trace;
     vp::IoMaster out_itf{&Loader::output_retry, &Loader::output_resp};
     vp::WireMaster<bool>     start_itf;
     vp::WireMaster<uint64_t> entry_itf;
 
-    vp::IoReq         req;            // Reused across chunks.
     vp::ClockEvent   *event = nullptr;
 
+    // Sections not fully issued yet. The front one is the one being
+    // chunked; its (paddr, data, size) advance as chunks are issued.
     std::list<std::unique_ptr<Section>> sections;
-    Section *current_section = nullptr;
 
-    // In-flight chunk snapshot. Populated when a chunk is issued; used to
-    // replay the same transfer on a downstream DENY and to drive the
-    // section advance on completion.
-    uint64_t  chunk_paddr = 0;
-    uint8_t  *chunk_data  = nullptr;  // nullptr if the chunk is a clear
-    size_t    chunk_size  = 0;
-    bool      chunk_in_flight = false;
+    // Parsed binaries, holding the file mappings the sections point into
+    std::vector<std::shared_ptr<elf_cache::Image>> images;
+
+    std::vector<ChunkSlot> slots;
+    // Slot whose chunk was denied, replayed on the next retry(). Nothing
+    // else is issued meanwhile.
+    ChunkSlot *denied_slot = nullptr;
+    bool      finalized = false;
 
     // Persistent all-zero buffer used for ``bss`` sections. Sized once on
     // construction; safe to point downstream at even if it defers the
@@ -122,6 +161,7 @@ private:
     uint64_t  entry = 0;
     bool      is_32 = true;
     uint64_t  fetchen_value = 0;
+    bool      backdoor = false;
 
     static constexpr size_t MAX_CHUNK = 1 << 16;   // 64 KiB
 };
@@ -139,12 +179,35 @@ Loader::Loader(vp::ComponentConf &config)
     this->event = this->event_new(&Loader::event_handler);
 
     this->zero_buffer.assign(MAX_CHUNK, 0);
+
+    this->backdoor = this->get_js_config()->get_child_bool("backdoor");
+
+    int64_t nb_slots = this->get_js_config()->get_child_int("max_pending_chunks");
+    this->slots.resize(nb_slots > 0 ? nb_slots : 1);
 }
 
 
 void Loader::reset(bool active)
 {
-    if (!active)
+    if (active)
+    {
+        // Drop whatever the previous run left, so that the binaries are
+        // loaded again from scratch when the reset is released.
+        if (this->event->is_enqueued())
+        {
+            this->event->cancel();
+        }
+        this->sections.clear();
+        this->images.clear();
+        for (ChunkSlot &slot : this->slots)
+        {
+            slot.busy = false;
+            slot.ready_cycle = 0;
+        }
+        this->denied_slot = nullptr;
+        this->finalized = false;
+    }
+    else
     {
         // Fresh start: load every configured binary, then enqueue any
         // extra entries (entry_addr / fetchen_addr) before kicking off
@@ -174,12 +237,84 @@ void Loader::reset(bool active)
 
         if (!this->sections.empty())
         {
+            if (this->backdoor)
+            {
+                this->backdoor_load();
+            }
+
+            // Armed even if the backdoor loaded everything, so that the
+            // finalisation wires fire.
             this->event_enqueue(this->event, 1);
         }
     }
 }
 
 
+void Loader::backdoor_load()
+{
+    // Same resolution as the gdbserver: a read-only walk of the binding
+    // graph, no request is issued on the port.
+    std::vector<vp::SlavePort *> finals = this->out_itf.get_final_ports();
+    vp::DebugMemIf *debug_mem = nullptr;
+    if (!finals.empty() && finals[0]->get_owner() != nullptr)
+    {
+        debug_mem = finals[0]->get_owner()->debug_mem_if();
+    }
+
+    if (debug_mem == nullptr)
+    {
+        this->trace.msg(vp::Trace::LEVEL_WARNING,
+            "No debug-memory backdoor behind output, loading through the port\n");
+        return;
+    }
+
+    for (auto it = this->sections.begin(); it != this->sections.end();)
+    {
+        if (this->backdoor_write(debug_mem, it->get()))
+        {
+            it = this->sections.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+
+bool Loader::backdoor_write(vp::DebugMemIf *debug_mem, Section *section)
+{
+    while (section->size > 0)
+    {
+        // bss sections are written from the zero buffer, one chunk at a time
+        size_t size = section->data != nullptr ?
+            section->size : std::min(section->size, MAX_CHUNK);
+        uint8_t *data = section->data != nullptr ?
+            section->data : this->zero_buffer.data();
+
+        if (debug_mem->debug_mem_access(section->paddr, data, size, true) != 0)
+        {
+            this->trace.msg(vp::Trace::LEVEL_DEBUG,
+                "No backdoor for section, loading through the port (addr: 0x%llx, size: 0x%llx)\n",
+                (unsigned long long)section->paddr, (unsigned long long)section->size);
+            return false;
+        }
+
+        this->trace.msg(vp::Trace::LEVEL_DEBUG,
+            "Loaded through backdoor (addr: 0x%llx, data: %p, size: 0x%llx)\n",
+            (unsigned long long)section->paddr, section->data, (unsigned long long)size);
+
+        section->paddr += size;
+        if (section->data != nullptr)
+        {
+            section->data += size;
+        }
+        section->size -= size;
+    }
+    return true;
+}
+
+
 void Loader::section_copy(uint64_t paddr, uint8_t *data, size_t size)
 {
     if (size > 0)
@@ -197,128 +332,196 @@ void Loader::section_clear(uint64_t paddr, size_t size)
 }
 
 
-void Loader::send_chunk()
+void Loader::issue_chunk(ChunkSlot *slot)
 {
-    this->req.prepare();
-    this->req.set_addr(this->chunk_paddr);
-    this->req.set_size((uint64_t)this->chunk_size);
-    this->req.set_opcode(vp::WRITE);
-    this->req.set_resp_status(vp::IO_RESP_OK);
-    this->req.set_data(this->chunk_data != nullptr
-                           ? this->chunk_data
-                           : this->zero_buffer.data());
+    Section *section = this->sections.front().get();
+    size_t iter_size = std::min(section->size, MAX_CHUNK);
+
+    slot->paddr = section->paddr;
+    slot->data  = section->data;   // may be nullptr
+    slot->size  = iter_size;
+
+    this->trace.msg(vp::Trace::LEVEL_DEBUG,
+        "Handling section chunk (addr: 0x%llx, data: %p, size: 0x%llx)\n",
+        (unsigned long long)slot->paddr,
+        slot->data,
+        (unsigned long long)slot->size);
+
+    // The section pointer advances at issue time since several chunks
+    // may be in flight; a denied chunk keeps its own snapshot in the slot.
+    section->paddr += iter_size;
+    if (section->data != nullptr)
+    {
+        section->data += iter_size;
+    }
+    section->size -= iter_size;
+    if (section->size == 0)
+    {
+        this->sections.pop_front();
+    }
 
-    this->chunk_in_flight = true;
+    this->send_chunk(slot);
+}
+
+
+void Loader::send_chunk(ChunkSlot *slot)
+{
+    vp::IoReq *req = &slot->req;
+    req->prepare();
+    req->set_addr(slot->paddr);
+    req->set_size((uint64_t)slot->size);
+    req->set_opcode(vp::WRITE);
+    req->set_resp_status(vp::IO_RESP_OK);
+    req->set_data(slot->data != nullptr
+                      ? slot->data
+                      : this->zero_buffer.data());
 
-    vp::IoReqStatus st = this->out_itf.req(&this->req);
+    slot->busy = true;
+
+    vp::IoReqStatus st = this->out_itf.req(req);
 
     if (st == vp::IO_REQ_DONE)
     {
-        this->chunk_in_flight = false;
-        if (this->req.get_resp_status() == vp::IO_RESP_INVALID)
+        if (req->get_resp_status() == vp::IO_RESP_INVALID)
         {
             // A downstream error is logged but not fatal — the loader
             // intentionally moves on to the next chunk so a single bad
             // memory region does not deadlock boot.
             this->trace.force_warning_no_error(
                 "Received error during copy (addr: 0x%llx, data: %p, size: 0x%llx)\n",
-                (unsigned long long)this->chunk_paddr,
-                this->chunk_data,
-                (unsigned long long)this->chunk_size);
+                (unsigned long long)slot->paddr,
+                slot->data,
+                (unsigned long long)slot->size);
         }
-        this->chunk_completed();
+        this->chunk_completed(slot, req->get_latency());
     }
     else if (st == vp::IO_REQ_DENIED)
     {
-        // Hold the chunk; output_retry will re-enter send_chunk.
-        // chunk_in_flight stays true so output_retry knows there is work
-        // to redo; the section pointer is left untouched.
+        // Hold the chunk; output_retry will re-enter send_chunk. The slot
+        // stays busy and nothing else is issued until it is accepted.
+        this->denied_slot = slot;
     }
     // IO_REQ_GRANTED: wait for output_resp to drive chunk_completed.
 }
 
 
-void Loader::chunk_completed()
+void Loader::chunk_completed(ChunkSlot *slot, int64_t latency)
 {
-    // Advance the section pointer past the chunk that just landed. If
-    // the section is drained, release it.
-    if (this->current_section != nullptr)
+    // The slot can carry a new chunk after one cycle plus whatever latency
+    // the downstream annotated on the request object.
+    slot->busy = false;
+    slot->ready_cycle = this->clock.get_cycles() + 1 + (latency > 0 ? latency : 0);
+}
+
+
+void Loader::schedule()
+{
+    if (this->denied_slot != nullptr || this->finalized)
+    {
+        return;
+    }
+
+    int64_t next_cycle = -1;
+    if (!this->sections.empty())
     {
-        this->current_section->paddr += this->chunk_size;
-        if (this->current_section->data != nullptr)
+        // Earliest slot available for the next chunk, if any is not
+        // waiting for a response.
+        for (ChunkSlot &slot : this->slots)
         {
-            this->current_section->data += this->chunk_size;
+            if (!slot.busy && (next_cycle == -1 || slot.ready_cycle < next_cycle))
+            {
+                next_cycle = slot.ready_cycle;
+            }
         }
-        this->current_section->size -= this->chunk_size;
-
-        if (this->current_section->size == 0)
+    }
+    else
+    {
+        // Finalisation once the last chunk has completed
+        for (ChunkSlot &slot : this->slots)
         {
-            this->current_section = nullptr;
+            if (slot.busy)
+            {
+                return;
+            }
+            next_cycle = std::max(next_cycle, slot.ready_cycle);
         }
     }
 
-    // Schedule the next iteration. One cycle plus whatever latency the
-    // downstream annotated on the request object.
-    int64_t latency = 1 + this->req.get_latency();
-    if (latency < 1) latency = 1;
-    this->event_enqueue(this->event, latency);
+    if (next_cycle == -1)
+    {
+        return;
+    }
+
+    int64_t delay = std::max<int64_t>(next_cycle - this->clock.get_cycles(), 1);
+    if (this->event->is_enqueued())
+    {
+        this->event->cancel();
+    }
+    this->event_enqueue(this->event, delay);
 }
 
 
 void Loader::event_handler(vp::Block *__this, vp::ClockEvent *event)
 {
     Loader *_this = (Loader *)__this;
+    int64_t cycles = _this->clock.get_cycles();
 
-    // Pick up the next section if there is none in progress.
-    if (_this->current_section == nullptr && !_this->sections.empty())
+    // Fill every ready slot, in slot order, until the sections are drained
+    // or a chunk is denied.
+    for (ChunkSlot &slot : _this->slots)
     {
-        auto next = std::move(_this->sections.front());
-        _this->sections.pop_front();
-        _this->current_section = next.release();  // freed on completion
-        _this->trace.msg(vp::Trace::LEVEL_DEBUG,
-            "Starting section (addr: 0x%llx, data: %p, size: 0x%llx)\n",
-            (unsigned long long)_this->current_section->paddr,
-            _this->current_section->data,
-            (unsigned long long)_this->current_section->size);
+        if (_this->sections.empty() || _this->denied_slot != nullptr)
+        {
+            break;
+        }
+        if (!slot.busy && slot.ready_cycle <= cycles)
+        {
+            _this->issue_chunk(&slot);
+        }
     }
 
-    if (_this->current_section != nullptr)
+    if (_this->sections.empty() && _this->denied_slot == nullptr)
     {
-        size_t iter_size = std::min(_this->current_section->size, MAX_CHUNK);
-        _this->chunk_paddr = _this->current_section->paddr;
-        _this->chunk_data  = _this->current_section->data;   // may be nullptr
-        _this->chunk_size  = iter_size;
-
-        _this->trace.msg(vp::Trace::LEVEL_DEBUG,
-            "Handling section chunk (addr: 0x%llx, data: %p, size: 0x%llx)\n",
-            (unsigned long long)_this->chunk_paddr,
-            _this->chunk_data,
-            (unsigned long long)_this->chunk_size);
-
-        _this->send_chunk();
-        return;
+        bool idle = true;
+        for (ChunkSlot &slot : _this->slots)
+        {
+            if (slot.busy || slot.ready_cycle > cycles)
+            {
+                idle = false;
+            }
+        }
+        if (idle)
+        {
+            _this->finalize();
+            return;
+        }
     }
 
-    // All sections delivered — delete the last completed section object
-    // (owned raw pointer) and fire the finalisation wires.
-    // Note: current_section is already null here; nothing to free.
+    _this->schedule();
+}
+
+
+void Loader::finalize()
+{
+    // All sections delivered — fire the finalisation wires.
+    this->finalized = true;
 
-    js::Config *entry_conf = _this->get_js_config()->get("entry");
+    js::Config *entry_conf = this->get_js_config()->get("entry");
     if (entry_conf != nullptr)
     {
-        _this->entry = (uint64_t)entry_conf->get_int();
+        this->entry = (uint64_t)entry_conf->get_int();
     }
 
-    if (_this->entry_itf.is_bound())
+    if (this->entry_itf.is_bound())
     {
-        _this->trace.msg(vp::Trace::LEVEL_DEBUG,
-            "Sending entry (addr: 0x%llx)\n", (unsigned long long)_this->entry);
-        _this->entry_itf.sync(_this->entry);
+        this->trace.msg(vp::Trace::LEVEL_DEBUG,
+            "Sending entry (addr: 0x%llx)\n", (unsigned long long)this->entry);
+        this->entry_itf.sync(this->entry);
     }
-    if (_this->start_itf.is_bound())
+    if (this->start_itf.is_bound())
     {
-        _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Sending start\n");
-        _this->start_itf.sync(true);
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Sending start\n");
+        this->start_itf.sync(true);
     }
 }
 
@@ -326,16 +529,25 @@ void Loader::event_handler(vp::Block *__this, vp::ClockEvent *event)
 vp::IoRespAck Loader::output_resp(vp::Block *__this, vp::IoReq *req)
 {
     Loader *_this = (Loader *)__this;
-    _this->chunk_in_flight = false;
+    ChunkSlot *slot = nullptr;
+    for (ChunkSlot &s : _this->slots)
+    {
+        if (&s.req == req)
+        {
+            slot = &s;
+            break;
+        }
+    }
 
     if (req->get_resp_status() == vp::IO_RESP_INVALID)
     {
         _this->trace.force_warning_no_error(
             "Received error during copy (addr: 0x%llx, size: 0x%llx)\n",
-            (unsigned long long)_this->chunk_paddr,
-            (unsigned long long)_this->chunk_size);
+            (unsigned long long)slot->paddr,
+            (unsigned long long)slot->size);
     }
-    _this->chunk_completed();
+    _this->chunk_completed(slot, req->get_latency());
+    _this->schedule();
 
     return vp::IO_RESP_ACCEPTED;
 }
@@ -344,11 +556,14 @@ vp::IoRespAck Loader::output_resp(vp::Block *__this, vp::IoReq *req)
 void Loader::output_retry(vp::Block *__this, vp::IoRetryChannel)
 {
     Loader *_this = (Loader *)__this;
-    if (_this->chunk_in_flight)
+    ChunkSlot *slot = _this->denied_slot;
+    if (slot != nullptr)
     {
-        // Replay the same chunk — send_chunk re-uses chunk_paddr /
-        // chunk_data / chunk_size, which were never advanced on DENY.
-        _this->send_chunk();
+        // Replay the same chunk — send_chunk re-uses the slot snapshot,
+        // which was never touched on DENY.
+        _this->denied_slot = nullptr;
+        _this->send_chunk(slot);
+        _this->schedule();
     }
 }
 
@@ -359,88 +574,39 @@ void Loader::output_retry(vp::Block *__this, vp::IoRetryChannel)
 
 bool Loader::load_elf(const char *file, uint64_t *entry)
 {
-    int fd = open(file, O_RDONLY);
-    struct stat s;
-    if (fstat(fd, &s) < 0)
-    {
-        this->trace.force_warning_no_error(
-            "Unable to open binary (path: %s, error: %s)\n", file, strerror(errno));
-        return true;
-    }
-    size_t size = s.st_size;
-
-    unsigned char *buf = (unsigned char *)mmap(NULL, size, PROT_READ,
-                                                MAP_PRIVATE, fd, 0);
-    if (buf == MAP_FAILED)
+    // The image is parsed once per binary and shared with the other loaders
+    // and the ISS symbol resolution; sections point into its mapping, which
+    // is kept alive by `images`.
+    std::string error;
+    std::shared_ptr<elf_cache::Image> image = elf_cache::get(file, &error);
+    if (image == nullptr)
     {
         this->trace.force_warning_no_error(
-            "Unable to open binary (path: %s, error: %s)\n", file, strerror(errno));
-        close(fd);
+            "Unable to open binary (path: %s, error: %s)\n", file, error.c_str());
         return true;
     }
-    close(fd);
+    this->images.push_back(image);
 
-    this->is_32 = buf[EI_CLASS] == ELFCLASS32;
+    this->is_32 = image->is_32;
 
-    if (buf[EI_CLASS] == ELFCLASS32)
-    {
-        return this->load_elf32(buf, entry);
-    }
-    else
+    for (const elf_cache::Segment &segment : image->segments)
     {
-        return this->load_elf64(buf, entry);
-    }
-}
-
-
-bool Loader::load_elf32(unsigned char *file, uint64_t *entry)
-{
-    Elf32_Ehdr *header = (Elf32_Ehdr *)file;
-    Elf32_Phdr *pg_headers = (Elf32_Phdr *)&file[header->e_phoff];
-
-    for (int i = 0; i < header->e_phnum; i++)
-    {
-        Elf32_Phdr *segment = &pg_headers[i];
-        if (segment->p_type == PT_LOAD && segment->p_memsz)
+        // ELF32 images also queue segments with only a bss part, ELF64
+        // ones only those carrying data, as the v1 loader did.
+        if (image->is_32 ? segment.memsz == 0 : segment.filesz == 0)
         {
-            this->section_copy(segment->p_paddr,
-                               &file[segment->p_offset],
-                               segment->p_filesz);
-            if (segment->p_filesz < segment->p_memsz)
-            {
-                this->section_clear(segment->p_paddr + segment->p_filesz,
-                                    segment->p_memsz - segment->p_filesz);
-            }
+            continue;
         }
-    }
 
-    *entry = header->e_entry;
-    return false;
-}
-
-
-bool Loader::load_elf64(unsigned char *file, uint64_t *entry)
-{
-    Elf64_Ehdr *header = (Elf64_Ehdr *)file;
-    Elf64_Phdr *pg_headers = (Elf64_Phdr *)&file[header->e_phoff];
-
-    for (int i = 0; i < header->e_phnum; i++)
-    {
-        Elf64_Phdr *segment = &pg_headers[i];
-        if (segment->p_type == PT_LOAD && segment->p_filesz)
+        this->section_copy(segment.paddr, (uint8_t *)segment.data, segment.filesz);
+        if (segment.filesz < segment.memsz)
         {
-            this->section_copy(segment->p_paddr,
-                               &file[segment->p_offset],
-                               segment->p_filesz);
-            if (segment->p_filesz < segment->p_memsz)
-            {
-                this->section_clear(segment->p_paddr + segment->p_filesz,
-                                    segment->p_memsz - segment->p_filesz);
-            }
+            this->section_clear(segment.paddr + segment.filesz,
+                                segment.memsz - segment.filesz);
         }
     }
 
-    *entry = header->e_entry;
+    *entry = image->entry;
     return false;
 }
 
@@ -34,8 +34,15 @@ class ElfLoader(gvsoc.systree.Component):
     ``PT_LOAD`` program segments are discovered at reset, and the
     file-backed bytes (``p_filesz``) are copied to the target
     addresses; the trailing ``bss`` region (``p_memsz - p_filesz``) is
-    written as zeros. Transfers are chunked at 64 KiB and serialized —
-    exactly one chunk is in flight at any time.
+    written as zeros. Transfers are chunked at 64 KiB, with up to
+    ``max_pending_chunks`` chunks in flight at any time (one by
+    default, which serializes them).
+
+    Binaries are mapped and parsed through a shared ELF cache, keyed by
+    path and modification time: loaders and ISS trace symbol resolution
+    reading the same file share one mapping and one parse. Setting
+    ``GV_ELF_INDEX`` in the environment also saves the parsed debug
+    tables next to the binary (``<binary>.gvidx``) for later runs.
 
     This is the io_v2 port of :class:`utils.loader.loader.ElfLoader`.
     Only the IO-side plumbing is new:
@@ -65,9 +72,12 @@ class ElfLoader(gvsoc.systree.Component):
        address.
     3. If ``fetchen_addr`` is set, queue a section that writes
        ``fetchen_value`` at that address, same width as the entry.
-    4. Schedule the streaming event one cycle after reset
+    4. If ``backdoor`` is set, write the queued sections directly
+       into the target memories (see *Backdoor loading* below) and
+       drop the ones which landed.
+    5. Schedule the streaming event one cycle after reset
        de-assertion.
-    5. The event walks the section queue one chunk at a time. After
+    6. The event walks the section queue chunk by chunk. After
        the last byte of the last section has been acknowledged, the
        loader pulses the ``entry`` wire (with the entry address)
        and then the ``start`` wire (with ``True``).
@@ -75,22 +85,43 @@ class ElfLoader(gvsoc.systree.Component):
     Request flow for a chunk
     ~~~~~~~~~~~~~~~~~~~~~~~~
 
-    - **Issue**: the event fires. The current chunk's (addr, data,
-      size) snapshot is written into the reused ``IoReq`` and the
-      write is forwarded through ``out``.
+    The loader owns ``max_pending_chunks`` chunk slots, each with its
+    own ``IoReq``. When the event fires, every free slot takes the
+    next chunk of the section queue, in order:
+
+    - **Issue**: the chunk's (addr, data, size) snapshot is written
+      into the slot's ``IoReq`` and the write is forwarded through
+      ``out``.
     - **DONE**: the downstream absorbed the chunk synchronously. If
       its response status is ``IO_RESP_INVALID``, a warning is
-      emitted; either way the section pointer advances and the next
-      chunk is scheduled.
-    - **GRANTED**: the downstream will acknowledge later; the
-      loader waits for ``resp()`` before advancing.
-    - **DENIED**: the chunk is held; the section pointer is not
-      advanced. When the downstream fires ``retry()``, the loader
-      re-sends the exact same chunk.
-
-    A single idle cycle is inserted between the acknowledgement of a
-    chunk and the issue of the next one, so other components get a
-    chance to advance.
+      emitted; either way the slot is released.
+    - **GRANTED**: the downstream will acknowledge later; the slot
+      stays busy until ``resp()``.
+    - **DENIED**: the chunk is held in its slot and no further chunk
+      is issued. When the downstream fires ``retry()``, the loader
+      re-sends the exact same chunk, so chunks always reach the
+      downstream in section order.
+
+    A released slot takes a new chunk one idle cycle after the
+    acknowledgement (plus the latency the downstream annotated on a
+    ``DONE``), so other components get a chance to advance.
+
+    Backdoor loading
+    ~~~~~~~~~~~~~~~~
+
+    With ``backdoor=True``, the loader resolves the debug-memory
+    backdoor of the component bound to ``out`` (the same out-of-band
+    interface the gdbserver uses) and writes every section through it
+    at reset. Interconnects forward the access along their mappings
+    down to the terminal memory, which copies the bytes directly: the
+    image is loaded in zero simulated time and without any request on
+    the port, and ``entry`` / ``start`` fire on the first cycle after
+    reset.
+
+    Sections the backdoor cannot reach, because no memory implementing
+    it sits behind their address (e.g. a flash controller model), stay
+    queued and are streamed through ``out`` as usual. Use the default
+    port path when the boot sequence itself is what is being modelled.
 
     Timing model
     ~~~~~~~~~~~~
@@ -101,7 +132,10 @@ class ElfLoader(gvsoc.systree.Component):
     latency each destination memory reports (either synchronously
     via ``req->latency`` or as a deferred ``resp()`` wall-clock
     time) is what the loader paces itself with, plus the fixed
-    one-cycle inter-chunk gap.
+    one-cycle gap before a slot is reused. With several slots, the
+    latencies of the chunks in flight overlap, so a pipelined
+    downstream (e.g. a flash controller or DRAM model with a request
+    queue) can be kept saturated.
 
     Ports
     ~~~~~
@@ -131,13 +165,17 @@ class ElfLoader(gvsoc.systree.Component):
       address as-is, and an ``addr+size`` range that falls outside
       any bound memory simply triggers ``IO_RESP_INVALID`` from the
       interconnect (logged, not fatal).
-    - **One chunk in flight at a time.** The loader waits for each
-      chunk to be acknowledged before issuing the next. Throughput
-      is therefore governed by the slowest downstream on the path,
-      and a stalled interconnect will hold the loader hostage until
-      it clears.
+    - **Bounded number of chunks in flight.** At most
+      ``max_pending_chunks`` chunks are outstanding, and a DENY
+      stops the issue of new ones until the denied chunk is
+      accepted. A stalled interconnect will hold the loader hostage
+      until it clears.
     - **64 KiB chunk granularity.** Larger sections are split into
       64 KiB writes; smaller sections fit in a single write.
+    - **Backdoor sections land before port sections.** With
+      ``backdoor=True``, sections falling back to the port are
+      written after all the backdoor ones, so overlapping segments
+      of the two kinds are not applied in file order.
     - **ELF32 or ELF64 only.** The mmap'd buffer is interpreted
       straight from its ``EI_CLASS`` byte; other object formats are
       not supported.
@@ -188,6 +226,15 @@ class ElfLoader(gvsoc.systree.Component):
         ``fetchen_addr`` in memory. Useful for lock-step start
         schemes where a "go" flag in memory releases the core.
 
+    ``backdoor``
+        If ``True``, load the sections through the debug-memory
+        backdoor of the output at reset, in zero simulated time, and
+        only stream through ``out`` the ones it cannot reach.
+
+    ``max_pending_chunks``
+        Number of 64 KiB chunks which can be in flight at the same
+        time on ``out``. The default of 1 serializes the transfers.
+
     Example
     ~~~~~~~
 
@@ -227,6 +274,11 @@ class ElfLoader(gvsoc.systree.Component):
         this address.
     fetchen_value : int, optional
         Value to write at ``fetchen_addr``.
+    backdoor : bool, optional
+        Load through the debug-memory backdoor of the output when
+        possible.
+    max_pending_chunks : int, optional
+        Maximum number of chunks in flight on the output.
     """
 
     # Developer-manual doc registration. Discovered by AST scan at doc
@@ -242,7 +294,8 @@ class ElfLoader(gvsoc.systree.Component):
     def __init__(self, parent: gvsoc.systree.Component, name: str,
                  binary: str = None, binaries: list = None,
                  entry: int = None, entry_addr: int = None,
-                 fetchen_addr: int = None, fetchen_value=None):
+                 fetchen_addr: int = None, fetchen_value=None,
+                 backdoor: bool = False, max_pending_chunks: int = 1):
         super().__init__(parent, name)
 
         whole_binaries = []
@@ -253,7 +306,11 @@ class ElfLoader(gvsoc.systree.Component):
 
         self.set_component('utils.loader.loader_v2')
 
-        self.add_properties({'binary': whole_binaries})
+        self.add_properties({
+            'binary': whole_binaries,
+            'backdoor': backdoor,
+            'max_pending_chunks': max_pending_chunks,
+        })
 
         if entry is not None:
             self.add_properties({'entry': entry})
@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * Decoder of the ASCII logic values found in waveform files, shared by the
+ * FST and VCD players.
+ *
+ * A value is a string of one character per bit, MSB first: '0'/'1'/'x'/'z'
+ * for the 4-state model, plus the SystemVerilog 9-state letters h/l/u/w/-,
+ * which are folded into 0/1/X. It is decoded into 64-bit (value, flags)
+ * chunks under the GVSoC 4-state convention:
+ *   (flag=0,val=0/1) -> 0/1, (flag=1,val=0) -> X, (flag=1,val=1) -> Z.
+ * Chunk i covers bits [(i+1)*64-1 : i*64] (low-order chunk first), so
+ * values wider than 64 bits produce several chunks rather than being
+ * truncated.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace logic_value
+{
+
+// Fold one value character into the (value, flags) chunks at bit
+// `bit_from_lsb`.
+static inline void decode_bit(unsigned char c, int bit_from_lsb,
+    uint64_t *values, uint64_t *flags)
+{
+    int chunk_idx = bit_from_lsb / 64;
+    uint64_t mask = (uint64_t)1 << (bit_from_lsb % 64);
+    switch (c)
+    {
+    case '0':
+        break;
+    case '1':
+        values[chunk_idx] |= mask;
+        break;
+    case 'x': case 'X':
+        flags[chunk_idx] |= mask;
+        break;
+    case 'z': case 'Z':
+        values[chunk_idx] |= mask;
+        flags[chunk_idx] |= mask;
+        break;
+    case 'h': case 'H':
+        // weak high -> 1
+        values[chunk_idx] |= mask;
+        break;
+    case 'l': case 'L':
+        // weak low -> 0
+        break;
+    case 'u': case 'U':
+    case 'w': case 'W':
+    case '-':
+        // uninit / weak unknown / dontcare -> X
+        flags[chunk_idx] |= mask;
+        break;
+    default:
+        // Unknown value character -- treat as X so it's visible.
+        flags[chunk_idx] |= mask;
+        break;
+    }
+}
+
+// Decode the `nb_bits` characters at `chars` (chars[0] is the MSB) into
+// `values` and `flags`, which must hold (nb_bits + 63) / 64 chunks.
+//
+// Values are mostly plain 0/1, so they are taken 8 characters at a time:
+// the group is pure 0/1 when every byte is 0x30 or 0x31, and the low bit
+// of each byte is then gathered with one multiply, the first character
+// landing on the highest bit of the resulting byte. Groups holding any
+// other character go through decode_bit.
+static inline void decode(const unsigned char *chars, int nb_bits,
+    uint64_t *values, uint64_t *flags)
+{
+    int nb_chunks = (nb_bits + 63) / 64;
+    std::fill(values, values + nb_chunks, 0);
+    std::fill(flags, flags + nb_chunks, 0);
+
+    int i = 0;
+    for (; i + 8 <= nb_bits; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, chars + i, 8);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        if ((word & 0xFEFEFEFEFEFEFEFEULL) != 0x3030303030303030ULL)
+        {
+            for (int j = i; j < i + 8; j++)
+            {
+                decode_bit(chars[j], nb_bits - 1 - j, values, flags);
+            }
+            continue;
+        }
+        uint64_t byte = ((word & 0x0101010101010101ULL) * 0x8040201008040201ULL) >> 56;
+        int lsb = nb_bits - 8 - i;
+        int bit_in_chunk = lsb % 64;
+        values[lsb / 64] |= byte << bit_in_chunk;
+        if (bit_in_chunk > 56)
+        {
+            values[lsb / 64 + 1] |= byte >> (64 - bit_in_chunk);
+        }
+    }
+
+    for (; i < nb_bits; i++)
+    {
+        decode_bit(chars[i], nb_bits - 1 - i, values, flags);
+    }
+}
+
+}  // namespace logic_value
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * RingBuffer — FIFO container for the request queues of io_v2 components.
+ *
+ * Replaces std::deque on the hot paths of fifo_v2, the io_v2 routers and the
+ * clock bridge. A deque allocates and frees a chunk every few hundred
+ * push/pop as the queue slides through memory; here the storage is a single
+ * power-of-two array indexed with a mask, allocated once from the component
+ * config (reserve() in the constructor, with the FIFO depth when the
+ * component has one) and reused for the whole run.
+ *
+ * The capacity is a sizing hint, not a hard limit: pushing into a full buffer
+ * doubles the storage, so queues whose occupancy is bounded by the protocol
+ * rather than by a config field (e.g. requests parked behind a stalled router
+ * output) stay correct. Such a buffer stops growing once it has seen its
+ * peak occupancy. Components that must reject requests when full test full()
+ * (or compare size() with their own depth) before pushing.
+ *
+ * Elements are copied in and out, so T should be a small trivially copyable
+ * type (request pointer, pointer + index, ...). References returned by
+ * front()/back()/operator[] are invalidated by any push.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+template<typename T>
+class RingBuffer
+{
+public:
+    RingBuffer(size_t capacity = 0) { this->reserve(capacity); }
+
+    // Make room for at least `capacity` elements, keeping the current content.
+    void reserve(size_t capacity)
+    {
+        if (capacity <= this->slots.size()) return;
+
+        size_t new_size = 1;
+        while (new_size < capacity) new_size <<= 1;
+
+        std::vector<T> new_slots(new_size);
+        for (size_t i = 0; i < this->count; i++)
+        {
+            new_slots[i] = (*this)[i];
+        }
+        this->slots.swap(new_slots);
+        this->head = 0;
+        this->mask = new_size - 1;
+    }
+
+    size_t size() const { return this->count; }
+    size_t capacity() const { return this->slots.size(); }
+    bool empty() const { return this->count == 0; }
+    bool full() const { return this->count == this->slots.size(); }
+
+    // Element `index` positions after the oldest one.
+    T &operator[](size_t index) { return this->slots[(this->head + index) & this->mask]; }
+    const T &operator[](size_t index) const { return this->slots[(this->head + index) & this->mask]; }
+
+    T &front() { return this->slots[this->head]; }
+    const T &front() const { return this->slots[this->head]; }
+    T &back() { return (*this)[this->count - 1]; }
+    const T &back() const { return (*this)[this->count - 1]; }
+
+    void push_back(const T &value)
+    {
+        if (this->full()) this->grow();
+        this->slots[(this->head + this->count) & this->mask] = value;
+        this->count++;
+    }
+
+    // Put back an element at the head, e.g. a request popped for a forward
+    // that was denied.
+    void push_front(const T &value)
+    {
+        if (this->full()) this->grow();
+        this->head = (this->head - 1) & this->mask;
+        this->slots[this->head] = value;
+        this->count++;
+    }
+
+    void pop_front()
+    {
+        this->head = (this->head + 1) & this->mask;
+        this->count--;
+    }
+
+    void pop_back() { this->count--; }
+
+    // Drop the content but keep the storage.
+    void clear()
+    {
+        this->head = 0;
+        this->count = 0;
+    }
+
+private:
+    void grow() { this->reserve(this->slots.empty() ? 1 : this->slots.size() * 2); }
+
+    std::vector<T> slots;
+    size_t head = 0;
+    size_t count = 0;
+    size_t mask = 0;
+};
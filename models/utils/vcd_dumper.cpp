@@ -17,98 +17,130 @@
 
 /*
  * Authors: Germain Haugou (germain.haugou@gmail.com)
+ *
+ * VCD dumper: replays a VCD waveform file into vp::Signal objects so that
+ * its value changes show up in the GVSoC traces and GUI.
+ *
+ * The file is memory-mapped and parsed in place by a whitespace tokenizer
+ * returning views into the mapping, so neither the header nor the value
+ * changes are copied into strings. Identifier codes are mapped to dense
+ * indexes while parsing the header, and value changes are decoded with the
+ * word-at-a-time decoder shared with the FST dumper. Like the FST dumper,
+ * a single event handler call injects a batch of changes spanning several
+ * timestamps, each one with the time_delay of its timestamp.
  */
 
 #include <vp/vp.hpp>
 #include <vp/signal.hpp>
-#include <iostream>
-#include <fstream>
-#include <unordered_map>
-#include <map>
+#include <utils/logic_value.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <string>
-#include <sstream>
-#include <regex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 class VcdDumper;
 
-class Signal
+class VcdSignal
 {
 public:
-    virtual void finalize(VcdDumper *dumper) {}
-
-    std::string identifier;
-    std::string name;
     std::string full_name;
-    char value = 'x';
-};
-
-class SignalWire : public Signal
-{
-public:
-    void finalize(VcdDumper *dumper) override;
-    int width;
-    SignalWire *parent=NULL;
-    int parent_bit;
-    uint64_t value;
-    vp::Signal<uint64_t> *signal;
+    int width = 1;
+    // Bit-select variable ("$var wire 1 ! data [3] $end"): its changes are
+    // folded into bit parent_bit of the parent, which owns the vp::Signal.
+    VcdSignal *parent = nullptr;
+    int parent_bit = 0;
+    // Next variable declared with the same identifier code.
+    VcdSignal *alias = nullptr;
+    int element_size = 0;
+    vp::Signal<uint64_t> *signal = nullptr;
     std::vector<vp::Signal<uint64_t> *> signal_array;
-    int element_size;
+    // Current value, one 64-bit (value, flags) chunk per 64 bits. Sized when
+    // the signal is finalized so that decoding a change never allocates.
+    std::vector<uint64_t> values;
+    std::vector<uint64_t> flags;
+    // Last (value, flags) pair emitted to each element of a split signal, so
+    // that only the elements which changed are set.
+    std::vector<uint64_t> last_elem_values;
+    std::vector<uint64_t> last_elem_flags;
 };
 
 class VcdDumper : public vp::Component
 {
-
-    friend class SignalWire;
-
 public:
     VcdDumper(vp::ComponentConf &config);
+    ~VcdDumper();
 
 private:
     void reset(bool active);
-    bool read_next();
-    void handle_next_timestamp();
+    bool map_file(const std::string &path);
+    // Next whitespace-separated token of the file, as a view into the
+    // mapping. Empty at the end of the file.
+    std::string_view next_token();
+    // Skip the tokens up to and including the next "$end".
+    void skip_section();
+    void parse_header();
+    void parse_var(const std::vector<std::string> &scope_stack);
+    void finalize(VcdSignal *signal);
+    // Identifier codes of up to ID_TABLE_MAX_CHARS characters are turned
+    // into an index in id_table, each character being a base-95 digit from
+    // 1 ('!') to 94 ('~') so that codes of different lengths don't collide.
+    // Writers allocate codes sequentially, so the table stays dense. Returns
+    // -1 for longer codes, which go through id_map.
+    static int64_t id_code(std::string_view id);
+    VcdSignal *&id_entry(std::string_view id);
+    VcdSignal *id_lookup(std::string_view id);
+    void inject_value(VcdSignal *signal, std::string_view value, int64_t time_delay);
+    void emit(VcdSignal *signal, int64_t time_delay);
     void enqueue_next();
     static void event_handler(vp::Block *__this, vp::TimeEvent *event);
 
-    std::ifstream file;
-    std::unordered_map<std::string, Signal *> signals;
-    std::unordered_map<std::string, Signal *> bitwise_signal_map;
+    static constexpr size_t ID_TABLE_MAX_CHARS = 3;
+
+    const char *file_data = nullptr;
+    size_t file_size = 0;
+    const char *cur = nullptr;
+    const char *end = nullptr;
+    // All variables, in declaration order
+    std::vector<VcdSignal *> signals;
+    std::unordered_map<std::string, VcdSignal *> bitwise_signal_map;
+    std::vector<VcdSignal *> id_table;
+    std::unordered_map<std::string_view, VcdSignal *> id_map;
 
+    // Time of the last timestamp read from the file, -1 if there is no file
     int64_t current_time;
-    Signal *current_signal;
-    std::string current_value;
+    bool done = false;
     vp::TimeEvent event;
+    vp::Trace trace;
     std::unordered_map<std::string, int> element_size;
 };
 
 
-void SignalWire::finalize(VcdDumper *dumper)
+static uint64_t parse_uint(std::string_view str)
 {
-    if (this->parent == NULL)
+    uint64_t value = 0;
+    for (char c : str)
     {
-        auto it = dumper->element_size.find(this->full_name);
-        if (it != dumper->element_size.end())
+        if (c < '0' || c > '9')
         {
-            int element_size = it->second;
-            int nb_elements = this->width / element_size;
-            this->element_size = element_size;
-
-            for (int i=0; i<nb_elements; i++)
-            {
-                this->signal_array.push_back(
-                    new vp::Signal<uint64_t>(*dumper, this->full_name + "[" + std::to_string(i) + "]", element_size));
-            }
-        }
-        else
-        {
-            this->signal = new vp::Signal<uint64_t>(*dumper, this->full_name, this->width);
+            break;
         }
+        value = value * 10 + (c - '0');
     }
+    return value;
 }
 
 VcdDumper::VcdDumper(vp::ComponentConf &config)
     : vp::Component(config), event(this, &VcdDumper::event_handler)
 {
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
     this->current_time = -1;
 
     js::Config *element_size = this->get_js_config()->get("element_size");
@@ -121,121 +153,282 @@ VcdDumper::VcdDumper(vp::ComponentConf &config)
     }
 
     std::string vcd_file_path = this->get_js_config()->get_child_str("vcd_file");
-    if (vcd_file_path != "")
+    if (vcd_file_path != "" && this->map_file(vcd_file_path))
+    {
+        this->parse_header();
+
+        for (VcdSignal *signal : this->signals)
+        {
+            this->finalize(signal);
+        }
+
+        this->current_time = 0;
+    }
+}
+
+VcdDumper::~VcdDumper()
+{
+    for (VcdSignal *signal : this->signals)
+    {
+        delete signal;
+    }
+    if (this->file_data)
     {
+        munmap((void *)this->file_data, this->file_size);
+    }
+}
 
-        this->file.open(vcd_file_path);
+bool VcdDumper::map_file(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        this->trace.fatal("Failed to open VCD file %s\n", path.c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1)
+    {
+        close(fd);
+        this->trace.fatal("Failed to stat VCD file %s\n", path.c_str());
+        return false;
+    }
 
-        std::string line;
-        std::vector<std::string> scope_stack;
-        while (std::getline(file, line))
+    this->file_size = st.st_size;
+    if (this->file_size > 0)
+    {
+        void *data = mmap(nullptr, this->file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
         {
-            if (line == "$enddefinitions $end")
-            {
-                break;
-            }
+            close(fd);
+            this->trace.fatal("Failed to map VCD file %s\n", path.c_str());
+            return false;
+        }
+        // The file is parsed once from start to end
+        madvise(data, this->file_size, MADV_SEQUENTIAL);
+        this->file_data = (const char *)data;
+    }
+    close(fd);
 
-            std::istringstream iss(line);
-            std::string token;
-            iss >> token;
+    this->cur = this->file_data;
+    this->end = this->file_data + this->file_size;
+    return true;
+}
 
-            if (token == "$scope")
-            {
-                std::string type, name;
-                iss >> type >> name;
-                scope_stack.push_back(name);
-            }
-            else if (token == "$upscope")
+std::string_view VcdDumper::next_token()
+{
+    const char *cur = this->cur;
+    const char *end = this->end;
+    while (cur < end && (unsigned char)*cur <= ' ')
+    {
+        cur++;
+    }
+    const char *start = cur;
+    while (cur < end && (unsigned char)*cur > ' ')
+    {
+        cur++;
+    }
+    this->cur = cur;
+    return std::string_view(start, cur - start);
+}
+
+void VcdDumper::skip_section()
+{
+    while (true)
+    {
+        std::string_view token = this->next_token();
+        if (token.empty() || token == "$end")
+        {
+            return;
+        }
+    }
+}
+
+void VcdDumper::parse_header()
+{
+    std::vector<std::string> scope_stack;
+    while (true)
+    {
+        std::string_view token = this->next_token();
+        if (token.empty())
+        {
+            return;
+        }
+
+        if (token == "$enddefinitions")
+        {
+            this->skip_section();
+            return;
+        }
+        else if (token == "$scope")
+        {
+            this->next_token();
+            scope_stack.emplace_back(this->next_token());
+            this->skip_section();
+        }
+        else if (token == "$upscope")
+        {
+            if (!scope_stack.empty())
             {
-                if (!scope_stack.empty())
-                {
-                    scope_stack.pop_back();
-                }
+                scope_stack.pop_back();
             }
-            else if (token == "$var")
-            {
-                std::string type, size, id, name, bit;
-                iss >> type >> size >> id >> name >> bit;
-
-                // If name has brackets, parse bit index
-                int bit_index = -1;
-                std::string base_name = name;
-                size_t bracket_pos = bit.find('[');
-                int width;
-                if (bracket_pos != std::string::npos)
-                {
-                    int column_pos = bit.find(':');
-                    if (column_pos == std::string::npos)
-                    {
-                        size_t end_bracket = bit.find(']', bracket_pos);
-                        if (end_bracket != std::string::npos)
-                        {
-                            std::string bit_str = bit.substr(bracket_pos + 1, end_bracket - bracket_pos - 1);
-                            bit_index = std::stoi(bit_str);
-                        }
-                    }
-                    else
-                    {
-                        std::string high_str = bit.substr(bracket_pos + 1, column_pos - 1);
-                        std::string low_str = bit.substr(column_pos + 1, bit.size() - (column_pos + 1) - 1);
-                        width = std::stoi(high_str) - std::stoi(low_str) + 1;
-                    }
-                }
+            this->skip_section();
+        }
+        else if (token == "$var")
+        {
+            this->parse_var(scope_stack);
+        }
+        else if (token[0] == '$' && token != "$end")
+        {
+            // $date, $version, $timescale, $comment, ...
+            this->skip_section();
+        }
+    }
+}
 
-                std::ostringstream fullName;
-                for (const auto &s : scope_stack)
-                {
-                    fullName << s << ".";
-                }
-                fullName << name;
+void VcdDumper::parse_var(const std::vector<std::string> &scope_stack)
+{
+    // $var <type> <size> <id> <name> [<range>] $end
+    this->next_token();
+    std::string_view size = this->next_token();
+    std::string_view id = this->next_token();
+    std::string_view name = this->next_token();
+    std::string_view range = this->next_token();
+    if (range == "$end")
+    {
+        range = std::string_view();
+    }
+    else
+    {
+        this->skip_section();
+    }
 
-                if (bit_index != -1)
-                {
-                    if (this->bitwise_signal_map.find(fullName.str()) ==
-                        this->bitwise_signal_map.end())
-                    {
-                        SignalWire *parent = new SignalWire();
-                        parent->width = 0;
-                        parent->name = name;
-                        parent->full_name = fullName.str();
-                        this->bitwise_signal_map[fullName.str()] = (Signal *)parent;
-                    }
-                }
+    // Some writers attach the range to the name ("data[3]")
+    size_t bracket_pos = name.find('[');
+    if (range.empty() && bracket_pos != std::string_view::npos && bracket_pos > 0 &&
+        name.back() == ']')
+    {
+        range = name.substr(bracket_pos);
+        name = name.substr(0, bracket_pos);
+    }
 
-                SignalWire *signal = new SignalWire();
-                signal->identifier = id;
-                signal->name = name;
-                signal->full_name = fullName.str();
-                signal->parent_bit = bit_index;
-                this->signals[id] = signal;
+    // A single bit index makes this variable one bit of a parent signal, a
+    // [high:low] range is just the declared size.
+    int bit_index = -1;
+    if (range.size() > 2 && range[0] == '[' && range.find(':') == std::string_view::npos)
+    {
+        bit_index = (int)parse_uint(range.substr(1));
+    }
 
-                if (bit_index != -1)
-                {
-                    signal->parent = (SignalWire *)this->bitwise_signal_map[fullName.str()];
-                    if (signal->parent->width <= bit_index)
-                    {
-                        signal->parent->width = bit_index + 1;
-                    }
-                }
-                else
-                {
-                    signal->width = width;
-                }
-            }
+    std::string full_name;
+    for (const auto &s : scope_stack)
+    {
+        full_name += s;
+        full_name += ".";
+    }
+    full_name += name;
+
+    VcdSignal *signal = new VcdSignal();
+    signal->full_name = full_name;
+    signal->width = std::max<int>(parse_uint(size), 1);
+    this->signals.push_back(signal);
+
+    if (bit_index != -1)
+    {
+        VcdSignal *&parent = this->bitwise_signal_map[full_name];
+        if (parent == nullptr)
+        {
+            parent = new VcdSignal();
+            parent->full_name = full_name;
+            parent->width = 0;
+            this->signals.push_back(parent);
         }
+        parent->width = std::max(parent->width, bit_index + 1);
+        signal->parent = parent;
+        signal->parent_bit = bit_index;
+    }
 
-        for (auto it: this->signals)
+    VcdSignal *&entry = this->id_entry(id);
+    signal->alias = entry;
+    entry = signal;
+}
+
+void VcdDumper::finalize(VcdSignal *signal)
+{
+    if (signal->parent != nullptr)
+    {
+        return;
+    }
+
+    int nb_chunks = (signal->width + 63) / 64;
+    signal->values.assign(nb_chunks, 0);
+    signal->flags.assign(nb_chunks, 0);
+
+    auto it = this->element_size.find(signal->full_name);
+    if (it != this->element_size.end() && it->second > 0)
+    {
+        int element_size = std::min(it->second, 64);
+        int nb_elements = signal->width / element_size;
+        signal->element_size = element_size;
+        signal->last_elem_values.assign(nb_elements, 0);
+        signal->last_elem_flags.assign(nb_elements, 0);
+
+        for (int i=0; i<nb_elements; i++)
         {
-            it.second->finalize(this);
+            signal->signal_array.push_back(
+                new vp::Signal<uint64_t>(*this, signal->full_name + "[" + std::to_string(i) + "]", element_size));
         }
+    }
+    else
+    {
+        signal->signal = new vp::Signal<uint64_t>(*this, signal->full_name, signal->width);
+    }
+}
 
-        for (auto it: this->bitwise_signal_map)
+int64_t VcdDumper::id_code(std::string_view id)
+{
+    if (id.empty() || id.size() > ID_TABLE_MAX_CHARS)
+    {
+        return -1;
+    }
+    int64_t code = 0;
+    for (size_t i = id.size(); i-- > 0;)
+    {
+        unsigned char c = id[i];
+        if (c < '!' || c > '~')
         {
-            it.second->finalize(this);
+            return -1;
         }
+        code = code * 95 + (c - ' ');
+    }
+    return code;
+}
+
+VcdSignal *&VcdDumper::id_entry(std::string_view id)
+{
+    int64_t code = id_code(id);
+    if (code == -1)
+    {
+        // The view points into the mapped file, which outlives the map
+        return this->id_map[id];
+    }
+    if ((size_t)code >= this->id_table.size())
+    {
+        this->id_table.resize(code + 1, nullptr);
+    }
+    return this->id_table[code];
+}
 
-        this->read_next();
+inline VcdSignal *VcdDumper::id_lookup(std::string_view id)
+{
+    int64_t code = id_code(id);
+    if (code != -1)
+    {
+        return (size_t)code < this->id_table.size() ? this->id_table[code] : nullptr;
     }
+    auto it = this->id_map.find(id);
+    return it == this->id_map.end() ? nullptr : it->second;
 }
 
 void VcdDumper::reset(bool active)
@@ -249,15 +442,62 @@ void VcdDumper::reset(bool active)
 void VcdDumper::event_handler(vp::Block *__this, vp::TimeEvent *event)
 {
     VcdDumper *_this = (VcdDumper *)__this;
-
-    int64_t time = _this->time.get_time();
-    while(_this->current_time == time)
+    int64_t now = _this->time.get_time();
+
+    // Same batching as the FST dumper: changes of several timestamps are
+    // injected in one call, each one with the delay of its timestamp, so
+    // that the number of TimeEvent round-trips does not grow with the
+    // number of timestamps in the file.
+    constexpr int BATCH_LIMIT = 16384;
+    int processed = 0;
+    while (processed < BATCH_LIMIT)
     {
-        if (_this->read_next())
+        std::string_view token = _this->next_token();
+        if (token.empty())
         {
+            _this->done = true;
             break;
         }
-        _this->handle_next_timestamp();
+
+        std::string_view value, id;
+        switch (token[0])
+        {
+        case '#':
+            _this->current_time = parse_uint(token.substr(1));
+            continue;
+
+        case '$':
+            // $dumpvars, $dumpall, $dumpon, $dumpoff and their $end only
+            // delimit value changes
+            if (token == "$comment")
+            {
+                _this->skip_section();
+            }
+            continue;
+
+        case 'b': case 'B':
+            value = token.substr(1);
+            id = _this->next_token();
+            break;
+
+        case 'r': case 'R':
+            // Real values are not supported
+            _this->next_token();
+            continue;
+
+        default:
+            value = token.substr(0, 1);
+            id = token.substr(1);
+            break;
+        }
+
+        VcdSignal *signal = _this->id_lookup(id);
+        if (signal != nullptr)
+        {
+            int64_t delay = _this->current_time - now;
+            _this->inject_value(signal, value, delay < 0 ? 0 : delay);
+        }
+        processed++;
     }
 
     _this->enqueue_next();
@@ -265,87 +505,98 @@ void VcdDumper::event_handler(vp::Block *__this, vp::TimeEvent *event)
 
 void VcdDumper::enqueue_next()
 {
-    if (this->current_time != -1)
+    if (this->current_time == -1)
     {
-        this->event.enqueue(this->current_time - this->time.get_time());
+        return;
     }
+    if (this->done)
+    {
+        this->time.get_engine()->quit(0);
+        return;
+    }
+    int64_t delta = this->current_time - this->time.get_time();
+    this->event.enqueue(delta < 0 ? 0 : delta);
 }
 
-void VcdDumper::handle_next_timestamp()
+void VcdDumper::inject_value(VcdSignal *signal, std::string_view value, int64_t time_delay)
 {
-    SignalWire *signal = (SignalWire *)this->current_signal;
-    if (signal->signal_array.size() > 0)
+    if (value.empty())
     {
-        int pos = this->current_value.size();
-        for (int i=0; i<signal->signal_array.size() && pos > 0; i++)
-        {
-            int chunkSize = std::min(signal->element_size, pos);
-            int start = pos - chunkSize;
-            std::string chunk = this->current_value.substr(start, chunkSize);
-            uint64_t value = std::stoll(chunk, nullptr, 2);
-            pos -= chunkSize;
-            signal->signal_array[i]->set(value);
-        }
+        return;
     }
-    else
+
+    for (; signal != nullptr; signal = signal->alias)
     {
         if (signal->parent)
         {
-            uint64_t value = std::stoll(this->current_value);
-            signal->parent->value = (signal->parent->value & ~(1 << signal->parent_bit)) | (value << signal->parent_bit);
-            signal->parent->signal->set(signal->parent->value);
+            VcdSignal *parent = signal->parent;
+            int bit = signal->parent_bit;
+            uint64_t mask = (uint64_t)1 << (bit % 64);
+            parent->values[bit / 64] &= ~mask;
+            parent->flags[bit / 64] &= ~mask;
+            logic_value::decode_bit(value.back(), bit, parent->values.data(),
+                parent->flags.data());
+            this->emit(parent, time_delay);
         }
         else
         {
-            uint64_t value = std::stoll(this->current_value, nullptr, 2);
-            signal->signal->set(value);
+            // Values are right-aligned: a shorter value is extended with 0,
+            // or with X/Z if its leftmost bit is X/Z.
+            uint64_t *values = signal->values.data();
+            uint64_t *flags = signal->flags.data();
+            int nb_bits = std::min<int>(value.size(), signal->width);
+            int nb_chunks = (nb_bits + 63) / 64;
+            logic_value::decode((const unsigned char *)value.data() + value.size() - nb_bits,
+                nb_bits, values, flags);
+            std::fill(values + nb_chunks, values + signal->values.size(), 0);
+            std::fill(flags + nb_chunks, flags + signal->flags.size(), 0);
+            char msb = value[0];
+            if (nb_bits < signal->width &&
+                (msb == 'x' || msb == 'X' || msb == 'z' || msb == 'Z'))
+            {
+                for (int bit = nb_bits; bit < signal->width; bit++)
+                {
+                    logic_value::decode_bit(msb, bit, values, flags);
+                }
+            }
+            this->emit(signal, time_delay);
         }
     }
 }
 
-bool VcdDumper::read_next()
+void VcdDumper::emit(VcdSignal *signal, int64_t time_delay)
 {
-    std::string line;
-    while (std::getline(file, line))
+    if (signal->signal_array.size() > 0)
     {
-        if (line.empty()) continue;
-
-        if (line[0] == '#')
-        {
-            this->current_time = std::stoll(line.substr(1));
-            this->current_signal = NULL;
-            this->current_value = '\0';
-            return true;
-        }
-        else
+        // Element i covers bits [(i+1)*element_size-1 : i*element_size]
+        int elem_size = signal->element_size;
+        uint64_t mask = elem_size >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << elem_size) - 1;
+        for (size_t i = 0; i < signal->signal_array.size(); i++)
         {
-            std::string val;
-            std::string id;
-
-            if (line[0] == 'b')
+            int bit_lo = i * elem_size;
+            uint64_t v_slice = (signal->values[bit_lo / 64] >> (bit_lo % 64)) & mask;
+            uint64_t f_slice = (signal->flags[bit_lo / 64] >> (bit_lo % 64)) & mask;
+            if (v_slice == signal->last_elem_values[i] && f_slice == signal->last_elem_flags[i])
             {
-                std::istringstream iss(line);
-                std::string prefix;
-                iss >> prefix >> id;
-                val = prefix.substr(1);
-            }
-            else
-            {
-                val = line[0];
-                id = line.substr(1);
-            }
-            auto it = signals.find(id);
-            if (it != signals.end())
-            {
-                this->current_signal = it->second;
-                this->current_value = val;
-                return false;
+                continue;
             }
+            signal->last_elem_values[i] = v_slice;
+            signal->last_elem_flags[i] = f_slice;
+            this->trace.msg(vp::Trace::LEVEL_DEBUG,
+                "Setting signal (name: %s[%zu], value: 0x%lx, flags: 0x%lx, time: %ld)\n",
+                signal->full_name.c_str(), i, v_slice, f_slice,
+                this->time.get_time() + time_delay);
+            signal->signal_array[i]->set(v_slice, f_slice, 0, time_delay);
         }
     }
-    this->current_time = -1;
-    this->time.get_engine()->quit(0);
-    return true;
+    else if (signal->signal)
+    {
+        this->trace.msg(vp::Trace::LEVEL_DEBUG,
+            "Setting signal (name: %s, value: 0x%lx, flags: 0x%lx, time: %ld)\n",
+            signal->full_name.c_str(), signal->values[0], signal->flags[0],
+            this->time.get_time() + time_delay);
+        signal->signal->set(signal->values[0], signal->flags[0], 0, time_delay);
+    }
 }
 
 extern "C" vp::Component *gv_new(vp::ComponentConf &config)
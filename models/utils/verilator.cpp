@@ -23,6 +23,12 @@
  * a vp::Signal in the GVSoC trace engine, visible in the gvsoc-gui3
  * timeline. The plugin uses Verilator's VPI cbValueChange to drive the
  * stream.
+ *
+ * Batched stepping: when `batch_horizon` is set and the plugin exports
+ * the batched entry point, each host event lets the plugin advance up to
+ * that many picoseconds and collects the signal changes in one packed
+ * array, so a run crosses the plugin boundary once per horizon instead of
+ * once per cycle and once per change.
  */
 
 #include <vp/vp.hpp>
@@ -46,6 +52,8 @@ public:
 
 private:
     static void step_handler(vp::Block *_this, vp::TimeEvent *event);
+    void step_batch();
+    void design_exited(int exit_code);
 
     /* Host-side callbacks plugged into the plugin via set_host_callbacks.
        The plugin uses these to expose signals to the GVSoC trace engine. */
@@ -62,6 +70,8 @@ private:
     std::vector<std::string> firmwares;
     std::vector<std::string> plusargs;
     bool inject_signals = false;
+    /* Horizon in ps handed to step_batch, 0 to use the per-step ABI. */
+    int64_t batch_horizon = 0;
 
     /* Storage for the argv array we hand to the plugin. argv_storage owns
        the strings; argv_ptrs holds pointers into it for plugin->open(). */
@@ -71,6 +81,10 @@ private:
     void *handle = nullptr;
     const VlPluginVtable *vt = nullptr;
     VlPlugin *design = nullptr;
+    /* Non-null when batched stepping is enabled and the plugin supports it. */
+    const VlPluginBatchVtable *batch_vt = nullptr;
+    /* Change buffer reused by every step_batch call. */
+    std::vector<VlSignalChange> batch_changes;
 
     /* Signals registered by the plugin. Held by unique_ptr so their
        lifetime matches the component, not the plugin. The cookie returned
@@ -125,6 +139,12 @@ VerilatorControl::VerilatorControl(vp::ComponentConf &config)
         this->inject_signals = inject_cfg->get_bool();
     }
 
+    js::Config *horizon_cfg = js->get("batch_horizon");
+    if (horizon_cfg != nullptr)
+    {
+        this->batch_horizon = horizon_cfg->get_int();
+    }
+
     /* Free-form plusarg pass-through: each element in the `plusargs`
        array is appended verbatim to the plugin's argv. Target files
        use this to plumb design-specific options (e.g. audio source /
@@ -156,6 +176,24 @@ void VerilatorControl::start()
     }
     this->vt = get_vt();
 
+    if (this->batch_horizon > 0)
+    {
+        /* Optional symbol, older plugins only have the per-step vtable. */
+        auto get_batch_vt = (const VlPluginBatchVtable *(*)())dlsym(this->handle,
+            "gv_verilator_plugin_batch_get");
+        if (get_batch_vt != nullptr)
+        {
+            this->batch_vt = get_batch_vt();
+            this->batch_changes.resize(4096);
+        }
+        else
+        {
+            this->trace.force_warning_no_error(
+                "verilator_control: '%s' has no batched entry point, using per-step ABI\n",
+                this->plugin_path.c_str());
+        }
+    }
+
     /* Build a Verilator-style argv. argv[0] is conventionally the program name. */
     this->argv_storage.clear();
     this->argv_storage.push_back("gvsoc-verilator");
@@ -261,12 +299,15 @@ void VerilatorControl::on_pause()
 void VerilatorControl::step_handler(vp::Block *_this, vp::TimeEvent *)
 {
     VerilatorControl *t = (VerilatorControl *)_this;
+    if (t->batch_vt != nullptr)
+    {
+        t->step_batch();
+        return;
+    }
     VlStepResult r = t->vt->step(t->design);
     if (r.exit_code >= 0)
     {
-        t->trace.msg(vp::Trace::LEVEL_INFO,
-            "verilator_control: design exited with code %d\n", r.exit_code);
-        t->time.get_engine()->quit(r.exit_code);
+        t->design_exited(r.exit_code);
         return;
     }
     /* Re-enqueue at +time_to_next ps. The plugin chooses how far ahead,
@@ -275,6 +316,42 @@ void VerilatorControl::step_handler(vp::Block *_this, vp::TimeEvent *)
     t->step_event.enqueue(r.time_to_next);
 }
 
+void VerilatorControl::step_batch()
+{
+    VlBatchResult r = this->batch_vt->step_batch(this->design, this->batch_horizon,
+        this->batch_changes.data(), (uint32_t)this->batch_changes.size());
+
+    /* Same conversion as vl_push_logical, without a call per change. */
+    int64_t now = this->time.get_time();
+    for (uint32_t i = 0; i < r.nb_changes; i++)
+    {
+        VlSignalChange &change = this->batch_changes[i];
+        if (change.sig != nullptr)
+        {
+            int64_t delta = change.time_ps - now;
+            this->trace.msg(vp::Trace::LEVEL_DEBUG,
+                "verilator_control: signal change (value: 0x%lx, time: %ld)\n",
+                change.value, now + delta);
+            static_cast<vp::Signal<uint64_t> *>(change.sig)->set(change.value, (int64_t)0,
+                delta);
+        }
+    }
+
+    if (r.exit_code >= 0)
+    {
+        this->design_exited(r.exit_code);
+        return;
+    }
+    this->step_event.enqueue(r.time_to_next);
+}
+
+void VerilatorControl::design_exited(int exit_code)
+{
+    this->trace.msg(vp::Trace::LEVEL_INFO,
+        "verilator_control: design exited with code %d\n", exit_code);
+    this->time.get_engine()->quit(exit_code);
+}
+
 VlSignal VerilatorControl::vl_reg_logical(void *ctx, const char *path, int width,
                                           const char *description)
 {
@@ -318,6 +395,9 @@ void VerilatorControl::vl_push_logical(void *ctx, VlSignal sig, uint64_t value,
        flushed retroactively). The trace engine accepts past timestamps
        (Event::dump_* just stores time + delta). */
     int64_t delta = time_ps - self->time.get_time();
+    self->trace.msg(vp::Trace::LEVEL_DEBUG,
+        "verilator_control: signal change (value: 0x%lx, time: %ld)\n", value,
+        self->time.get_time() + delta);
     /* int64_t literal disambiguates from the 4-arg set(value, flags, ...). */
     static_cast<vp::Signal<uint64_t> *>(sig)->set(value, (int64_t)0, delta);
 }
@@ -42,10 +42,17 @@ from gvrun.parameter import TargetParameter
 
 class VerilatorControl(st.Component):
     """Bind to the C++ ``utils.verilator`` model that owns the
-    :class:`VerilatedContext` and steps the design once per clock cycle."""
+    :class:`VerilatedContext` and steps the design once per clock cycle.
+
+    With ``batch_horizon`` (in ps), the design is instead advanced by up to
+    that much time per host event through the plugin's batched entry
+    point, and its signal changes come back as one packed array. Plugins
+    without that entry point fall back to per-step calls. ``plusargs`` are
+    appended verbatim to the plugin's argv.
+    """
 
     def __init__(self, parent, name, plugin_path=None, firmwares=None, trace_path=None,
-                 inject_signals=False):
+                 inject_signals=False, batch_horizon=0, plusargs=None):
         super().__init__(parent, name)
         self.add_sources(['utils/verilator.cpp'])
         if plugin_path is not None:
@@ -56,6 +63,10 @@ class VerilatorControl(st.Component):
             self.add_property('trace_path', trace_path)
         if inject_signals:
             self.add_property('inject_signals', True)
+        if batch_horizon:
+            self.add_property('batch_horizon', batch_horizon)
+        if plusargs:
+            self.add_property('plusargs', list(plusargs))
 
     def gen_gui(self, parent_signal):
         # Only emit the SignalGenAll entry when the plugin will actually
@@ -18,6 +18,16 @@
  *
  * Everything design-specific (clock toggling, reset sequence, trace dumping,
  * exit-pin sampling, signal injection) lives behind that vtable.
+ *
+ * A plugin may also export the optional batched entry point:
+ *
+ *     extern "C" const VlPluginBatchVtable *gv_verilator_plugin_batch_get(void);
+ *
+ * With it, the host asks the plugin to advance up to a horizon it chooses
+ * and gets the signal changes back as one packed array, instead of one
+ * step() call per time_to_next and one push_logical() call per change.
+ * It is a separate symbol so that plugins built against the original
+ * vtable keep loading unchanged.
  */
 
 #ifndef GVSOC_VERILATOR_PLUGIN_H
@@ -143,6 +153,54 @@ typedef struct {
 
 const VlPluginVtable *gv_verilator_plugin_get(void);
 
+/*
+ * One signal change reported by step_batch(). Same meaning as the
+ * arguments of VlHostCb::push_logical.
+ */
+typedef struct {
+    VlSignal sig;
+    uint64_t value;
+    int64_t time_ps;
+} VlSignalChange;
+
+/*
+ * Result of a step_batch() call.
+ */
+typedef struct {
+    /* Same as VlStepResult::exit_code. */
+    int exit_code;
+
+    /*
+     * Picoseconds the host should wait before calling step_batch() again,
+     * i.e. how far the plugin advanced during this call. Only meaningful
+     * when exit_code == -1.
+     */
+    int64_t time_to_next;
+
+    /* Number of entries written to the `changes` array. */
+    uint32_t nb_changes;
+} VlBatchResult;
+
+typedef struct {
+    /*
+     * Advance the design by at most `horizon_ps` picoseconds and write the
+     * signal changes which happened meanwhile to `changes`, in time order.
+     *
+     * The plugin may stop before the horizon, either because the design
+     * exited or because `max_changes` entries were written; the host then
+     * resumes after time_to_next. Changes that did not fit must be kept
+     * and reported by the next call, never dropped.
+     *
+     * Changes returned here are not pushed through VlHostCb::push_logical.
+     * Signals are still registered through VlHostCb::reg_logical, so
+     * plugins only report changes once set_host_callbacks() was called.
+     */
+    VlBatchResult (*step_batch)(VlPlugin *, int64_t horizon_ps,
+                                VlSignalChange *changes, uint32_t max_changes);
+} VlPluginBatchVtable;
+
+const VlPluginBatchVtable *gv_verilator_plugin_batch_get(void);
+
 #ifdef __cplusplus
 }
 #endif
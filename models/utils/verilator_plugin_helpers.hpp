@@ -681,6 +681,31 @@ struct PluginCommon
         return rc;                                                         \
     }
 
+/* Emits the batched entry point on top of the per-step one: step() is
+   called back to back until the horizon is covered, so the host crosses
+   into the plugin once per horizon. Signal changes keep going through
+   push_logical (the VCD parser), none are returned in the array. */
+#define GV_VERILATOR_PLUGIN_BATCH_FROM_STEP(step_fn)                       \
+    static VlBatchResult gv_vl_step_batch_(VlPlugin *p, int64_t horizon_ps, \
+        VlSignalChange *, uint32_t)                                        \
+    {                                                                      \
+        VlBatchResult res = { -1, 0, 0 };                                  \
+        do {                                                               \
+            VlStepResult r = (step_fn)(p);                                 \
+            if (r.exit_code >= 0) { res.exit_code = r.exit_code; break; }  \
+            if (r.time_to_next <= 0) break;                                \
+            res.time_to_next += r.time_to_next;                            \
+        } while (res.time_to_next < horizon_ps);                           \
+        return res;                                                        \
+    }                                                                      \
+    static const VlPluginBatchVtable gv_vl_batch_vtable_ = {               \
+        gv_vl_step_batch_,                                                 \
+    };                                                                     \
+    extern "C" const VlPluginBatchVtable *gv_verilator_plugin_batch_get(void) \
+    {                                                                      \
+        return &gv_vl_batch_vtable_;                                       \
+    }
+
 #if defined(GV_TRACE_VCD)
 #define GV_VERILATOR_PLUGIN_DEFINE(open_fn, step_fn)                       \
     static void gv_vl_close_(VlPlugin *p)                                  \
@@ -702,6 +727,7 @@ struct PluginCommon
     {                                                                      \
         return &gv_vl_vtable_;                                             \
     }                                                                      \
+    GV_VERILATOR_PLUGIN_BATCH_FROM_STEP(step_fn)                           \
     GV_VERILATOR_PLUGIN_STANDALONE_MAIN()
 #else
 #define GV_VERILATOR_PLUGIN_DEFINE(open_fn, step_fn)                       \
@@ -719,6 +745,7 @@ struct PluginCommon
     {                                                                      \
         return &gv_vl_vtable_;                                             \
     }                                                                      \
+    GV_VERILATOR_PLUGIN_BATCH_FROM_STEP(step_fn)                           \
     GV_VERILATOR_PLUGIN_STANDALONE_MAIN()
 #endif
 
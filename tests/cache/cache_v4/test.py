@@ -88,8 +88,9 @@ def build_case(case_name: str) -> dict:
 
     if case_name == 'queue_during_refill':
         # Miss A starts a long async refill. Miss B (different line) arrives during
-        # the refill and must be queued (GRANTED upstream) and only processed once
-        # A's refill lands. Validates refill_pending_reqs + fsm_handler.
+        # the refill and, with the single default MSHR, must be queued (GRANTED
+        # upstream) and only processed once A's refill lands. Validates
+        # refill_pending_reqs + fsm_handler.
         rules = [dict(addr_min=0, addr_max=0xFFFF_FFFF, behavior='granted',
                       resp_delay=30, retry_delay=0)]
         return {
@@ -101,6 +102,119 @@ def build_case(case_name: str) -> dict:
             'rules': rules,
         }
 
+    if case_name == 'hit_under_miss':
+        # Line B (0x40) is primed with a synchronous refill. A miss on line A
+        # starts a long async refill, a second access to line A is merged into
+        # its MSHR, and a hit on line B must be served while A is refilling.
+        rules = [
+            dict(addr_min=0x00, addr_max=0x0F, behavior='granted',
+                 resp_delay=30, retry_delay=0),
+            dict(addr_min=0x10, addr_max=0xFFFF_FFFF, behavior='done',
+                 resp_delay=0, retry_delay=0),
+        ]
+        return {
+            'cache_config': cache_cfg(),
+            'schedule': [
+                dict(cycle=5,  addr=0x40, size=4, is_write=False, name='prime_b'),
+                dict(cycle=10, addr=0x00, size=4, is_write=False, name='rA'),
+                dict(cycle=12, addr=0x08, size=4, is_write=False, name='rA2'),
+                dict(cycle=14, addr=0x44, size=4, is_write=False, name='rB'),
+            ],
+            'rules': rules,
+        }
+
+    if case_name == 'mshr_parallel':
+        # Two MSHRs: two misses on different lines must both be sent to the
+        # refill target before the first one comes back.
+        rules = [dict(addr_min=0, addr_max=0xFFFF_FFFF, behavior='granted',
+                      resp_delay=30, retry_delay=0)]
+        return {
+            'cache_config': cache_cfg(nb_mshrs=2),
+            'schedule': [
+                dict(cycle=10, addr=0x00, size=4, is_write=False, name='rA'),
+                dict(cycle=12, addr=0x40, size=4, is_write=False, name='rB'),
+            ],
+            'rules': rules,
+        }
+
+    if case_name in ('replacement_lru', 'replacement_fifo'):
+        # One fully-associative set of 4 ways. Fill it with A, B, C, D, touch
+        # A again, then miss on E: LRU evicts B and the final read of A hits,
+        # FIFO evicts A and the final read of A misses.
+        return {
+            'cache_config': cache_cfg(size=64, ways=4,
+                                      replacement=case_name.split('_')[1]),
+            'schedule': [
+                dict(cycle=10, addr=0x00, size=4, is_write=False, name='a'),
+                dict(cycle=20, addr=0x10, size=4, is_write=False, name='b'),
+                dict(cycle=30, addr=0x20, size=4, is_write=False, name='c'),
+                dict(cycle=40, addr=0x30, size=4, is_write=False, name='d'),
+                dict(cycle=50, addr=0x00, size=4, is_write=False, name='a_hit'),
+                dict(cycle=60, addr=0x40, size=4, is_write=False, name='e'),
+                dict(cycle=70, addr=0x00, size=4, is_write=False, name='a_last'),
+            ],
+            'rules': mem_ok,
+        }
+
+    if case_name == 'replacement_plru':
+        # One 4-way set with tree PLRU. Once A, B, C, D fill ways 0-3, the
+        # root points left and the victims follow the tree: E evicts A (way
+        # 0), which flips the root right so F evicts C (way 2). B is still
+        # cached (LRU or FIFO would have evicted it by then) and hitting it
+        # flips the root right again, so G evicts D (way 3), then H evicts E
+        # (way 0). F and B hit, and the last read of E misses and evicts G
+        # (way 3).
+        return {
+            'cache_config': cache_cfg(size=64, ways=4, replacement='plru'),
+            'schedule': [
+                dict(cycle=10,  addr=0x00, size=4, is_write=False, name='a'),
+                dict(cycle=20,  addr=0x10, size=4, is_write=False, name='b'),
+                dict(cycle=30,  addr=0x20, size=4, is_write=False, name='c'),
+                dict(cycle=40,  addr=0x30, size=4, is_write=False, name='d'),
+                dict(cycle=50,  addr=0x40, size=4, is_write=False, name='e'),
+                dict(cycle=60,  addr=0x50, size=4, is_write=False, name='f'),
+                dict(cycle=70,  addr=0x10, size=4, is_write=False, name='b_hit'),
+                dict(cycle=80,  addr=0x60, size=4, is_write=False, name='g'),
+                dict(cycle=90,  addr=0x70, size=4, is_write=False, name='h'),
+                dict(cycle=100, addr=0x50, size=4, is_write=False, name='f_hit'),
+                dict(cycle=110, addr=0x10, size=4, is_write=False, name='b_hit2'),
+                dict(cycle=120, addr=0x40, size=4, is_write=False, name='e_last'),
+            ],
+            'rules': mem_ok,
+        }
+
+    if case_name == 'prefetch_next_line':
+        # Async refills, 2 MSHRs. The miss on line 0 also prefetches line 1, so
+        # the later read of line 1 hits, and its first hit prefetches line 2.
+        # Line 3 is requested while its prefetch is in flight (late).
+        rules = [dict(addr_min=0, addr_max=0xFFFF_FFFF, behavior='granted',
+                      resp_delay=20, retry_delay=0)]
+        return {
+            'cache_config': cache_cfg(nb_mshrs=2, prefetcher='next_line'),
+            'schedule': [
+                dict(cycle=10, addr=0x00, size=4, is_write=False, name='r0'),
+                dict(cycle=50, addr=0x10, size=4, is_write=False, name='r1'),
+                dict(cycle=80, addr=0x20, size=4, is_write=False, name='r2'),
+                dict(cycle=82, addr=0x30, size=4, is_write=False, name='r3'),
+            ],
+            'rules': rules,
+        }
+
+    if case_name == 'prefetch_stride':
+        # Synchronous refills. Misses every 4 lines: once the stride is seen
+        # twice (0x00 -> 0x40 -> 0x80), 0xC0 is prefetched and the access to it
+        # hits.
+        return {
+            'cache_config': cache_cfg(size=256, prefetcher='stride'),
+            'schedule': [
+                dict(cycle=10, addr=0x00, size=4, is_write=False, name='s0'),
+                dict(cycle=20, addr=0x40, size=4, is_write=False, name='s1'),
+                dict(cycle=30, addr=0x80, size=4, is_write=False, name='s2'),
+                dict(cycle=40, addr=0xC0, size=4, is_write=False, name='s3'),
+            ],
+            'rules': mem_ok,
+        }
+
     if case_name == 'bypass_done':
         # Cache disabled at reset, target returns DONE inline. The cache should
         # forward the request addr (after refill_shift/refill_offset transform) and
@@ -116,7 +230,7 @@ def build_case(case_name: str) -> dict:
 
     if case_name == 'bypass_async':
         # Cache disabled, target returns GRANTED + resp after 15 cycles. The
-        # cache's refill_resp must recognise the req as non-&refill_req and
+        # cache's refill_resp must recognise the req as not owned by an MSHR and
         # bounce it back on input_itf.resp().
         rules = [dict(addr_min=0, addr_max=0xFFFF_FFFF, behavior='granted',
                       resp_delay=15, retry_delay=0)]
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * Traffic generator driver. Starts one transfer with the generator's default
+ * pattern when reset is released, and once the generator signals the end of
+ * the transfer, prints the result and quits the simulation.
+ *
+ * Config keys: address, size, packet_size, do_write(bool), check(bool), logname.
+ */
+
+#include <vp/vp.hpp>
+#include <cstdio>
+#include <string>
+#include "interco/traffic/generator.hpp"
+
+class StubDriver : public vp::Component
+{
+public:
+    StubDriver(vp::ComponentConf &conf);
+    void reset(bool active) override;
+
+private:
+    static void end_handler(vp::Block *__this, vp::ClockEvent *event);
+
+    TrafficGeneratorConfigMaster control;
+    vp::ClockEvent end_event;
+    TrafficGeneratorSync sync;
+    vp::Trace trace;
+    std::string logname;
+    uint64_t address = 0;
+    size_t size = 0;
+    size_t packet_size = 0;
+    bool do_write = false;
+    bool check = false;
+};
+
+StubDriver::StubDriver(vp::ComponentConf &config)
+    : vp::Component(config),
+      end_event(this, &StubDriver::end_handler),
+      sync(&end_event)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->new_master_port("control", &this->control);
+
+    this->logname = this->get_js_config()->get_child_str("logname");
+    if (this->logname.empty()) this->logname = this->get_name();
+    this->address = (uint64_t)this->get_js_config()->get_child_int("address");
+    this->size = (size_t)this->get_js_config()->get_child_int("size");
+    this->packet_size = (size_t)this->get_js_config()->get_child_int("packet_size");
+    this->do_write = this->get_js_config()->get_child_bool("do_write");
+    this->check = this->get_js_config()->get_child_bool("check");
+}
+
+void StubDriver::reset(bool active)
+{
+    if (!active)
+    {
+        printf("[%ld] %s START addr=0x%lx size=%lu packet_size=%lu\n",
+            this->clock.get_cycles(), this->logname.c_str(), this->address,
+            (unsigned long)this->size, (unsigned long)this->packet_size);
+        fflush(stdout);
+
+        this->sync.init();
+        this->control.start(this->address, this->size, this->packet_size, &this->sync,
+            this->do_write, this->check);
+        this->sync.start();
+    }
+}
+
+void StubDriver::end_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    StubDriver *_this = (StubDriver *)__this;
+    bool check_status;
+    int64_t duration;
+    _this->control.get_result(&check_status, &duration);
+
+    printf("[%ld] %s END check_status=%d duration=%ld\n",
+        _this->clock.get_cycles(), _this->logname.c_str(), check_status ? 1 : 0,
+        (long)duration);
+    fflush(stdout);
+
+    _this->time.get_engine()->quit(0);
+}
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new StubDriver(config);
+}
@@ -0,0 +1,25 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+import gvsoc.systree
+
+
+class StubDriver(gvsoc.systree.Component):
+    """Starts one transfer on a traffic generator when reset is released, then
+    prints its result and quits."""
+    def __init__(self, parent, name, address, size, packet_size, do_write=False,
+                 check=False, logname=None):
+        super().__init__(parent, name)
+        self.add_sources(['stub_driver.cpp'])
+        self.add_property('logname', logname or name)
+        self.add_property('address', address)
+        self.add_property('size', size)
+        self.add_property('packet_size', packet_size)
+        self.add_property('do_write', do_write)
+        self.add_property('check', check)
+
+    def o_CONTROL(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('control', itf, signature='wire<TrafficGeneratorConfig>')
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * io_v2 stub target for the traffic generator. Prints every request it
+ * receives and answers it inline with IO_REQ_DONE, annotating the n-th request
+ * with the latency latencies[n % latencies.size()].
+ *
+ * Config keys: latencies (list of ints), logname.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io_v2.hpp>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class StubTarget : public vp::Component
+{
+public:
+    StubTarget(vp::ComponentConf &conf);
+    void reset(bool active) override;
+
+private:
+    static vp::IoReqStatus req_handler(vp::Block *__this, vp::IoReq *req);
+
+    vp::IoSlave in;
+    vp::Trace trace;
+    std::string logname;
+    std::vector<int64_t> latencies;
+    uint64_t nb_reqs = 0;
+};
+
+StubTarget::StubTarget(vp::ComponentConf &config)
+    : vp::Component(config),
+      in(&StubTarget::req_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->new_slave_port("input", &this->in);
+
+    this->logname = this->get_js_config()->get_child_str("logname");
+    if (this->logname.empty()) this->logname = this->get_name();
+
+    js::Config *latencies_cfg = this->get_js_config()->get("latencies");
+    if (latencies_cfg != NULL)
+    {
+        for (auto &item : latencies_cfg->get_elems())
+        {
+            this->latencies.push_back(item->get_int());
+        }
+    }
+    if (this->latencies.empty()) this->latencies.push_back(1);
+}
+
+void StubTarget::reset(bool active)
+{
+    if (active)
+    {
+        this->nb_reqs = 0;
+    }
+}
+
+vp::IoReqStatus StubTarget::req_handler(vp::Block *__this, vp::IoReq *req)
+{
+    StubTarget *_this = (StubTarget *)__this;
+
+    printf("[%ld] %s REQ addr=0x%lx size=%lu write=%d\n",
+        _this->clock.get_cycles(), _this->logname.c_str(), req->get_addr(),
+        (unsigned long)req->get_size(), req->get_is_write() ? 1 : 0);
+    fflush(stdout);
+
+    req->inc_latency(_this->latencies[_this->nb_reqs++ % _this->latencies.size()]);
+    req->set_resp_status(vp::IO_RESP_OK);
+    return vp::IO_REQ_DONE;
+}
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new StubTarget(config);
+}
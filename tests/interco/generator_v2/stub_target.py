@@ -0,0 +1,23 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+import gvsoc.systree
+
+
+class StubTarget(gvsoc.systree.Component):
+    """io_v2 target answering every request inline with IO_REQ_DONE.
+
+    The n-th request gets the latency ``latencies[n % len(latencies)]``, so
+    that the generator latency stats have a known distribution.
+    """
+    def __init__(self, parent, name, latencies, logname=None):
+        super().__init__(parent, name)
+        self.add_sources(['stub_target.cpp'])
+        self.add_property('logname', logname or name)
+        self.add_property('latencies', latencies)
+
+    def i_INPUT(self):
+        return gvsoc.systree.SlaveItf(self, 'input', signature='io_v2')
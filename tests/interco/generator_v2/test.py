@@ -0,0 +1,114 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+"""GeneratorV2 testbench: a driver starts one transfer on the generator, whose
+requests go to a stub target printing their addresses and answering them with
+a known latency distribution."""
+
+from __future__ import annotations
+
+import os
+import struct
+
+import gvsoc.systree
+import gvsoc.runner
+import vp.clock_domain
+from interco.traffic.generator_v2 import GeneratorV2
+from gvrun.parameter import TargetParameter
+
+from stub_driver import StubDriver
+from stub_target import StubTarget
+
+ADDRESS = 0x1000
+SIZE = 0x40
+PACKET_SIZE = 4
+
+# One latency per packet of the transfer (16 packets): avg 3.25, p50 1, p90 4,
+# p99 20.
+LATENCIES = [1] * 8 + [2] * 4 + [4] * 2 + [8] + [20]
+
+TRACE_ADDRESSES = [0x2000, 0x2010, 0x2004, 0x3000, 0x2008]
+
+
+def _write_trace(work_dir: str, name: str, addresses: list) -> str:
+    os.makedirs(work_dir, exist_ok=True)
+    path = os.path.join(work_dir, f'{name}.bin')
+    with open(path, 'wb') as f:
+        for address in addresses:
+            f.write(struct.pack('=Q', address))
+    return path
+
+
+def build_case(case_name: str, work_dir: str) -> dict:
+    if case_name == 'linear':
+        return {'generator': dict(pattern='linear')}
+
+    if case_name == 'strided':
+        # Stride larger than the packet, wrapping within the window
+        return {'generator': dict(pattern='strided', stride=0x10, window=0x40)}
+
+    if case_name == 'random':
+        return {'generator': dict(pattern='random', seed=42)}
+
+    if case_name == 'hotspot':
+        # Half of the packets go to a 16-byte hot spot outside the window
+        return {'generator': dict(pattern='hotspot', seed=42, hotspot_base=0x8000,
+                                  hotspot_size=0x10, hotspot_ratio=50)}
+
+    if case_name == 'trace':
+        # 5 addresses for 16 packets, so the replay wraps around
+        return {'generator': dict(pattern='trace',
+            trace_file=_write_trace(work_dir, 'trace', TRACE_ADDRESSES))}
+
+    if case_name == 'trace_missing':
+        return {'generator': dict(pattern='trace',
+            trace_file=os.path.join(work_dir, '__does_not_exist__.bin'))}
+
+    if case_name == 'trace_empty':
+        return {'generator': dict(pattern='trace',
+            trace_file=_write_trace(work_dir, 'empty', []))}
+
+    if case_name == 'check_nonlinear':
+        # Checking compares the data against a linear buffer, it must be refused
+        # for any other pattern.
+        return {'generator': dict(pattern='strided', stride=0x10), 'check': True}
+
+    raise ValueError(f'Unknown case: {case_name}')
+
+
+class Chip(gvsoc.systree.Component):
+    def __init__(self, parent, name=None):
+        super().__init__(parent, name)
+        case = TargetParameter(
+            self, name='case', value='linear',
+            description='Which generator_v2 test case to run', cast=str,
+        ).get_value()
+
+        work_dir = os.path.abspath(os.path.join(
+            os.path.dirname(__file__), 'build', 'traces'))
+        spec = build_case(case, work_dir)
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100_000_000)
+
+        driver = StubDriver(self, 'driver', address=ADDRESS, size=SIZE,
+                            packet_size=PACKET_SIZE, check=spec.get('check', False),
+                            logname='driver')
+        clock.o_CLOCK(driver.i_CLOCK())
+
+        gen = GeneratorV2(self, 'gen', **spec['generator'])
+        clock.o_CLOCK(gen.i_CLOCK())
+
+        target = StubTarget(self, 'target', latencies=LATENCIES, logname='mem')
+        clock.o_CLOCK(target.i_CLOCK())
+
+        driver.o_CONTROL(gen.i_CONTROL())
+        gen.o_OUTPUT(target.i_INPUT())
+
+
+class Target(gvsoc.runner.Target):
+    gapy_description = 'generator_v2 testbench'
+    model = Chip
+    name = 'test'
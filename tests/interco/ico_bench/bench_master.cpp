@@ -0,0 +1,284 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * Saturating io_v2 master for the interconnect host-time benchmark.
+ *
+ * Config (get_js_config()):
+ *   label       : name reported in the BENCH line (typically the DUT kind)
+ *   nb_reqs     : number of requests to complete before quitting
+ *   size        : request size in bytes
+ *   width       : beat width in bytes, used to count beats (and to split bursts)
+ *   base, span  : addresses are drawn in [base, base + span), aligned on size
+ *   outstanding : maximum number of requests (or beats) in flight
+ *   beats       : if true, each request is sent as a size/width-beat burst
+ *   write_ratio : percentage of writes
+ *   seed        : seed of the address/direction generator (fixed for repeatability)
+ *
+ * The master issues one request (or one beat) per cycle as long as a slot is
+ * free and the downstream did not deny it, so that the DUT is kept saturated.
+ * Per-cycle log lines are deliberately not printed: the only output is a
+ * single machine-readable line at the end of the run:
+ *   BENCH {"label":..., "requests":..., "host_ns":..., ...}
+ * "beats" and "ns_per_beat" are only reported in beat mode.
+ * Host time is measured from reset de-assertion to the last completion.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io_v2.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+class BenchMaster : public vp::Component
+{
+public:
+    BenchMaster(vp::ComponentConf &conf);
+    ~BenchMaster();
+    void reset(bool active) override;
+
+private:
+    static vp::IoRespAck resp_handler(vp::Block *__this, vp::IoReq *req);
+    static void retry_handler(vp::Block *__this, vp::IoRetryChannel);
+    static void issue_handler(vp::Block *__this, vp::ClockEvent *event);
+
+    void issue();
+    void complete(vp::IoReq *req);
+    void check_next();
+    uint64_t rand_next();
+    void next_burst();
+    void report();
+
+    vp::IoMaster out;
+    vp::ClockEvent issue_event;
+    vp::Trace trace;
+
+    std::string label;
+    int64_t nb_reqs;
+    uint64_t size;
+    uint64_t width;
+    uint64_t base;
+    uint64_t span;
+    bool beats;
+    int write_ratio;
+    uint64_t rand_state;
+
+    // Preallocated requests, never freed during the run so that the measure does
+    // not include the master's own allocations.
+    std::vector<vp::IoReq *> reqs;
+    std::vector<vp::IoReq *> free_reqs;
+
+    // Current burst. In non-beat mode a burst is a single request.
+    uint64_t burst_addr;
+    bool burst_is_write;
+    int64_t burst_id = 0;
+    uint64_t beat_idx = 0;
+    uint64_t nb_beats_per_burst;
+
+    int64_t total_beats;
+    int64_t beats_sent = 0;
+    int64_t beats_done = 0;
+    // Set when the downstream denied the head beat, cleared on retry().
+    bool blocked = false;
+
+    int64_t start_cycle = 0;
+    std::chrono::steady_clock::time_point start_time;
+};
+
+BenchMaster::BenchMaster(vp::ComponentConf &config)
+    : vp::Component(config),
+      out(&BenchMaster::retry_handler, &BenchMaster::resp_handler),
+      issue_event(this, &BenchMaster::issue_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+    this->new_master_port("output", &this->out);
+
+    js::Config *cfg = this->get_js_config();
+    this->label = cfg->get_child_str("label");
+    if (this->label.empty()) this->label = this->get_name();
+    this->nb_reqs = cfg->get_child_int("nb_reqs");
+    this->size = cfg->get_child_int("size");
+    this->width = cfg->get_child_int("width");
+    this->base = cfg->get_child_int("base");
+    this->span = cfg->get_child_int("span");
+    this->beats = cfg->get_child_bool("beats");
+    this->write_ratio = cfg->get_child_int("write_ratio");
+    this->rand_state = cfg->get_child_int("seed");
+    if (this->rand_state == 0) this->rand_state = 1;
+
+    int outstanding = cfg->get_child_int("outstanding");
+    if (outstanding <= 0) outstanding = 1;
+    if (this->width == 0 || this->width > this->size) this->width = this->size;
+    if (this->span < this->size) this->span = this->size;
+
+    this->nb_beats_per_burst = this->beats ? (this->size + this->width - 1) / this->width : 1;
+    this->total_beats = this->nb_reqs * (this->beats ? this->nb_beats_per_burst : 1);
+
+    uint64_t req_size = this->beats ? this->width : this->size;
+    for (int i = 0; i < outstanding; i++)
+    {
+        uint8_t *data = new uint8_t[req_size];
+        std::memset(data, 0, req_size);
+        vp::IoReq *req = new vp::IoReq(0, data, req_size, false);
+        this->reqs.push_back(req);
+        this->free_reqs.push_back(req);
+    }
+}
+
+BenchMaster::~BenchMaster()
+{
+    for (vp::IoReq *req : this->reqs)
+    {
+        delete[] req->get_data();
+        delete req;
+    }
+}
+
+void BenchMaster::reset(bool active)
+{
+    if (!active && this->nb_reqs > 0 && this->beats_sent == 0)
+    {
+        this->next_burst();
+        this->start_cycle = this->clock.get_cycles();
+        this->start_time = std::chrono::steady_clock::now();
+        this->issue_event.enqueue(1);
+    }
+}
+
+uint64_t BenchMaster::rand_next()
+{
+    // xorshift64*, enough for address scrambling and cheap enough not to show up in
+    // the measure.
+    this->rand_state ^= this->rand_state >> 12;
+    this->rand_state ^= this->rand_state << 25;
+    this->rand_state ^= this->rand_state >> 27;
+    return this->rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+void BenchMaster::next_burst()
+{
+    uint64_t nb_slots = this->span / this->size;
+    this->burst_addr = this->base + (this->rand_next() % nb_slots) * this->size;
+    this->burst_is_write = (int)(this->rand_next() % 100) < this->write_ratio;
+    this->beat_idx = 0;
+}
+
+void BenchMaster::issue()
+{
+    if (this->blocked || this->free_reqs.empty() || this->beats_sent == this->total_beats)
+    {
+        return;
+    }
+
+    vp::IoReq *req = this->free_reqs.back();
+
+    if (this->beats)
+    {
+        req->set_addr(this->burst_addr + this->beat_idx * this->width);
+        req->set_size(this->width);
+        req->is_first = this->beat_idx == 0;
+        req->is_last = this->beat_idx == this->nb_beats_per_burst - 1;
+        req->burst_id = this->burst_id;
+    }
+    else
+    {
+        req->set_addr(this->burst_addr);
+        req->set_size(this->size);
+    }
+    req->set_is_write(this->burst_is_write);
+    req->prepare();
+
+    vp::IoReqStatus status = this->out.req(req);
+    if (status == vp::IO_REQ_DENIED)
+    {
+        // Keep the beat position, the same beat is sent again on retry.
+        this->trace.msg(vp::Trace::LEVEL_TRACE, "Request denied (req: %p, addr: 0x%lx)\n", req, req->get_addr());
+        this->blocked = true;
+        return;
+    }
+
+    this->free_reqs.pop_back();
+    this->beats_sent++;
+    if (++this->beat_idx == this->nb_beats_per_burst)
+    {
+        this->burst_id++;
+        this->next_burst();
+    }
+
+    if (status == vp::IO_REQ_DONE)
+    {
+        this->complete(req);
+    }
+}
+
+void BenchMaster::complete(vp::IoReq *req)
+{
+    this->free_reqs.push_back(req);
+    if (++this->beats_done == this->total_beats)
+    {
+        this->report();
+        this->time.get_engine()->quit(0);
+    }
+}
+
+void BenchMaster::check_next()
+{
+    if (!this->issue_event.is_enqueued() && !this->blocked && !this->free_reqs.empty()
+        && this->beats_sent < this->total_beats)
+    {
+        this->issue_event.enqueue(1);
+    }
+}
+
+void BenchMaster::report()
+{
+    auto end_time = std::chrono::steady_clock::now();
+    int64_t host_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        end_time - this->start_time).count();
+    int64_t cycles = this->clock.get_cycles() - this->start_cycle;
+    printf("BENCH {\"label\": \"%s\", \"requests\": %ld, \"bytes\": %ld, \"cycles\": %ld, "
+        "\"host_ns\": %ld, \"ns_per_req\": %.2f",
+        this->label.c_str(), this->nb_reqs, this->nb_reqs * (int64_t)this->size,
+        cycles, host_ns, (double)host_ns / this->nb_reqs);
+    // Beats are only counted when requests are actually split into bursts
+    if (this->beats)
+    {
+        printf(", \"beats\": %ld, \"ns_per_beat\": %.2f",
+            this->total_beats, (double)host_ns / this->total_beats);
+    }
+    printf("}\n");
+    fflush(stdout);
+}
+
+void BenchMaster::issue_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    BenchMaster *_this = (BenchMaster *)__this;
+    _this->issue();
+    _this->check_next();
+}
+
+vp::IoRespAck BenchMaster::resp_handler(vp::Block *__this, vp::IoReq *req)
+{
+    BenchMaster *_this = (BenchMaster *)__this;
+    _this->complete(req);
+    _this->check_next();
+    return vp::IO_RESP_ACCEPTED;
+}
+
+void BenchMaster::retry_handler(vp::Block *__this, vp::IoRetryChannel)
+{
+    BenchMaster *_this = (BenchMaster *)__this;
+    _this->blocked = false;
+    _this->issue();
+    _this->check_next();
+}
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new BenchMaster(config);
+}
@@ -0,0 +1,39 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+import gvsoc.systree
+
+
+class BenchMaster(gvsoc.systree.Component):
+    """io_v2 saturating initiator used to measure host throughput.
+
+    Keeps up to ``outstanding`` requests in flight, issuing a new one as soon
+    as a slot frees up, until ``nb_reqs`` requests have completed. Addresses
+    are drawn from a fixed-seed generator inside ``[base, base + span)``.
+    When ``beats`` is set, each request is sent as a burst of ``size / width``
+    beats (for the beat router). At the end of the run one ``BENCH`` JSON line
+    is printed with the host time spent per request, and per beat in beat
+    mode.
+    """
+    def __init__(self, parent: gvsoc.systree.Component, name: str, label: str,
+                 nb_reqs: int, size: int, width: int, base: int, span: int,
+                 outstanding: int = 8, beats: bool = False, write_ratio: int = 0,
+                 seed: int = 1):
+        super().__init__(parent, name)
+        self.add_sources(['bench_master.cpp'])
+        self.add_property('label', label)
+        self.add_property('nb_reqs', nb_reqs)
+        self.add_property('size', size)
+        self.add_property('width', width)
+        self.add_property('base', base)
+        self.add_property('span', span)
+        self.add_property('outstanding', outstanding)
+        self.add_property('beats', beats)
+        self.add_property('write_ratio', write_ratio)
+        self.add_property('seed', seed)
+
+    def o_OUTPUT(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('output', itf, signature='io_v2')
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+
+/*
+ * Sink target for the interconnect host-time benchmark.
+ *
+ * Every request completes inline with IO_RESP_OK and `latency` cycles annotated
+ * on the request. Nothing is logged so that the target cost stays negligible
+ * compared to the interconnect under test.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/itf/io_v2.hpp>
+
+class BenchTarget : public vp::Component
+{
+public:
+    BenchTarget(vp::ComponentConf &conf);
+
+private:
+    static vp::IoReqStatus req_handler(vp::Block *__this, vp::IoReq *req);
+
+    vp::IoSlave in;
+    int64_t latency;
+};
+
+BenchTarget::BenchTarget(vp::ComponentConf &config)
+    : vp::Component(config),
+      in(&BenchTarget::req_handler)
+{
+    this->new_slave_port("input", &this->in, this);
+    this->latency = this->get_js_config()->get_child_int("latency");
+}
+
+vp::IoReqStatus BenchTarget::req_handler(vp::Block *__this, vp::IoReq *req)
+{
+    BenchTarget *_this = (BenchTarget *)__this;
+    req->inc_latency(_this->latency);
+    req->set_resp_status(vp::IO_RESP_OK);
+    return vp::IO_REQ_DONE;
+}
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new BenchTarget(config);
+}
@@ -0,0 +1,28 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+import gvsoc.systree
+from gvsoc.signature import IoV2Sync
+
+
+class BenchTarget(gvsoc.systree.Component):
+    """io_v2 sink used by the interconnect benchmark.
+
+    Answers every request inline with ``IO_REQ_DONE`` and ``latency`` cycles of
+    annotated latency, so that the measured host time is dominated by the
+    interconnect under test. ``sync=True`` advertises :class:`IoV2Sync` for
+    components whose output requires a synchronous slave (e.g. log_ico_v2).
+    """
+    def __init__(self, parent: gvsoc.systree.Component, name: str, latency: int = 0,
+                 sync: bool = False):
+        super().__init__(parent, name)
+        self.add_sources(['bench_target.cpp'])
+        self.add_property('latency', latency)
+        self.sync = sync
+
+    def i_INPUT(self) -> gvsoc.systree.SlaveItf:
+        return gvsoc.systree.SlaveItf(self, 'input',
+            signature=IoV2Sync() if self.sync else 'io_v2')
@@ -0,0 +1,126 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+"""Host-time micro-benchmark for the io_v2 interconnect components.
+
+Each case instantiates one interconnect flavour between a saturating
+:class:`BenchMaster` and :class:`BenchTarget` sinks that answer inline. The
+master keeps the DUT busy until ``nb_reqs`` requests completed and prints one
+``BENCH {...}`` JSON line with the host nanoseconds spent per request and per
+beat. Addresses and directions come from a fixed seed so two runs of the same
+case simulate exactly the same traffic, which makes the numbers comparable
+across gvsoc-core versions and across router kinds.
+
+All cases use the same traffic shape (64-byte requests, 8-byte beats, 25 %
+writes, 4 targets) so that ``ns_per_req`` can be compared directly to pick
+the cheapest kind meeting a given accuracy need.
+"""
+
+import gvsoc.systree
+import gvsoc.runner
+import vp.clock_domain
+from interco.router_v2 import Router, RouterConfig, RouterMapping
+from interco.log_ico_v2 import LogIco, LogIcoConfig
+from interco.splitter_v2 import Splitter, SplitterConfig
+from interco.limiter_v2 import Limiter, LimiterConfig
+from gvrun.parameter import TargetParameter
+
+from bench_master import BenchMaster
+from bench_target import BenchTarget
+
+NB_REQS = 200_000
+REQ_SIZE = 64
+BEAT_WIDTH = 8
+WRITE_RATIO = 25
+SEED = 0x1234
+NB_TARGETS = 4
+TARGET_BASE = 0x1000_0000
+TARGET_SIZE = 0x1_0000
+
+# case name -> (interconnect flavour, router config kwargs)
+CASES = {
+    'router_untimed':      ('router', dict(kind='untimed')),
+    'router_bandwidth':    ('router', dict(kind='bandwidth', latency=2, bandwidth=8)),
+    'router_backpressure': ('router', dict(kind='backpressure', latency=2, bandwidth=8)),
+    'router_beat':         ('router', dict(kind='beat', width=BEAT_WIDTH,
+                                           max_input_pending_size=8 * BEAT_WIDTH)),
+    'log_ico':             ('log_ico', None),
+    'splitter':            ('splitter', None),
+    'limiter':             ('limiter', None),
+}
+
+
+class Chip(gvsoc.systree.Component):
+    def __init__(self, parent, name=None):
+        super().__init__(parent, name)
+        case = TargetParameter(
+            self, name='case', value='router_untimed',
+            description='Which interconnect flavour to benchmark', cast=str,
+        ).get_value()
+        nb_reqs = TargetParameter(
+            self, name='nb_reqs', value=NB_REQS,
+            description='Number of requests to complete', cast=int,
+        ).get_value()
+
+        flavour, router_kwargs = CASES[case]
+        beats = router_kwargs is not None and router_kwargs['kind'] == 'beat'
+        nb_targets = 1 if flavour == 'limiter' else NB_TARGETS
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100_000_000)
+
+        master = BenchMaster(self, 'master', label=case, nb_reqs=nb_reqs,
+                             size=REQ_SIZE, width=BEAT_WIDTH,
+                             base=TARGET_BASE if flavour == 'router' else 0,
+                             span=NB_TARGETS * TARGET_SIZE,
+                             outstanding=8, beats=beats,
+                             write_ratio=WRITE_RATIO, seed=SEED)
+        clock.o_CLOCK(master.i_CLOCK())
+
+        targets = []
+        for i in range(nb_targets):
+            target = BenchTarget(self, f'target{i}', latency=1,
+                                 sync=flavour == 'log_ico')
+            clock.o_CLOCK(target.i_CLOCK())
+            targets.append(target)
+
+        if flavour == 'router':
+            dut = Router(self, 'dut', config=RouterConfig(**router_kwargs))
+            clock.o_CLOCK(dut.i_CLOCK())
+            master.o_OUTPUT(dut.i_INPUT(0))
+            for i, target in enumerate(targets):
+                dut.o_MAP(target.i_INPUT(), RouterMapping(
+                    name=f'target{i}', base=TARGET_BASE + i * TARGET_SIZE, size=TARGET_SIZE))
+
+        elif flavour == 'log_ico':
+            # Banks interleaved on the request size, so that each request stays
+            # within one bank and random addresses spread over all targets.
+            dut = LogIco(self, 'dut', config=LogIcoConfig(
+                nb_masters=1, nb_slaves=NB_TARGETS,
+                interleaving_width=REQ_SIZE.bit_length() - 1))
+            clock.o_CLOCK(dut.i_CLOCK())
+            master.o_OUTPUT(dut.i_INPUT(0))
+            for i, target in enumerate(targets):
+                dut.o_OUTPUT(i, target.i_INPUT())
+
+        elif flavour == 'splitter':
+            # One 64-byte window fanned out to the 4 targets as 16-byte chunks.
+            dut = Splitter(self, 'dut', config=SplitterConfig(
+                input_width=REQ_SIZE, output_width=REQ_SIZE // NB_TARGETS))
+            clock.o_CLOCK(dut.i_CLOCK())
+            master.o_OUTPUT(dut.i_INPUT())
+            for i, target in enumerate(targets):
+                dut.o_OUTPUT(i, target.i_INPUT())
+
+        elif flavour == 'limiter':
+            dut = Limiter(self, 'dut', config=LimiterConfig(bandwidth=BEAT_WIDTH))
+            clock.o_CLOCK(dut.i_CLOCK())
+            master.o_OUTPUT(dut.i_INPUT())
+            dut.o_OUTPUT(targets[0].i_INPUT())
+
+
+class Target(gvsoc.runner.Target):
+    gapy_description = 'io_v2 interconnect host-time benchmark'
+    model = Chip
+    name = 'test'
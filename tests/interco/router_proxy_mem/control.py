@@ -9,19 +9,98 @@
 Exercises proxy mem_read / mem_write through the backdoor debug-memory
 path while the simulation is PAUSED — proxy.run() is never called, so
 any access still relying on the timed path (clock events) would hang.
+Also covers the mem_shm_* bulk transfers through a POSIX shared buffer.
 """
 
 import sys
+from multiprocessing import shared_memory
 
-import gvsoc.gvsoc_control
+from interco.router_shm_client import ShmRouter
 
 MEM0_BASE = 0x1000_0000
 # Entry address of mem1, reached through the router2 cascade
 MEM1_BASE = 0x2000_1000
 
 
+def shm_ok(call, *args):
+    """Run a shared-buffer transfer, return False if the router errored."""
+    try:
+        call(*args)
+        return True
+    except RuntimeError:
+        return False
+
+
+def check_shm(router):
+    shm = shared_memory.SharedMemory(create=True, size=0x2000)
+    name = '/' + shm.name
+    try:
+        # Mappings must fit in the shm object, which would SIGBUS otherwise
+        if shm_ok(router.mem_shm_map, name, 0) or \
+                shm_ok(router.mem_shm_map, name, 0x10000):
+            print("[control] FAIL: empty or oversized mem_shm_map did not error",
+                  file=sys.stderr)
+            return 16
+
+        if not shm_ok(router.mem_shm_map, name, 0x1000):
+            print("[control] FAIL: mem_shm_map", file=sys.stderr)
+            return 5
+
+        # Buffer to memory, read back through the pipes
+        data = bytes((i * 13 + 5) & 0xFF for i in range(256))
+        shm.buf[0x40:0x140] = data
+        if not shm_ok(router.mem_shm_write, MEM0_BASE + 0x200, len(data), name, 0x40):
+            print("[control] FAIL: mem_shm_write", file=sys.stderr)
+            return 6
+        if router.mem_read(MEM0_BASE + 0x200, len(data)) != data:
+            print("[control] FAIL: mem_shm_write readback mismatch", file=sys.stderr)
+            return 7
+
+        # Memory to buffer, through the router cascade
+        router.mem_write_int(MEM1_BASE + 0x20, 4, 0xCAFEF00D)
+        if not shm_ok(router.mem_shm_read, MEM1_BASE + 0x20, 4, name, 0x800):
+            print("[control] FAIL: mem_shm_read", file=sys.stderr)
+            return 8
+        if int.from_bytes(shm.buf[0x800:0x804], 'little') != 0xCAFEF00D:
+            print("[control] FAIL: mem_shm_read readback mismatch", file=sys.stderr)
+            return 9
+
+        # Window outside of the mapping
+        if shm_ok(router.mem_shm_read, MEM0_BASE, 16, name, 0xFF8):
+            print("[control] FAIL: out-of-window read did not error", file=sys.stderr)
+            return 10
+
+        # Mappings are reference-counted: a second map grows the mapping,
+        # and the buffer stays usable until the last unmap.
+        if not shm_ok(router.mem_shm_map, name, 0x2000):
+            print("[control] FAIL: second mem_shm_map", file=sys.stderr)
+            return 11
+        if not shm_ok(router.mem_shm_unmap, name):
+            print("[control] FAIL: first mem_shm_unmap", file=sys.stderr)
+            return 12
+        shm.buf[0x1800:0x1804] = (0x12345678).to_bytes(4, 'little')
+        if not shm_ok(router.mem_shm_write, MEM0_BASE + 0x300, 4, name, 0x1800) \
+                or router.mem_read_int(MEM0_BASE + 0x300, 4) != 0x12345678:
+            print("[control] FAIL: access after first unmap", file=sys.stderr)
+            return 13
+        if not shm_ok(router.mem_shm_unmap, name):
+            print("[control] FAIL: last mem_shm_unmap", file=sys.stderr)
+            return 14
+
+        # Fully released now
+        if shm_ok(router.mem_shm_unmap, name) or \
+                shm_ok(router.mem_shm_read, MEM0_BASE, 4, name, 0):
+            print("[control] FAIL: access after last unmap did not error", file=sys.stderr)
+            return 15
+    finally:
+        shm.close()
+        shm.unlink()
+
+    return 0
+
+
 def target_control(proxy):
-    router = gvsoc.gvsoc_control.Router(proxy, path='**/router')
+    router = ShmRouter(proxy, path='**/router')
 
     # Level-1: write/read roundtrip into mem0
     data = bytes((i * 7 + 3) & 0xFF for i in range(64))
@@ -54,5 +133,9 @@ def target_control(proxy):
     except Exception:
         pass
 
+    status = check_shm(router)
+    if status != 0:
+        return status
+
     print("[control] OK")
     return 0
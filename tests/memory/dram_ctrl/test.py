@@ -0,0 +1,151 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+"""dram_ctrl testbench.
+
+Hooks a stub io_v2 master to the DRAM controller input. Each test case is
+selected via the ``case`` TargetParameter, which picks a build_case dict
+with:
+
+  - config:   DramCtrlConfig of the controller
+  - schedule: list of io_v2 requests to send
+
+All cases use small timings (tRCD=3, tRP=3, tCAS=2, tRAS=6, one cycle per
+8-byte burst) and 256-byte rows on 2 banks, so that expected response
+cycles are easy to derive by hand.
+"""
+
+from __future__ import annotations
+
+import gvsoc.systree
+import gvsoc.runner
+import vp.clock_domain
+from memory.dram_ctrl import DramCtrl, DramCtrlConfig
+from gvrun.parameter import TargetParameter
+
+from stub_master import StubMaster
+
+
+def _config(**kwargs) -> DramCtrlConfig:
+    params = dict(size=0x10000, nb_channels=1, nb_ranks=1, nb_banks=2, row_size=256,
+                  burst_size=8, t_burst=1, t_rcd=3, t_rp=3, t_cas=2, t_ras=6, t_refi=0)
+    params.update(kwargs)
+    return DramCtrlConfig(**params)
+
+
+def build_case(case_name: str) -> dict:
+    if case_name == 'write_then_read':
+        return {
+            'config': _config(),
+            'schedule': [
+                dict(cycle=10, addr=0x120, size=4, is_write=True,  name='w',
+                     data_hex='deadbeef'),
+                dict(cycle=40, addr=0x120, size=4, is_write=False, name='r'),
+            ],
+        }
+
+    if case_name == 'row_buffer':
+        # 'a' opens row 0 of bank 0 (miss), 'b' hits it, 'c' goes to row 1
+        # of bank 0 (conflict: precharge + activate).
+        return {
+            'config': _config(),
+            'schedule': [
+                dict(cycle=10, addr=0x0,   size=8, is_write=False, name='a'),
+                dict(cycle=20, addr=0x8,   size=8, is_write=False, name='b'),
+                dict(cycle=30, addr=0x200, size=8, is_write=False, name='c'),
+            ],
+        }
+
+    if case_name == 'closed_page':
+        # Same first two accesses as row_buffer with the closed-page
+        # policy: 'b' has to activate the row again.
+        return {
+            'config': _config(open_page=False),
+            'schedule': [
+                dict(cycle=10, addr=0x0, size=8, is_write=False, name='a'),
+                dict(cycle=20, addr=0x8, size=8, is_write=False, name='b'),
+            ],
+        }
+
+    if case_name == 'fr_fcfs':
+        # While 'a' opens row 0, 'x' (row 1, conflict) and then 'y' (row 0,
+        # hit) are queued: 'y' is scheduled first.
+        return {
+            'config': _config(),
+            'schedule': [
+                dict(cycle=10, addr=0x0,   size=8, is_write=False, name='a'),
+                dict(cycle=11, addr=0x200, size=8, is_write=False, name='x'),
+                dict(cycle=12, addr=0x10,  size=8, is_write=False, name='y'),
+            ],
+        }
+
+    if case_name == 'refresh':
+        # A refresh falls between 'a' and 'b': the row opened by 'a' is
+        # closed and 'b' waits for the end of the refresh.
+        return {
+            'config': _config(t_refi=100, t_rfc=20),
+            'schedule': [
+                dict(cycle=10,  addr=0x0, size=8, is_write=False, name='a'),
+                dict(cycle=105, addr=0x8, size=8, is_write=False, name='b'),
+            ],
+        }
+
+    if case_name == 'queue_full':
+        # Queue of 1 entry: requests sent back to back while the first one
+        # is in the queue get denied and are retried.
+        return {
+            'config': _config(queue_size=1),
+            'schedule': [
+                dict(cycle=10, addr=0x0,   size=8, is_write=False, name='a'),
+                dict(cycle=11, addr=0x200, size=8, is_write=False, name='b'),
+                dict(cycle=12, addr=0x400, size=8, is_write=False, name='c'),
+            ],
+        }
+
+    if case_name == 'channel_retry':
+        # Two channels with 1-entry queues. Channel 0 is kept busy by a row
+        # conflict so that 'd' is denied on it, while 'y' goes through
+        # channel 1 and frees its queue entry first: only channel 0 must
+        # retry 'd', once 'c' leaves its queue.
+        return {
+            'config': _config(nb_channels=2, queue_size=1),
+            'schedule': [
+                dict(cycle=10, addr=0x0,   size=8, is_write=False, name='a'),
+                dict(cycle=12, addr=0x400, size=8, is_write=False, name='x'),
+                dict(cycle=13, addr=0x800, size=8, is_write=False, name='c'),
+                dict(cycle=15, addr=0xC00, size=8, is_write=False, name='d'),
+                dict(cycle=16, addr=0x100, size=8, is_write=False, name='y'),
+            ],
+        }
+
+    raise ValueError(f'Unknown case: {case_name}')
+
+
+class Chip(gvsoc.systree.Component):
+    def __init__(self, parent, name=None):
+        super().__init__(parent, name)
+        case = TargetParameter(
+            self, name='case', value='row_buffer',
+            description='Which dram_ctrl test case to run', cast=str,
+        ).get_value()
+
+        spec = build_case(case)
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100_000_000)
+
+        ddr = DramCtrl(self, 'ddr', config=spec['config'])
+        clock.o_CLOCK(ddr.i_CLOCK())
+
+        master = StubMaster(self, 'master', schedule=spec['schedule'],
+                             logname='master')
+        clock.o_CLOCK(master.i_CLOCK())
+        master.o_OUTPUT(ddr.i_INPUT())
+
+
+class Target(gvsoc.runner.Target):
+    gapy_description = 'dram_ctrl testbench'
+    model = Chip
+    name = 'test'
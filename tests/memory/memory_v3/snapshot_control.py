@@ -0,0 +1,85 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+"""Control script for the memory_v3 ``snapshot`` case.
+
+Drives the ``mem_snapshot`` / ``mem_restore`` proxy commands of the memory
+and checks its content through backdoor accesses of the router in front of
+it, with the simulation paused the whole time.
+"""
+
+import sys
+
+import gvsoc.gvsoc_control
+
+PAGE = 0x1000
+POISON = 0x57
+
+
+def pattern(seed, size):
+    return bytes((i * 11 + seed) & 0xFF for i in range(size))
+
+
+def mem_cmd(proxy, mem, cmd):
+    """Send a memory command, return True on err=0."""
+    reply = proxy._send_cmd('component %s %s' % (mem, cmd))
+    return 'err=0' in str(reply)
+
+
+def fail(msg, status):
+    print(f"[control] FAIL: {msg}", file=sys.stderr)
+    return status
+
+
+def target_control(proxy):
+    router = gvsoc.gvsoc_control.Router(proxy, path='**/router')
+    mem = proxy._get_component('**/mem')
+
+    # No restore point yet
+    if mem_cmd(proxy, mem, 'mem_restore'):
+        return fail("mem_restore before any snapshot did not error", 1)
+
+    # First cycle: the write after the snapshot straddles pages 0 and 1
+    first = pattern(1, 0x20)
+    router.mem_write(PAGE - 0x10, len(first), first)
+    if not mem_cmd(proxy, mem, 'mem_snapshot'):
+        return fail("first mem_snapshot", 2)
+
+    router.mem_write(PAGE - 0x8, 0x10, pattern(2, 0x10))
+    expected = first[:0x8] + pattern(2, 0x10) + first[0x18:]
+    if router.mem_read(PAGE - 0x10, 0x20) != expected:
+        return fail("write after snapshot not visible", 3)
+
+    if not mem_cmd(proxy, mem, 'mem_restore'):
+        return fail("first mem_restore", 4)
+    if router.mem_read(PAGE - 0x10, 0x20) != first:
+        return fail("first restore did not bring back both pages", 5)
+
+    # Restoring again with nothing written is a no-op
+    if not mem_cmd(proxy, mem, 'mem_restore') or \
+            router.mem_read(PAGE - 0x10, 0x20) != first:
+        return fail("second restore of the same snapshot", 6)
+
+    # Second cycle: a new restore point, then writes across pages 1 and 2
+    # and into the pages of the first cycle again
+    second = pattern(3, 0x10)
+    router.mem_write(2 * PAGE, len(second), second)
+    if not mem_cmd(proxy, mem, 'mem_snapshot'):
+        return fail("second mem_snapshot", 7)
+
+    router.mem_write(2 * PAGE - 0x8, 0x10, pattern(4, 0x10))
+    router.mem_write(PAGE - 0x10, 0x20, pattern(5, 0x20))
+    if not mem_cmd(proxy, mem, 'mem_restore'):
+        return fail("second mem_restore", 8)
+
+    if router.mem_read(PAGE - 0x10, 0x20) != first:
+        return fail("second restore lost the first cycle content", 9)
+    expected = bytes([POISON] * 0x8) + second
+    if router.mem_read(2 * PAGE - 0x8, 0x18) != expected:
+        return fail("second restore did not bring back pages 1 and 2", 10)
+
+    print("[control] OK")
+    return 0
@@ -9,6 +9,11 @@
  *
  * Reads a schedule from get_js_config()/schedule: a list of entries with
  *   { cycle, addr, size, is_write, name }
+ * and optionally an atomic `opcode` ("lr", "sc", "swap", "add") with the
+ * `initiator` id it is sent on behalf of, so that one master can play several
+ * cores for the LR/SC reservations. An entry with `memcheck` set to "alloc"
+ * or "free" instead declares or releases the buffer [addr, addr + size) of
+ * memory `memcheck_id` through the memcheck allocator.
  * The master sends each request at its issue cycle. If the send returns DENIED, the
  * master remembers the request and re-sends it as soon as retry() fires. Each event
  * (SEND, DENY, RETRY, GRANT, RESP, DONE) is printed with the current cycle and the
@@ -17,6 +22,7 @@
 
 #include <vp/vp.hpp>
 #include <vp/itf/io_v2.hpp>
+#include <vp/memcheck.hpp>
 #include <cstdio>
 #include <deque>
 #include <string>
@@ -36,6 +42,11 @@ private:
         std::string name;
         vp::IoReq *req;     // owned
         uint8_t *data;      // owned
+        uint8_t *data2;     // owned, atomic result
+        vp::IoReqOpcode opcode;
+        intptr_t initiator;
+        std::string memcheck;
+        int memcheck_id;
         bool sent = false;  // true once SEND has been attempted (and accepted) at least
     };
 
@@ -105,6 +116,16 @@ StubMaster::StubMaster(vp::ComponentConf &config)
                 };
                 e->data[i] = (hexv(data_hex[i*2]) << 4) | hexv(data_hex[i*2+1]);
             }
+            e->data2 = new uint8_t[e->size]();
+            std::string opcode = item->get_child_str("opcode");
+            e->opcode = opcode == "lr"   ? vp::IoReqOpcode::LR :
+                        opcode == "sc"   ? vp::IoReqOpcode::SC :
+                        opcode == "swap" ? vp::IoReqOpcode::SWAP :
+                        opcode == "add"  ? vp::IoReqOpcode::ADD :
+                        e->is_write      ? vp::IoReqOpcode::WRITE : vp::IoReqOpcode::READ;
+            e->initiator = item->get_child_int("initiator");
+            e->memcheck = item->get_child_str("memcheck");
+            e->memcheck_id = item->get_child_int("memcheck_id");
             e->req = new vp::IoReq(e->addr, e->data, e->size, e->is_write);
             this->schedule.push_back(e);
         }
@@ -165,6 +186,24 @@ void StubMaster::quit_handler(vp::Block *__this, vp::ClockEvent *event)
 void StubMaster::issue(ScheduleEntry *entry)
 {
     int64_t now = this->clock.get_cycles();
+
+    if (!entry->memcheck.empty())
+    {
+#ifdef VP_MEMCHECK_ACTIVE
+        bool is_alloc = entry->memcheck == "alloc";
+        uint64_t result = is_alloc ?
+            this->get_memcheck()->alloc(entry->memcheck_id, entry->addr, entry->size) :
+            this->get_memcheck()->free(entry->memcheck_id, entry->addr, entry->size);
+        printf("[%ld] %s %s name=%s addr=0x%lx size=%lu result=0x%lx\n",
+            now, this->logname.c_str(), is_alloc ? "ALLOC" : "FREE",
+            entry->name.c_str(), entry->addr, entry->size, result);
+#else
+        printf("[%ld] %s MEMCHECK_UNSUPPORTED name=%s\n",
+            now, this->logname.c_str(), entry->name.c_str());
+#endif
+        return;
+    }
+
     printf("[%ld] %s SEND name=%s addr=0x%lx size=%lu write=%d\n",
         now, this->logname.c_str(), entry->name.c_str(),
         entry->addr, entry->size, entry->is_write ? 1 : 0);
@@ -175,6 +214,13 @@ void StubMaster::issue(ScheduleEntry *entry)
     entry->req->set_size(entry->size);
     entry->req->set_is_write(entry->is_write);
     entry->req->prepare();
+    if (entry->opcode != vp::IoReqOpcode::READ && entry->opcode != vp::IoReqOpcode::WRITE)
+    {
+        entry->req->set_opcode(entry->opcode);
+        entry->req->set_second_data(entry->data2);
+        // Ids start at 1, the null initiator is the default one
+        entry->req->initiator = (void *)(entry->initiator + 1);
+    }
 
     vp::IoReqStatus st = this->out.req(entry->req);
     switch (st)
@@ -182,12 +228,16 @@ void StubMaster::issue(ScheduleEntry *entry)
         case vp::IO_REQ_DONE:
         {
             char hex[17] = { 0 };
+            char result[17] = { 0 };
             int n = entry->size < 8 ? (int)entry->size : 8;
             for (int i = 0; i < n; i++)
+            {
                 snprintf(&hex[i*2], 3, "%02x", entry->data[i]);
-            printf("[%ld] %s DONE name=%s status=%d latency=%ld data=%s\n",
+                snprintf(&result[i*2], 3, "%02x", entry->data2[i]);
+            }
+            printf("[%ld] %s DONE name=%s status=%d latency=%ld data=%s result=%s\n",
                 now, this->logname.c_str(), entry->name.c_str(),
-                (int)entry->req->get_resp_status(), entry->req->get_latency(), hex);
+                (int)entry->req->get_resp_status(), entry->req->get_latency(), hex, result);
             break;
         }
         case vp::IO_REQ_GRANTED:
@@ -11,7 +11,8 @@ class StubMaster(gvsoc.systree.Component):
     """io_v2 testbench initiator.
 
     Issues a pre-programmed schedule of requests. Each schedule entry is a dict with
-    keys: cycle, addr, size, is_write, name.
+    keys: cycle, addr, size, is_write, name, and optionally an atomic opcode
+    ('lr', 'sc', 'swap', 'add') with the initiator id it is sent for.
     """
     def __init__(self, parent: gvsoc.systree.Component, name: str,
                  schedule: list | None = None, logname: str | None = None):
@@ -12,6 +12,9 @@ via the ``case`` TargetParameter, which picks a build_case dict with:
   - memory_kwargs: kwargs for Memory(...)
   - schedule:      list of io_v2 requests to send (optionally carrying
                    a ``data_hex`` pre-fill for writes/atomics)
+  - router:        optional, put an untimed router_v2 in front of the
+                   memory for the proxy backdoor accesses of control
+                   scripts
 """
 
 from __future__ import annotations
@@ -22,6 +25,7 @@ import struct
 import gvsoc.systree
 import gvsoc.runner
 import vp.clock_domain
+from interco.router_v2 import Router, RouterConfig, RouterMapping
 from memory.memory_v3 import Memory, MemoryV3Config
 from gvrun.parameter import TargetParameter
 
@@ -47,6 +51,18 @@ def build_case(case_name: str, work_dir: str) -> dict:
             ],
         }
 
+    if case_name == 'host_profile':
+        # read_basic behind a router, run with GV_HOST_PROFILE set (see the
+        # Makefile): the memory and the router are profiled from two model
+        # libraries, which must merge their counters into one report.
+        return {
+            'config': MemoryV3Config(size=0x1000, latency=1),
+            'schedule': [
+                dict(cycle=10, addr=0x0, size=4, is_write=False, name='r'),
+            ],
+            'router': True,
+        }
+
     if case_name == 'write_then_read':
         # Write a known 4-byte pattern, then read it back and verify the
         # same bytes come out.
@@ -103,6 +119,131 @@ def build_case(case_name: str, work_dir: str) -> dict:
             ],
         }
 
+    if case_name == 'stim_mmap':
+        # Same image as stim_file, mapped copy-on-write. The preload must be
+        # visible, a write must read back, and a read past the end of the
+        # file must return zero.
+        stim_path = _write_stim(work_dir, 'stim_mmap',
+                                  b'\xef\xbe\xad\xde' + b'\x00' * 28)
+        return {
+            'config': MemoryV3Config(size=0x10000, latency=1, stim_file=stim_path,
+                                     stim_mmap=True),
+            'schedule': [
+                dict(cycle=10, addr=0x0, size=4, is_write=False, name='r_stim'),
+                dict(cycle=20, addr=0x10, size=4, is_write=True,  name='w',
+                     data_hex='deadbeef'),
+                dict(cycle=30, addr=0x10, size=4, is_write=False, name='r'),
+                dict(cycle=40, addr=0x8000, size=4, is_write=False, name='r_zero'),
+            ],
+        }
+
+    if case_name == 'bank_conflict':
+        # 4 word-interleaved banks serving 4 bytes per cycle. 'a' occupies
+        # banks 0 and 1 for 2 cycles, 'b' hits bank 1 one cycle later and
+        # waits 1 cycle, 'c' hits the free bank 2.
+        return {
+            'config': MemoryV3Config(size=0x1000, latency=1, width=4, nb_banks=4,
+                                     bank_interleaving_bits=2),
+            'schedule': [
+                dict(cycle=10, addr=0x0, size=8, is_write=False, name='a'),
+                dict(cycle=11, addr=0x4, size=4, is_write=False, name='b'),
+                dict(cycle=12, addr=0x8, size=4, is_write=False, name='c'),
+            ],
+        }
+
+    if case_name == 'sparse':
+        # 1 GiB sparse memory: only the touched pages get committed. A write
+        # near the top must read back, an untouched page must read as zero
+        # (no 0x57 poison in sparse mode).
+        return {
+            'config': MemoryV3Config(size=0x4000_0000, latency=1, sparse=True),
+            'schedule': [
+                dict(cycle=10, addr=0x3fff_fff0, size=4, is_write=True,  name='w',
+                     data_hex='deadbeef'),
+                dict(cycle=20, addr=0x3fff_fff0, size=4, is_write=False, name='r'),
+                dict(cycle=30, addr=0x1000_0000, size=4, is_write=False, name='r_zero'),
+            ],
+        }
+
+    if case_name == 'lr_sc':
+        # LR/SC reservations of initiator 0 on 0x40. A successful pair, then
+        # pairs broken by a plain store and by an AMO of initiator 1.
+        lock = dict(addr=0x40, size=4, is_write=False)
+        return {
+            'config': MemoryV3Config(size=0x1000, latency=1, atomics=True),
+            'schedule': [
+                dict(cycle=10, **lock, name='lr_ok', opcode='lr'),
+                dict(cycle=11, **lock, name='sc_ok', opcode='sc',
+                     data_hex='11111111'),
+                dict(cycle=20, **lock, name='lr_st', opcode='lr'),
+                dict(cycle=21, addr=0x40, size=4, is_write=True, name='st',
+                     data_hex='22222222', initiator=1),
+                dict(cycle=22, **lock, name='sc_st', opcode='sc',
+                     data_hex='33333333'),
+                dict(cycle=23, **lock, name='r_st'),
+                dict(cycle=30, **lock, name='lr_amo', opcode='lr'),
+                dict(cycle=31, **lock, name='amo', opcode='add',
+                     data_hex='01000000', initiator=1),
+                dict(cycle=32, **lock, name='sc_amo', opcode='sc',
+                     data_hex='44444444'),
+                dict(cycle=33, **lock, name='r_amo'),
+            ],
+        }
+
+    if case_name == 'lr_sc_many':
+        # 1024 initiators reserve the same word, more than the reservation
+        # filter could count on 8 bits; a store of another initiator must
+        # still break all of them.
+        nb_cores = 1024
+        lock = dict(addr=0x40, size=4, is_write=False)
+        schedule = [dict(cycle=10 + i, **lock, name=f'lr{i}', opcode='lr',
+                         initiator=i) for i in range(nb_cores)]
+        schedule += [
+            dict(cycle=10 + nb_cores, addr=0x40, size=4, is_write=True,
+                 name='st', data_hex='22222222', initiator=nb_cores),
+            dict(cycle=11 + nb_cores, **lock, name='sc_first', opcode='sc',
+                 data_hex='33333333', initiator=0),
+            dict(cycle=12 + nb_cores, **lock, name='sc_last', opcode='sc',
+                 data_hex='33333333', initiator=nb_cores - 1),
+            dict(cycle=13 + nb_cores, **lock, name='r'),
+        ]
+        return {
+            'config': MemoryV3Config(size=0x1000, latency=1, atomics=True),
+            'schedule': schedule,
+        }
+
+    if case_name == 'memcheck':
+        # Buffer of 0x20 bytes at 0x10 declared through the allocator. With
+        # the default expansion factor of 5, it lands at virtual offset
+        # 0x10 * 5 + 0x20 * 2 = 0x90, which is where the accesses go.
+        buf = 0x90
+        return {
+            'config': MemoryV3Config(size=0x1000, latency=1, memcheck_id=0),
+            'schedule': [
+                dict(cycle=10, addr=0x10, size=0x20, is_write=False, name='alloc',
+                     memcheck='alloc'),
+                dict(cycle=20, addr=buf, size=4, is_write=True,  name='w_in',
+                     data_hex='deadbeef'),
+                dict(cycle=21, addr=buf + 0x1c, size=4, is_write=False, name='r_in'),
+                dict(cycle=22, addr=buf + 0x1e, size=4, is_write=False, name='r_after'),
+                dict(cycle=23, addr=buf - 4, size=4, is_write=True,  name='w_before',
+                     data_hex='deadbeef'),
+                dict(cycle=30, addr=buf, size=0x20, is_write=False, name='free',
+                     memcheck='free'),
+                dict(cycle=40, addr=buf, size=4, is_write=False, name='r_freed'),
+            ],
+        }
+
+    if case_name == 'snapshot':
+        # Driven by snapshot_control.py through the proxy, with the
+        # simulation paused: the memory sits behind a router to get backdoor
+        # mem_read / mem_write, and the master stays idle.
+        return {
+            'config': MemoryV3Config(size=0x4000, latency=1),
+            'schedule': [],
+            'router': True,
+        }
+
     raise ValueError(f'Unknown case: {case_name}')
 
 
@@ -126,7 +267,15 @@ class Chip(gvsoc.systree.Component):
         master = StubMaster(self, 'master', schedule=spec['schedule'],
                              logname='master')
         clock.o_CLOCK(master.i_CLOCK())
-        master.o_OUTPUT(mem.i_INPUT())
+
+        if spec.get('router'):
+            router = Router(self, 'router', config=RouterConfig(kind='untimed'))
+            clock.o_CLOCK(router.i_CLOCK())
+            master.o_OUTPUT(router.i_INPUT(0))
+            router.o_MAP(mem.i_INPUT(), RouterMapping(
+                name='mem', base=0, size=spec['config'].size))
+        else:
+            master.o_OUTPUT(mem.i_INPUT())
 
 
 class Target(gvsoc.runner.Target):
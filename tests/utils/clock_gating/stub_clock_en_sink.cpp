@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+//
+// Testbench subscriber of a clock model ``clock_en_out`` wire. Every
+// notification is logged with the current cycle and the new state.
+
+#include <vp/vp.hpp>
+#include <cstdio>
+#include <string>
+
+class StubClockEnSink : public vp::Component
+{
+public:
+    StubClockEnSink(vp::ComponentConf &conf);
+
+private:
+    static void clock_en_sync(vp::Block *__this, bool enabled);
+
+    vp::Trace           trace;
+    vp::WireSlave<bool> clock_en_in;
+    std::string         logname;
+};
+
+
+StubClockEnSink::StubClockEnSink(vp::ComponentConf &config)
+    : vp::Component(config)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    this->logname = this->get_js_config()->get_child_str("logname");
+    if (this->logname.empty()) this->logname = this->get_name();
+
+    this->clock_en_in.set_sync_meth(&StubClockEnSink::clock_en_sync);
+    this->new_slave_port("clock_en", &this->clock_en_in);
+}
+
+
+void StubClockEnSink::clock_en_sync(vp::Block *__this, bool enabled)
+{
+    StubClockEnSink *_this = (StubClockEnSink *)__this;
+    printf("[%ld] %s CLOCK_EN value=%d\n", _this->clock.get_cycles(), _this->logname.c_str(),
+        enabled ? 1 : 0);
+    fflush(stdout);
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new StubClockEnSink(config);
+}
@@ -0,0 +1,19 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+import gvsoc.systree
+
+
+class StubClockEnSink(gvsoc.systree.Component):
+    """Testbench subscriber of a clock model clock_en_out wire."""
+    def __init__(self, parent: gvsoc.systree.Component, name: str,
+                 logname: str | None = None):
+        super().__init__(parent, name)
+        self.add_sources(['stub_clock_en_sink.cpp'])
+        self.add_property('logname', logname or name)
+
+    def i_CLOCK_EN(self) -> gvsoc.systree.SlaveItf:
+        return gvsoc.systree.SlaveItf(self, 'clock_en', signature='wire<bool>')
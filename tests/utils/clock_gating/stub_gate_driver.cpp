@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+//
+// Testbench driver of the clock models control wires. It replays a schedule
+// of { cycle, port, value } entries on its wire<bool> gating ports
+// (``div_en``, ``mux_en_0``, ``mux_en_1``, ``core_en``), its wire<int>
+// control ports (``div_ctrl``, ``mux_sel``) and the wire<bool> reset of a
+// core (``core_reset``), logging each one with the current cycle. The
+// simulation is stopped ``quit_after_cycles`` cycles (default 10) after the
+// last entry.
+
+#include <vp/vp.hpp>
+#include <vp/clock/clock_event.hpp>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class StubGateDriver : public vp::Component
+{
+public:
+    StubGateDriver(vp::ComponentConf &conf);
+    void reset(bool active) override;
+
+private:
+    struct ScheduleEntry
+    {
+        int64_t cycle;
+        std::string port;
+        int value;
+    };
+
+    static void issue_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void quit_handler(vp::Block *__this, vp::ClockEvent *event);
+    void issue(ScheduleEntry &entry);
+
+    vp::Trace              trace;
+    vp::WireMaster<bool>   div_en_itf;
+    vp::WireMaster<bool>   mux_en_itf[2];
+    vp::WireMaster<int>    div_ctrl_itf;
+    vp::WireMaster<int>    mux_sel_itf;
+    vp::WireMaster<bool>   core_en_itf;
+    vp::WireMaster<bool>   core_reset_itf;
+    vp::ClockEvent         issue_event;
+    vp::ClockEvent         quit_event;
+    std::string            logname;
+    std::vector<ScheduleEntry> schedule;
+    size_t                 next_to_schedule = 0;
+    int64_t                quit_after_cycles = 10;
+};
+
+
+StubGateDriver::StubGateDriver(vp::ComponentConf &config)
+    : vp::Component(config),
+      issue_event(this, &StubGateDriver::issue_handler),
+      quit_event(this, &StubGateDriver::quit_handler)
+{
+    this->traces.new_trace("trace", &this->trace, vp::DEBUG);
+
+    this->logname = this->get_js_config()->get_child_str("logname");
+    if (this->logname.empty()) this->logname = this->get_name();
+
+    int qac = this->get_js_config()->get_child_int("quit_after_cycles");
+    if (qac > 0) this->quit_after_cycles = qac;
+
+    this->new_master_port("div_en", &this->div_en_itf);
+    this->new_master_port("mux_en_0", &this->mux_en_itf[0]);
+    this->new_master_port("mux_en_1", &this->mux_en_itf[1]);
+    this->new_master_port("div_ctrl", &this->div_ctrl_itf);
+    this->new_master_port("mux_sel", &this->mux_sel_itf);
+    this->new_master_port("core_en", &this->core_en_itf);
+    this->new_master_port("core_reset", &this->core_reset_itf);
+
+    js::Config *schedule_cfg = this->get_js_config()->get("schedule");
+    if (schedule_cfg != NULL)
+    {
+        for (auto &item : schedule_cfg->get_elems())
+        {
+            this->schedule.push_back(ScheduleEntry{
+                item->get_int("cycle"), item->get_child_str("port"), (int)item->get_int("value")});
+        }
+    }
+}
+
+
+void StubGateDriver::reset(bool active)
+{
+    if (!active && this->next_to_schedule == 0)
+    {
+        if (this->schedule.empty())
+        {
+            this->quit_event.enqueue(this->quit_after_cycles);
+        }
+        else
+        {
+            int64_t first = this->schedule[0].cycle;
+            this->issue_event.enqueue(first > 0 ? first : 1);
+        }
+    }
+}
+
+
+void StubGateDriver::issue(ScheduleEntry &entry)
+{
+    int64_t now = this->clock.get_cycles();
+    printf("[%ld] %s SET port=%s value=%d\n", now, this->logname.c_str(),
+        entry.port.c_str(), entry.value);
+    fflush(stdout);
+
+    if (entry.port == "div_en")
+    {
+        this->div_en_itf.sync(entry.value != 0);
+    }
+    else if (entry.port == "mux_en_0" || entry.port == "mux_en_1")
+    {
+        this->mux_en_itf[entry.port.back() - '0'].sync(entry.value != 0);
+    }
+    else if (entry.port == "div_ctrl")
+    {
+        this->div_ctrl_itf.sync(entry.value);
+    }
+    else if (entry.port == "mux_sel")
+    {
+        this->mux_sel_itf.sync(entry.value);
+    }
+    else if (entry.port == "core_en")
+    {
+        this->core_en_itf.sync(entry.value != 0);
+    }
+    else if (entry.port == "core_reset")
+    {
+        this->core_reset_itf.sync(entry.value != 0);
+    }
+    else
+    {
+        this->trace.fatal("Unknown port %s\n", entry.port.c_str());
+    }
+}
+
+
+void StubGateDriver::issue_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    StubGateDriver *_this = (StubGateDriver *)__this;
+    int64_t now = _this->clock.get_cycles();
+
+    // Every entry of the current cycle, in schedule order
+    while (_this->next_to_schedule < _this->schedule.size()
+        && _this->schedule[_this->next_to_schedule].cycle <= now)
+    {
+        _this->issue(_this->schedule[_this->next_to_schedule++]);
+    }
+
+    if (_this->next_to_schedule < _this->schedule.size())
+    {
+        _this->issue_event.enqueue(_this->schedule[_this->next_to_schedule].cycle - now);
+    }
+    else
+    {
+        _this->quit_event.enqueue(_this->quit_after_cycles);
+    }
+}
+
+
+void StubGateDriver::quit_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    StubGateDriver *_this = (StubGateDriver *)__this;
+    int64_t now = _this->clock.get_cycles();
+    printf("[%ld] %s QUIT\n", now, _this->logname.c_str());
+    fflush(stdout);
+    _this->time.get_engine()->quit(0);
+}
+
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new StubGateDriver(config);
+}
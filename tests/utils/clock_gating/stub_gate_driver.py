@@ -0,0 +1,41 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+import gvsoc.systree
+
+
+class StubGateDriver(gvsoc.systree.Component):
+    """Testbench driver of the clock models gating and control wires.
+
+    Replays a schedule of dicts with keys: cycle, port, value. ``port`` is
+    one of div_en, mux_en_0, mux_en_1, core_en (gating, 0 when gated),
+    div_ctrl (divider value), mux_sel (selected clock) or core_reset (reset
+    of the core bound to core_en, 1 when asserted).
+    """
+    def __init__(self, parent: gvsoc.systree.Component, name: str,
+                 schedule: list | None = None, logname: str | None = None):
+        super().__init__(parent, name)
+        self.add_sources(['stub_gate_driver.cpp'])
+        self.add_property('logname', logname or name)
+        self.add_property('schedule', schedule or [])
+
+    def o_DIV_EN(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('div_en', itf, signature='wire<bool>')
+
+    def o_MUX_EN(self, id: int, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind(f'mux_en_{id}', itf, signature='wire<bool>')
+
+    def o_DIV_CTRL(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('div_ctrl', itf, signature='wire<int>')
+
+    def o_MUX_SEL(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('mux_sel', itf, signature='wire<int>')
+
+    def o_CORE_EN(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('core_en', itf, signature='wire<bool>')
+
+    def o_CORE_RESET(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('core_reset', itf, signature='wire<bool>')
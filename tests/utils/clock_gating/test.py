@@ -0,0 +1,125 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+"""Clock gating notification testbench.
+
+A stub driver replays a schedule on the clock_en_in and control wires of a
+clock_divider and of a 2-input clock_mux, and one stub sink per model logs
+the clock_en_out notifications. In the ``iss`` case, the driver also gates
+the clock_en input of an iss_v2 core and resets it, and the core reports
+its retain count and ``events_avoided`` stat on its debug trace. Each test
+case is selected via the ``case`` TargetParameter, which picks the driver
+schedule.
+"""
+
+from __future__ import annotations
+
+import gvsoc.systree
+import gvsoc.runner
+import vp.clock_domain
+from utils.clock_divider import ClockDivider, ClockDividerConfig
+from utils.clock_mux import ClockMux, ClockMuxConfig
+from cpu.iss_v2.riscv import RiscvCommon
+from cpu.iss_v2.riscv_config import RiscvConfig
+from cpu.iss.isa_gen.isa_riscv_gen import RiscvIsa
+from gvrun.parameter import TargetParameter
+
+from stub_gate_driver import StubGateDriver
+from stub_clock_en_sink import StubClockEnSink
+
+
+def build_case(case_name: str) -> list:
+    if case_name == 'divider':
+        # Input gated then ungated, then a divider of 0 which keeps the
+        # output gated across an input gating window until a new divider
+        # is set and the input is ungated.
+        return [
+            dict(cycle=10, port='div_en',   value=0),
+            dict(cycle=20, port='div_en',   value=1),
+            dict(cycle=30, port='div_ctrl', value=0),
+            dict(cycle=35, port='div_en',   value=0),
+            dict(cycle=40, port='div_ctrl', value=2),
+            dict(cycle=50, port='div_en',   value=1),
+        ]
+
+    if case_name == 'mux':
+        # Gating the unselected input is not propagated, selecting it is.
+        # Then the selected input is gated and ungated, and an out of
+        # range selection gates the output until the end.
+        return [
+            dict(cycle=10, port='mux_en_1', value=0),
+            dict(cycle=15, port='mux_sel',  value=1),
+            dict(cycle=25, port='mux_sel',  value=0),
+            dict(cycle=30, port='mux_en_0', value=0),
+            dict(cycle=45, port='mux_en_0', value=1),
+            dict(cycle=55, port='mux_sel',  value=5),
+        ]
+
+    if case_name == 'iss':
+        # The core clock is gated and ungated, then gated again across a
+        # core reset, and finally ungated. Fetch is never enabled, so the
+        # core must stay retained by its reset until the end.
+        return [
+            dict(cycle=10, port='core_en',    value=0),
+            dict(cycle=20, port='core_en',    value=1),
+            dict(cycle=30, port='core_en',    value=0),
+            dict(cycle=40, port='core_reset', value=1),
+            dict(cycle=45, port='core_reset', value=0),
+            dict(cycle=50, port='core_en',    value=1),
+        ]
+
+    raise ValueError(f'Unknown case: {case_name}')
+
+
+class Chip(gvsoc.systree.Component):
+    def __init__(self, parent, name=None):
+        super().__init__(parent, name)
+        case = TargetParameter(
+            self, name='case', value='divider',
+            description='Which clock gating test case to run', cast=str,
+        ).get_value()
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100_000_000)
+
+        driver = StubGateDriver(self, 'driver', schedule=build_case(case), logname='driver')
+        clock.o_CLOCK(driver.i_CLOCK())
+
+        divider = ClockDivider(self, 'divider', ClockDividerConfig(divider=1))
+        clock.o_CLOCK(divider.i_CLOCK())
+        driver.o_DIV_EN(divider.i_CLOCK_EN_IN())
+        driver.o_DIV_CTRL(divider.i_CLOCK_CTRL())
+
+        mux = ClockMux(self, 'mux', ClockMuxConfig(nb_clocks=2, selected_clock=0))
+        clock.o_CLOCK(mux.i_CLOCK())
+        driver.o_MUX_EN(0, mux.i_CLOCK_EN_IN(0))
+        driver.o_MUX_EN(1, mux.i_CLOCK_EN_IN(1))
+        driver.o_MUX_SEL(mux.i_CLOCK_CTRL())
+
+        div_sink = StubClockEnSink(self, 'div_sink', logname='div_sink')
+        clock.o_CLOCK(div_sink.i_CLOCK())
+        divider.o_CLOCK_EN_OUT(div_sink.i_CLOCK_EN())
+
+        mux_sink = StubClockEnSink(self, 'mux_sink', logname='mux_sink')
+        clock.o_CLOCK(mux_sink.i_CLOCK())
+        mux.o_CLOCK_EN_OUT(mux_sink.i_CLOCK_EN())
+
+        if case == 'iss':
+            # No binary and fetch disabled: the core never executes, only
+            # its retain and gating accounting are exercised.
+            isa = RiscvIsa('clock_gating', 'rv32imc')
+            core = RiscvCommon(self, 'core', config=RiscvConfig(isa='rv32imc', htif=False),
+                               isa=isa)
+            core.add_c_flags(['-DCONFIG_ISS_CORE=riscv'])
+            clock.o_CLOCK(core.i_CLOCK())
+            driver.o_CORE_EN(core.i_CLOCK_EN())
+            driver.o_CORE_RESET(gvsoc.systree.SlaveItf(core, itf_name='reset',
+                                                       signature='wire<bool>'))
+
+
+class Target(gvsoc.runner.Target):
+    gapy_description = 'Clock gating notification testbench'
+    model = Chip
+    name = 'test'
@@ -0,0 +1,67 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+"""utils.fst_dumper testbench.
+
+Replays an FST file with the FST player alone. Each test case is selected
+via the ``case`` TargetParameter, which picks the file to replay. The
+player reports every window it replays and every signal change, with the
+time it applies at, for the checkers.
+"""
+
+from __future__ import annotations
+
+import os
+
+import gvsoc.systree
+import gvsoc.runner
+from gvrun.parameter import TargetParameter
+
+
+TEST_DIR = os.path.dirname(os.path.abspath(__file__))
+
+
+def build_case(case_name: str) -> dict:
+    if case_name == 'fixture':
+        # 1 ns timescale, scope top: clk (1 bit), a real variable, data
+        # (8 bits) and an alias of it, wide (100 bits, replayed as two 64-bit
+        # chunks) and bus (32 bits, split in bytes). Written in 5 value
+        # change sections, so that the player loads it in 3 windows, with
+        # changes on both sides of each window boundary. Some values hold
+        # x/z or 9-state characters. The values are generated by the
+        # formulas of the checker.
+        return dict(fst_file=os.path.join(TEST_DIR, 'fixture.fst'),
+                    element_size={'top/bus': 8})
+
+    raise ValueError(f'Unknown case: {case_name}')
+
+
+class FstPlayer(gvsoc.systree.Component):
+    def __init__(self, parent, name, fst_file, element_size=None):
+        super().__init__(parent, name)
+        self.set_component('utils.fst_dumper')
+        self.add_properties({'fst_file': fst_file})
+        if element_size:
+            self.add_properties({'element_size': element_size})
+
+
+class Chip(gvsoc.systree.Component):
+    def __init__(self, parent, name=None):
+        super().__init__(parent, name)
+        case = TargetParameter(
+            self, name='case', value='fixture',
+            description='Which utils.fst_dumper test case to run', cast=str,
+        ).get_value()
+
+        spec = build_case(case)
+
+        FstPlayer(self, 'fst', **spec)
+
+
+class Target(gvsoc.runner.Target):
+    gapy_description = 'utils.fst_dumper testbench'
+    model = Chip
+    name = 'test'
@@ -108,6 +108,9 @@ private:
 
     Slot slots[MAX_BURST];
     int  in_flight_count = 0;
+    // Accesses completed inline (IO_REQ_DONE). A parametric bridge only does
+    // so when it computes the crossing analytically.
+    uint64_t nb_sync_done = 0;
 };
 
 
@@ -255,6 +258,7 @@ bool CDCTester::issue_into_slot(int slot_idx, uint64_t index, bool is_write)
         }
         s.active = false;
         this->in_flight_count--;
+        this->nb_sync_done++;
         return true;
     }
     if (st == vp::IO_REQ_DENIED)
@@ -446,10 +450,10 @@ void CDCTester::fail(const char *fmt, ...)
 void CDCTester::pass()
 {
     int64_t now = this->clock.get_cycles();
-    printf("[%ld] %s PASS writes=%lu reads=%lu cycles=%ld\n",
+    printf("[%ld] %s PASS writes=%lu reads=%lu cycles=%ld sync=%lu\n",
         now, this->logname.c_str(),
         this->nb_accesses, this->nb_accesses,
-        (long)(now - this->start_cycle));
+        (long)(now - this->start_cycle), this->nb_sync_done);
     this->finish_local();
 }
 
@@ -99,6 +99,12 @@ class Chip(gvsoc.systree.Component):
             description='Override the bridge kind\'s default FIFO depth (0=keep default)',
             cast=int,
         ).get_value()
+        bridge_analytic = TargetParameter(
+            self, name='bridge_analytic', value=0,
+            description='Compute the crossing analytically instead of with stage '
+                        'events (parametric *_beh kinds only)',
+            cast=int,
+        ).get_value()
 
         spec = build_case(case)
 
@@ -111,6 +117,8 @@ class Chip(gvsoc.systree.Component):
         # factory rejects unknown opts for the depth-less kinds (sync_only,
         # *_rtl) so we keep the default path opt-free.
         bridge_opts = {'depth': bridge_depth} if bridge_depth > 0 else {}
+        if bridge_analytic:
+            bridge_opts['analytic'] = True
         self.set_clock_bridge_policy(src_clock=clk_a, dst_clock=clk_b,
                                      kind=bridge, opts=bridge_opts)
         self.set_clock_bridge_policy(src_clock=clk_b, dst_clock=clk_a,
@@ -10,8 +10,11 @@
 // addr_min, addr_max, behavior, resp_delay, retry_delay), accumulates
 // the incoming writes into an internal byte store, and logs each
 // REQ/RESP/RETRY so the checker can verify address+data coverage.
+// Optionally exposes a debug-memory backdoor over a list of address
+// ranges, logging each BACKDOOR access.
 
 #include <vp/vp.hpp>
+#include <vp/debug_mem.hpp>
 #include <vp/itf/io_v2.hpp>
 #include <cstdio>
 #include <cstring>
@@ -20,11 +23,18 @@
 #include <unordered_map>
 #include <vector>
 
-class StubTarget : public vp::Component
+class StubTarget : public vp::Component, public vp::DebugMemIf
 {
 public:
     StubTarget(vp::ComponentConf &conf);
 
+    vp::DebugMemIf *debug_mem_if() override
+    {
+        return this->backdoor_ranges.empty() ? nullptr : this;
+    }
+    int debug_mem_access(uint64_t addr, uint8_t *data, uint64_t size,
+        bool is_write) override;
+
 private:
     enum class Behavior { DONE, DONE_INVALID, GRANTED, DENIED };
 
@@ -48,6 +58,8 @@ private:
     vp::ClockEvent  retry_event;
     vp::Trace       trace;
     std::vector<Rule> rules;
+    // Address ranges (min, max) reachable through the backdoor
+    std::vector<std::pair<uint64_t, uint64_t>> backdoor_ranges;
     std::string     logname;
 
     struct Pending { vp::IoReq *req; int64_t due_cycle; };
@@ -89,6 +101,42 @@ StubTarget::StubTarget(vp::ComponentConf &config)
             this->rules.push_back(r);
         }
     }
+
+    js::Config *backdoor_cfg = this->get_js_config()->get("backdoor");
+    if (backdoor_cfg != NULL)
+    {
+        for (auto &item : backdoor_cfg->get_elems())
+        {
+            this->backdoor_ranges.emplace_back(
+                (uint64_t)item->get_int("addr_min"), (uint64_t)item->get_int("addr_max"));
+        }
+    }
+}
+
+
+int StubTarget::debug_mem_access(uint64_t addr, uint8_t *data, uint64_t size,
+    bool is_write)
+{
+    for (auto &range : this->backdoor_ranges)
+    {
+        if (addr >= range.first && addr + size - 1 <= range.second)
+        {
+            char hex[8 * 2 + 1] = { 0 };
+            for (uint64_t i = 0; i < size && i < 8; i++)
+            {
+                snprintf(hex + i * 2, 3, "%02x", data[i]);
+            }
+            printf("[%ld] %s BACKDOOR addr=0x%lx size=%lu write=%d data=%s\n",
+                this->clock.get_cycles(), this->logname.c_str(), addr, size,
+                is_write ? 1 : 0, hex);
+            if (is_write)
+            {
+                this->store_bytes(addr, data, size);
+            }
+            return 0;
+        }
+    }
+    return -1;
 }
 
 
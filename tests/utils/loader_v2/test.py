@@ -205,6 +205,22 @@ def build_case(case_name: str, work_dir: str) -> dict:
             'rules':  rules,
         }
 
+    if case_name == 'pipelined':
+        # 256 KiB segment, i.e. 4 chunks of 64 KiB, with an asynchronous
+        # memory and a window of 4 chunks. All of them must be issued
+        # before the first response comes back.
+        data = bytes(i & 0xFF for i in range(0x40000))
+        path = _ensure_elf(work_dir, 'pipelined', 0x10000, [
+            {'paddr': 0x10000, 'data': data, 'memsz': len(data)},
+        ])
+        rules = [dict(addr_min=0, addr_max=0xFFFF_FFFF, behavior='granted',
+                      resp_delay=10, retry_delay=0)]
+        return {
+            'binary': path,
+            'max_pending_chunks': 4,
+            'rules':  rules,
+        }
+
     if case_name == 'invalid_resp':
         # Memory returns IO_RESP_INVALID on one chunk. v2 must log the
         # warning and *continue* past the error (v1 hung). Split the
@@ -223,6 +239,34 @@ def build_case(case_name: str, work_dir: str) -> dict:
             'rules':  rules,
         }
 
+    if case_name == 'backdoor':
+        # Data + bss segment and an entry_addr write, all reachable
+        # through the target backdoor. Nothing must go through the port.
+        path = _ensure_elf(work_dir, 'backdoor', 0x1000, [
+            {'paddr': 0x1000, 'data': bytes(range(16)), 'memsz': 32},
+        ])
+        return {
+            'binary': path,
+            'entry_addr': 0x0,
+            'backdoor': True,
+            'rules':  mem_ok,
+            'backdoor_ranges': [dict(addr_min=0, addr_max=0xFFFF)],
+        }
+
+    if case_name == 'backdoor_fallback':
+        # The backdoor only covers the first segment, the second one
+        # (e.g. behind a flash controller) must go through the port.
+        path = _ensure_elf(work_dir, 'backdoor_fallback', 0x2000, [
+            {'paddr': 0x2000, 'data': b'\x01\x02\x03\x04', 'memsz': 4},
+            {'paddr': 0x3000, 'data': b'\x05\x06\x07\x08', 'memsz': 4},
+        ])
+        return {
+            'binary': path,
+            'backdoor': True,
+            'rules':  mem_ok,
+            'backdoor_ranges': [dict(addr_min=0x2000, addr_max=0x2FFF)],
+        }
+
     if case_name == 'missing_binary':
         # Non-existent binary path. The loader must log a warning and
         # not crash; no writes reach mem and no wire sync fires.
@@ -253,13 +297,15 @@ class Chip(gvsoc.systree.Component):
         clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=100_000_000)
 
         loader_kwargs = dict(binary=spec['binary'])
-        for k in ('entry', 'entry_addr', 'fetchen_addr', 'fetchen_value'):
+        for k in ('entry', 'entry_addr', 'fetchen_addr', 'fetchen_value', 'backdoor',
+                  'max_pending_chunks'):
             if k in spec:
                 loader_kwargs[k] = spec[k]
         loader = ElfLoader(self, 'loader', **loader_kwargs)
         clock.o_CLOCK(loader.i_CLOCK())
 
-        mem = StubTarget(self, 'mem', rules=spec['rules'], logname='mem')
+        mem = StubTarget(self, 'mem', rules=spec['rules'], logname='mem',
+                         backdoor=spec.get('backdoor_ranges'))
         clock.o_CLOCK(mem.i_CLOCK())
         loader.o_OUT(mem.i_INPUT())
 
@@ -0,0 +1,60 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+"""utils.vcd_dumper testbench.
+
+Replays a VCD file with the VCD player alone. Each test case is selected
+via the ``case`` TargetParameter, which picks the file to replay. The
+player reports every signal change on its debug trace, with the time it
+applies at, for the checkers.
+"""
+
+from __future__ import annotations
+
+import os
+
+import gvsoc.systree
+import gvsoc.runner
+from gvrun.parameter import TargetParameter
+
+
+TEST_DIR = os.path.dirname(os.path.abspath(__file__))
+
+
+def build_case(case_name: str) -> dict:
+    if case_name == 'fixture':
+        # Scalar, vector, bit-selects of one parent, two variables sharing
+        # an identifier code, a code too long for the direct table, x/z
+        # values and values shorter than their variable.
+        return dict(vcd_file=os.path.join(TEST_DIR, 'fixture.vcd'))
+
+    raise ValueError(f'Unknown case: {case_name}')
+
+
+class VcdPlayer(gvsoc.systree.Component):
+    def __init__(self, parent, name, vcd_file):
+        super().__init__(parent, name)
+        self.add_sources(['utils/vcd_dumper.cpp'])
+        self.add_properties({'vcd_file': vcd_file})
+
+
+class Chip(gvsoc.systree.Component):
+    def __init__(self, parent, name=None):
+        super().__init__(parent, name)
+        case = TargetParameter(
+            self, name='case', value='fixture',
+            description='Which utils.vcd_dumper test case to run', cast=str,
+        ).get_value()
+
+        spec = build_case(case)
+
+        VcdPlayer(self, 'vcd', vcd_file=spec['vcd_file'])
+
+
+class Target(gvsoc.runner.Target):
+    gapy_description = 'utils.vcd_dumper testbench'
+    model = Chip
+    name = 'test'
@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Authors: Germain Haugou (germain.haugou@gmail.com)
+//
+// Stub verilator plugin emulating a free-running counter design, so that
+// ``utils.verilator`` and both plugin ABIs can be exercised and benchmarked
+// without Verilator installed. Each cycle raises ``counter/clk``, increments
+// ``counter/count`` and lowers ``counter/clk`` half a period later, i.e.
+// three signal changes per cycle once host callbacks are set.
+//
+// Plusargs:
+//   +maxcycles=N  exit with code 0 after N cycles (default 1000)
+//   +period=N     clock period in ps (default 10000)
+//
+// The batched entry point is left out when built with -DSTUB_NO_BATCH, to
+// check the host fallback on the per-step ABI. The number of host crossings
+// and reported changes is printed on close for the testset checkers.
+
+#include "verilator_plugin.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+
+struct VlPlugin
+{
+    int64_t time_ps = 0;
+    int64_t period_ps = 10000;
+    uint64_t max_cycles = 1000;
+    uint64_t cycles = 0;
+    uint64_t count = 0;
+
+    VlHostCb host_cb{};
+    VlSignal clk_sig = nullptr;
+    VlSignal count_sig = nullptr;
+
+    // Changes produced by the batched entry point but not returned yet,
+    // because the host buffer was full.
+    std::deque<VlSignalChange> pending;
+
+    uint64_t nb_steps = 0;
+    uint64_t nb_batches = 0;
+    uint64_t nb_pushes = 0;
+    uint64_t nb_returned = 0;
+};
+
+
+static VlPlugin *vl_open(int argc, const char *const *argv)
+{
+    VlPlugin *p = new VlPlugin;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "+maxcycles=", 11) == 0)
+        {
+            p->max_cycles = strtoull(argv[i] + 11, nullptr, 0);
+        }
+        else if (strncmp(argv[i], "+period=", 8) == 0)
+        {
+            p->period_ps = strtoll(argv[i] + 8, nullptr, 0);
+        }
+    }
+    if (p->period_ps < 2)
+    {
+        fprintf(stderr, "[STUB] invalid period %" PRId64 "\n", p->period_ps);
+        delete p;
+        return nullptr;
+    }
+    return p;
+}
+
+static void vl_set_host_callbacks(VlPlugin *p, const VlHostCb *cb)
+{
+    p->host_cb = *cb;
+    p->clk_sig = cb->reg_logical(cb->ctx, "counter/clk", 1, "in|logic");
+    p->count_sig = cb->reg_logical(cb->ctx, "counter/count", 32, "out|logic");
+}
+
+// Simulate one cycle starting at the current time and hand its changes to
+// `report`.
+template<typename F>
+static void run_cycle(VlPlugin *p, F report)
+{
+    p->count = (p->count + 1) & 0xFFFFFFFF;
+    if (p->clk_sig != nullptr)
+    {
+        report(VlSignalChange{p->clk_sig, 1, p->time_ps});
+        report(VlSignalChange{p->count_sig, p->count, p->time_ps});
+        report(VlSignalChange{p->clk_sig, 0, p->time_ps + p->period_ps / 2});
+    }
+    p->time_ps += p->period_ps;
+    p->cycles++;
+}
+
+static VlStepResult vl_step(VlPlugin *p)
+{
+    p->nb_steps++;
+    run_cycle(p, [p](const VlSignalChange &c) {
+        p->host_cb.push_logical(p->host_cb.ctx, c.sig, c.value, c.time_ps);
+        p->nb_pushes++;
+    });
+    if (p->cycles >= p->max_cycles)
+    {
+        return VlStepResult{0, 0};
+    }
+    return VlStepResult{-1, p->period_ps};
+}
+
+static void vl_close(VlPlugin *p)
+{
+    printf("[STUB] cycles=%" PRIu64 " count=%" PRIu64 " steps=%" PRIu64
+        " batches=%" PRIu64 " pushes=%" PRIu64 " returned=%" PRIu64 "\n",
+        p->cycles, p->count, p->nb_steps, p->nb_batches, p->nb_pushes,
+        p->nb_returned);
+    fflush(stdout);
+    delete p;
+}
+
+static const VlPluginVtable stub_vtable = {
+    vl_open, vl_step, vl_close, vl_set_host_callbacks, nullptr,
+};
+
+extern "C" const VlPluginVtable *gv_verilator_plugin_get(void)
+{
+    return &stub_vtable;
+}
+
+#ifndef STUB_NO_BATCH
+
+static VlBatchResult vl_step_batch(VlPlugin *p, int64_t horizon_ps,
+    VlSignalChange *changes, uint32_t max_changes)
+{
+    VlBatchResult res = {-1, 0, 0};
+    int64_t start = p->time_ps;
+    p->nb_batches++;
+
+    while (true)
+    {
+        while (!p->pending.empty() && res.nb_changes < max_changes)
+        {
+            changes[res.nb_changes++] = p->pending.front();
+            p->pending.pop_front();
+        }
+        if (!p->pending.empty() || p->cycles >= p->max_cycles
+            || p->time_ps - start >= horizon_ps)
+        {
+            break;
+        }
+        run_cycle(p, [p](const VlSignalChange &c) { p->pending.push_back(c); });
+    }
+
+    p->nb_returned += res.nb_changes;
+    res.time_to_next = p->time_ps - start;
+    // Only exit once every change has been returned.
+    if (p->cycles >= p->max_cycles && p->pending.empty())
+    {
+        res.exit_code = 0;
+    }
+    return res;
+}
+
+static const VlPluginBatchVtable stub_batch_vtable = {
+    vl_step_batch,
+};
+
+extern "C" const VlPluginBatchVtable *gv_verilator_plugin_batch_get(void)
+{
+    return &stub_batch_vtable;
+}
+
+#endif
@@ -0,0 +1,92 @@
+# SPDX-FileCopyrightText: 2026 ETH Zurich, University of Bologna and EssilorLuxottica SAS
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Authors: Germain Haugou (germain.haugou@gmail.com)
+
+"""utils.verilator testbench.
+
+Drives the stub counter plugin (``stub_counter_plugin.cpp``, built by the
+Makefile without Verilator) from a single ``VerilatorControl``, either
+through the per-step ABI or through the batched one. The plugin prints the
+number of host crossings and signal changes on close for the checkers.
+"""
+
+from __future__ import annotations
+
+import os
+
+import gvsoc.systree
+import gvsoc.runner
+from utils.verilator import VerilatorControl
+from gvrun.parameter import TargetParameter
+
+
+STUB_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'build', 'stub')
+
+# Clock period of the stub design, in ps.
+PERIOD = 10_000
+
+
+def build_case(case_name: str) -> dict:
+    if case_name == 'step':
+        # Per-step ABI: one host event and three push_logical per cycle.
+        return dict(plugin='stub_counter.so', inject_signals=True)
+
+    if case_name == 'batch':
+        # 100 cycles per host event, changes returned in the packed array.
+        return dict(plugin='stub_counter.so', inject_signals=True,
+                    batch_horizon=100 * PERIOD)
+
+    if case_name == 'batch_timestamps':
+        # Same as batch, with the host tracing the time each change is
+        # stamped at (see the Makefile).
+        return dict(plugin='stub_counter.so', inject_signals=True,
+                    batch_horizon=100 * PERIOD)
+
+    if case_name == 'batch_overflow':
+        # Horizon longer than the run, with more changes than the 4096
+        # entries of the host buffer (run with MAXCYCLES=3000): the plugin
+        # returns full batches and keeps the rest for the next call.
+        return dict(plugin='stub_counter.so', inject_signals=True,
+                    batch_horizon=4000 * PERIOD)
+
+    if case_name == 'batch_no_signals':
+        # Without host callbacks, the plugin has no signal to report and
+        # only the number of crossings changes.
+        return dict(plugin='stub_counter.so', batch_horizon=100 * PERIOD)
+
+    if case_name == 'fallback':
+        # Plugin without the batched entry point: the host must warn and
+        # keep using the per-step ABI.
+        return dict(plugin='stub_counter_nobatch.so', inject_signals=True,
+                    batch_horizon=100 * PERIOD)
+
+    raise ValueError(f'Unknown case: {case_name}')
+
+
+class Chip(gvsoc.systree.Component):
+    def __init__(self, parent, name=None):
+        super().__init__(parent, name)
+        case = TargetParameter(
+            self, name='case', value='step',
+            description='Which utils.verilator test case to run', cast=str,
+        ).get_value()
+        maxcycles = TargetParameter(
+            self, name='maxcycles', value=1000,
+            description='Number of cycles simulated by the stub design', cast=int,
+        ).get_value()
+
+        spec = build_case(case)
+
+        VerilatorControl(self, 'verilator',
+            plugin_path=os.path.join(STUB_DIR, spec['plugin']),
+            inject_signals=spec.get('inject_signals', False),
+            batch_horizon=spec.get('batch_horizon', 0),
+            plusargs=[f'+maxcycles={maxcycles}', f'+period={PERIOD}'])
+
+
+class Target(gvsoc.runner.Target):
+    gapy_description = 'utils.verilator testbench'
+    model = Chip
+    name = 'test'